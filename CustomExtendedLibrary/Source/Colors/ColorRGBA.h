@@ -6,9 +6,12 @@
  *
  *  Current capabilities:
  *  -   All the operator functions including bool check which is defined as ==.
- *  -   Initialization without defining the elements. (Returns Non-Transparent Black)
+ *  -   Initialization without defining the elements. (Returns Transparent Black, every channel is zero)
  *  -   Length, Normalize, Distance, DotProduct, CrossProduct.
+ *  -   LengthSquared, DistanceSquared and a Precision policy for Length, Normalize, Distance. (Exact or Fast)
  *  -   Num. (Returns the count of element which is 4 for RGBA)
+ *  -   SSE path for ColorRGBA<float> when Math/SIMD.h detects it, scalar fallback otherwise.
+ *  -   constexpr constructors, operators, LengthSquared, DistanceSquared and DotProduct. (Compile time tables)
  *
  *  W.I.P Features:
  *  -   RGBA
@@ -20,6 +23,9 @@
 
 #include "Core/CoreAPI.h"
 #include "Core/Types.h"
+#include "Math/Math.h"
+
+#include <type_traits>
 
 namespace Engine
 {
@@ -28,66 +34,75 @@ namespace Engine
     {
     public:
         //	If it is not initialized, it is zero vector.
-        ColorRGBA();
+        constexpr ColorRGBA();
 
         //	Initialization constructor.
-        ColorRGBA(TValue RedValue, TValue GreenValue, TValue BlueValue, TValue AlphaValue);
+        constexpr ColorRGBA(TValue RedValue, TValue GreenValue, TValue BlueValue, TValue AlphaValue);
 
         TValue Red, Green, Blue, Alpha;
         
-        //	Gives the distance from origin.
-        FORCEINLINE float Length();
+        //	Gives the distance from origin. Precision::Fast trades a few ULPs for speed on float.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE float Length() const;
+
+        //	Gives the squared distance from origin. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE constexpr float LengthSquared() const;
 
         //	Rates the current vector's each element in between 0 and 1.
-        FORCEINLINE ColorRGBA<float> Normalize();
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE ColorRGBA<float> Normalize() const;
 
         //	Gives the distance of 2 vector points.
-        FORCEINLINE static TValue Distance(ColorRGBA& Vec1, ColorRGBA& Vec2);
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static TValue Distance(const ColorRGBA& Vec1, const ColorRGBA& Vec2);
+
+        //	Gives the squared distance of 2 vector points. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE static constexpr float DistanceSquared(const ColorRGBA& Vec1, const ColorRGBA& Vec2);
 
         //	Scalar multiplication method called Dot Product. Returns TValue.
-        FORCEINLINE static TValue DotProduct(ColorRGBA& Vec1, ColorRGBA& Vec2);
+        FORCEINLINE static constexpr TValue DotProduct(const ColorRGBA& Vec1, const ColorRGBA& Vec2);
 
         //	Gives the size of the ColorRGBA which is always equals 4.
         FORCEINLINE static constexpr byte Num();
 
         //	ColorRGBA + ColorRGBA. Each element sums with the other vector's related element.
-        FORCEINLINE ColorRGBA operator+(ColorRGBA& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator+(const ColorRGBA& Other) const;
 
         //	ColorRGBA + TValue. Add each element the TValue parameter.
-        FORCEINLINE ColorRGBA operator+(TValue& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator+(TValue Other) const;
 
         //	ColorRGBA - ColorRGBA. Each element subtracts with the other vector's related element.
-        FORCEINLINE ColorRGBA operator-(ColorRGBA& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator-(const ColorRGBA& Other) const;
 
         //	ColorRGBA - TValue. Subtract the TValue parameter from each element.
-        FORCEINLINE ColorRGBA operator-(TValue& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator-(TValue Other) const;
 
         //	ColorRGBA * TValue. Multiplies each element with the TValue parameter.
-        FORCEINLINE ColorRGBA operator*(TValue& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator*(TValue Other) const;
 
         //	ColorRGBA * TValue. Divides each element with the TValue parameter.
-        FORCEINLINE ColorRGBA operator/(TValue& Other) const;
+        FORCEINLINE constexpr ColorRGBA operator/(TValue Other) const;
 
         //	ColorRGBA + ColorRGBA. Each element sums with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator+=(ColorRGBA Other);
+        FORCEINLINE constexpr ColorRGBA& operator+=(ColorRGBA Other);
 
         //	ColorRGBA + TValue. Each element sums with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator+=(TValue Other);
+        FORCEINLINE constexpr ColorRGBA& operator+=(TValue Other);
 
         //	ColorRGBA - ColorRGBA. Each element sums with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator-=(ColorRGBA Other);
+        FORCEINLINE constexpr ColorRGBA& operator-=(ColorRGBA Other);
 
         //	ColorRGBA - TValue. Each element subtract with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator-=(TValue Other);
+        FORCEINLINE constexpr ColorRGBA& operator-=(TValue Other);
 
         //	ColorRGBA * TValue. Each element multiplies with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator*=(TValue Other);
+        FORCEINLINE constexpr ColorRGBA& operator*=(TValue Other);
 
         //	ColorRGBA / TValue. Each element multiplies with the other vector's related element and overwrites on related ColorRGBA.
-        FORCEINLINE ColorRGBA operator/=(TValue Other);
+        FORCEINLINE constexpr ColorRGBA& operator/=(TValue Other);
 
         //	Boolean that checks if both 4 dimensional Vectors are equal.
-        FORCEINLINE bool operator==(ColorRGBA Other);
+        FORCEINLINE constexpr bool operator==(const ColorRGBA& Other) const;
     };
 
     template <typename TValue>
@@ -97,143 +112,402 @@ namespace Engine
     }
 
     template <typename TValue>
-    ColorRGBA<TValue>::ColorRGBA()
+    constexpr ColorRGBA<TValue>::ColorRGBA() : Red(0), Green(0), Blue(0), Alpha(0)
     {
-        Red = Green = Blue = 0;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue>::ColorRGBA(TValue RedValue, TValue GreenValue, TValue BlueValue, TValue AlphaValue)
+    constexpr ColorRGBA<TValue>::ColorRGBA(TValue RedValue, TValue GreenValue, TValue BlueValue, TValue AlphaValue) : Red(RedValue), Green(GreenValue), Blue(BlueValue), Alpha(AlphaValue)
     {
-        Red = RedValue;
-        Green = GreenValue;
-        Blue = BlueValue;
-        Alpha = AlphaValue;
     }
 
     template <typename TValue>
-    float ColorRGBA<TValue>::Length()
+    template <Precision TPrecision>
+    float ColorRGBA<TValue>::Length() const
     {
-        return sqrt(pow(Red, 2) + pow(Green, 2) + pow(Blue, 2) + pow(Alpha, 2));
+        return Math::Sqrt<TPrecision>(LengthSquared());
     }
 
     template <typename TValue>
-    ColorRGBA<float> ColorRGBA<TValue>::Normalize()
+    constexpr float ColorRGBA<TValue>::LengthSquared() const
     {
-        return ColorRGBA(Red / Length(), Green / Length(), Blue / Length(), Alpha / Length());
+        return static_cast<float>(Red) * Red + static_cast<float>(Green) * Green + static_cast<float>(Blue) * Blue + static_cast<float>(Alpha) * Alpha;
     }
 
+    //	One square root for the whole vector instead of one per element.
     template <typename TValue>
-    TValue ColorRGBA<TValue>::Distance(ColorRGBA& Vec1, ColorRGBA& Vec2)
+    template <Precision TPrecision>
+    ColorRGBA<float> ColorRGBA<TValue>::Normalize() const
     {
-        return sqrt(pow((Vec2.Red - Vec1.Red), 2) + pow((Vec2.Green - Vec1.Green), 2) + pow((Vec2.Blue - Vec1.Blue), 2) + pow((Vec2.Alpha - Vec1.Alpha), 2));
+        if constexpr (TPrecision == Precision::Fast)
+        {
+            const float inverseLength = Math::InverseSqrt<TPrecision>(LengthSquared());
+            return ColorRGBA<float>(Red * inverseLength, Green * inverseLength, Blue * inverseLength, Alpha * inverseLength);
+        }
+        else
+        {
+            const float length = Length();
+            return ColorRGBA<float>(Red / length, Green / length, Blue / length, Alpha / length);
+        }
     }
 
     template <typename TValue>
-    TValue ColorRGBA<TValue>::DotProduct(ColorRGBA& Vec1, ColorRGBA& Vec2)
+    template <Precision TPrecision>
+    TValue ColorRGBA<TValue>::Distance(const ColorRGBA& Vec1, const ColorRGBA& Vec2)
     {
-        return Vec1.Red * Vec2.Red + Vec1.Green * Vec2.Green + Vec1.Blue * Vec2.Blue;
+        return static_cast<TValue>(Math::Sqrt<TPrecision>(DistanceSquared(Vec1, Vec2)));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator+(ColorRGBA& Other) const
+    constexpr float ColorRGBA<TValue>::DistanceSquared(const ColorRGBA& Vec1, const ColorRGBA& Vec2)
+    {
+        const float redDifference = static_cast<float>(Vec2.Red - Vec1.Red);
+        const float greenDifference = static_cast<float>(Vec2.Green - Vec1.Green);
+        const float blueDifference = static_cast<float>(Vec2.Blue - Vec1.Blue);
+        const float alphaDifference = static_cast<float>(Vec2.Alpha - Vec1.Alpha);
+        return redDifference * redDifference + greenDifference * greenDifference + blueDifference * blueDifference + alphaDifference * alphaDifference;
+    }
+
+    template <typename TValue>
+    constexpr TValue ColorRGBA<TValue>::DotProduct(const ColorRGBA& Vec1, const ColorRGBA& Vec2)
+    {
+        return Vec1.Red * Vec2.Red + Vec1.Green * Vec2.Green + Vec1.Blue * Vec2.Blue + Vec1.Alpha * Vec2.Alpha;
+    }
+
+    template <typename TValue>
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator+(const ColorRGBA& Other) const
     {
         return ColorRGBA((Red + Other.Red), (Green + Other.Green), (Blue + Other.Blue), (Alpha + Other.Alpha));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator+(TValue& Other) const
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator+(TValue Other) const
     {
         return ColorRGBA((Red + Other), (Green + Other), (Blue + Other), (Alpha + Other));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator-(ColorRGBA& Other) const
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator-(const ColorRGBA& Other) const
     {
         return ColorRGBA((Red - Other.Red), (Green - Other.Green), (Blue - Other.Blue), (Alpha - Other.Alpha));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator-(TValue& Other) const
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator-(TValue Other) const
     {
         return ColorRGBA((Red - Other), (Green - Other), (Blue - Other), (Alpha - Other));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator*(TValue& Other) const
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator*(TValue Other) const
     {
         return ColorRGBA((Red * Other), (Green * Other), (Blue * Other), (Alpha * Other));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator/(TValue& Other) const
+    constexpr ColorRGBA<TValue> ColorRGBA<TValue>::operator/(TValue Other) const
     {
         return ColorRGBA((Red / Other), (Green / Other), (Blue / Other), (Alpha / Other));
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator+=(ColorRGBA Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator+=(ColorRGBA Other)
     {
         Red += Other.Red;
         Green += Other.Green;
         Blue += Other.Blue;
         Alpha += Other.Alpha;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator+=(TValue Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator+=(TValue Other)
     {
         Red += Other;
         Green += Other;
         Blue += Other;
         Alpha += Other;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator-=(ColorRGBA Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator-=(ColorRGBA Other)
     {
         Red -= Other.Red;
         Green -= Other.Green;
         Blue -= Other.Blue;
         Alpha -= Other.Alpha;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator-=(TValue Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator-=(TValue Other)
     {
         Red -= Other;
         Green -= Other;
         Blue -= Other;
         Alpha -= Other;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator*=(TValue Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator*=(TValue Other)
     {
         Red *= Other;
         Green *= Other;
         Blue *= Other;
         Alpha *= Other;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    ColorRGBA<TValue> ColorRGBA<TValue>::operator/=(TValue Other)
+    constexpr ColorRGBA<TValue>& ColorRGBA<TValue>::operator/=(TValue Other)
     {
         Red /= Other;
         Green /= Other;
         Blue /= Other;
         Alpha /= Other;
-        return ColorRGBA(Red, Green, Blue, Alpha);
+        return *this;
     }
 
     template <typename TValue>
-    bool ColorRGBA<TValue>::operator==(ColorRGBA Other)
+    constexpr bool ColorRGBA<TValue>::operator==(const ColorRGBA& Other) const
     {
         return Other.Red == Red && Other.Green == Green && Other.Blue == Blue && Other.Alpha == Alpha ? true : false;
     }
+
+#if ENGINE_SIMD_SSE
+    //	ColorRGBA<float> specializations. The four elements are contiguous, so each operation is one SSE register.
+
+    template <>
+    FORCEINLINE constexpr float ColorRGBA<float>::LengthSquared() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Red * Red + Green * Green + Blue * Blue + Alpha * Alpha;
+        }
+
+        const __m128 vector = SIMD::Load4(&Red);
+        return SIMD::Dot4Scalar(vector, vector);
+    }
+
+    template <>
+    template <>
+    FORCEINLINE ColorRGBA<float> ColorRGBA<float>::Normalize<Precision::Exact>() const
+    {
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, SIMD::Normalize4(SIMD::Load4(&Red)));
+        return result;
+    }
+
+    template <>
+    template <>
+    FORCEINLINE ColorRGBA<float> ColorRGBA<float>::Normalize<Precision::Fast>() const
+    {
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, SIMD::NormalizeFast4(SIMD::Load4(&Red)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr float ColorRGBA<float>::DistanceSquared(const ColorRGBA& Vec1, const ColorRGBA& Vec2)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            const float redDifference = Vec2.Red - Vec1.Red;
+            const float greenDifference = Vec2.Green - Vec1.Green;
+            const float blueDifference = Vec2.Blue - Vec1.Blue;
+            const float alphaDifference = Vec2.Alpha - Vec1.Alpha;
+            return redDifference * redDifference + greenDifference * greenDifference + blueDifference * blueDifference + alphaDifference * alphaDifference;
+        }
+
+        const __m128 difference = _mm_sub_ps(SIMD::Load4(&Vec2.Red), SIMD::Load4(&Vec1.Red));
+        return SIMD::Dot4Scalar(difference, difference);
+    }
+
+    template <>
+    FORCEINLINE constexpr float ColorRGBA<float>::DotProduct(const ColorRGBA& Vec1, const ColorRGBA& Vec2)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vec1.Red * Vec2.Red + Vec1.Green * Vec2.Green + Vec1.Blue * Vec2.Blue + Vec1.Alpha * Vec2.Alpha;
+        }
+
+        return SIMD::Dot4Scalar(SIMD::Load4(&Vec1.Red), SIMD::Load4(&Vec2.Red));
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator+(const ColorRGBA& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red + Other.Red, Green + Other.Green, Blue + Other.Blue, Alpha + Other.Alpha);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_add_ps(SIMD::Load4(&Red), SIMD::Load4(&Other.Red)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator+(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red + Other, Green + Other, Blue + Other, Alpha + Other);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_add_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator-(const ColorRGBA& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red - Other.Red, Green - Other.Green, Blue - Other.Blue, Alpha - Other.Alpha);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_sub_ps(SIMD::Load4(&Red), SIMD::Load4(&Other.Red)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator-(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red - Other, Green - Other, Blue - Other, Alpha - Other);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_sub_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator*(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red * Other, Green * Other, Blue * Other, Alpha * Other);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_mul_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float> ColorRGBA<float>::operator/(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return ColorRGBA(Red / Other, Green / Other, Blue / Other, Alpha / Other);
+        }
+
+        ColorRGBA<float> result;
+        SIMD::Store4(&result.Red, _mm_div_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator+=(ColorRGBA Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red += Other.Red;
+            Green += Other.Green;
+            Blue += Other.Blue;
+            Alpha += Other.Alpha;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_add_ps(SIMD::Load4(&Red), SIMD::Load4(&Other.Red)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator+=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red += Other;
+            Green += Other;
+            Blue += Other;
+            Alpha += Other;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_add_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator-=(ColorRGBA Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red -= Other.Red;
+            Green -= Other.Green;
+            Blue -= Other.Blue;
+            Alpha -= Other.Alpha;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_sub_ps(SIMD::Load4(&Red), SIMD::Load4(&Other.Red)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator-=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red -= Other;
+            Green -= Other;
+            Blue -= Other;
+            Alpha -= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_sub_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator*=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red *= Other;
+            Green *= Other;
+            Blue *= Other;
+            Alpha *= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_mul_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr ColorRGBA<float>& ColorRGBA<float>::operator/=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Red /= Other;
+            Green /= Other;
+            Blue /= Other;
+            Alpha /= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&Red, _mm_div_ps(SIMD::Load4(&Red), _mm_set1_ps(Other)));
+        return *this;
+    }
+#endif
 }
@@ -0,0 +1,158 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is an Arena allocator which bumps inside a chain of blocks and adds a new block when it is full.
+ *
+ *  Current capabilities:
+ *  -   Allocate is an aligned pointer bump, the arena grows instead of running out of memory.
+ *  -   Reset releases every allocation at once and keeps the first block for the next use.
+ *  -   Release gives every block back to the heap.
+ *  -   Get. (Returns the thread local arena of the calling thread)
+ *
+ *  Containers which use this allocator must not be touched after Reset or Release.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/Types.h"
+
+#include <new>
+
+namespace Engine
+{
+    class ArenaAllocator
+    {
+    public:
+        static constexpr uint64 DefaultBlockSize = 1024 * 1024;
+
+        ArenaAllocator();
+        explicit ArenaAllocator(uint64 blockSize);
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+        ~ArenaAllocator();
+
+        void* Allocate(uint64 size, uint64 alignment);
+        void Deallocate(void* memory, uint64 size, uint64 alignment);
+        void Reset();
+        void Release();
+
+        uint64 UsedSize() const;
+
+        static ArenaAllocator& Get();
+
+    private:
+        struct Block
+        {
+            Block* Next;
+            uint64 Capacity;
+            uint64 Offset;
+        };
+
+        Block* CurrentBlock = nullptr;
+        uint64 BlockSize;
+        uint64 usedSize = 0;
+
+        void AddBlock(uint64 minimumSize);
+        static byte* BlockMemory(Block* block);
+    };
+
+    inline ArenaAllocator::ArenaAllocator() : ArenaAllocator(DefaultBlockSize)
+    {
+    }
+
+    inline ArenaAllocator::ArenaAllocator(uint64 blockSize) : BlockSize(blockSize)
+    {
+    }
+
+    inline ArenaAllocator::~ArenaAllocator()
+    {
+        Release();
+    }
+
+    inline void* ArenaAllocator::Allocate(uint64 size, uint64 alignment)
+    {
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            if (CurrentBlock != nullptr)
+            {
+                const uint64 address = reinterpret_cast<uint64>(BlockMemory(CurrentBlock)) + CurrentBlock->Offset;
+                const uint64 alignedOffset = CurrentBlock->Offset + ((alignment - address % alignment) % alignment);
+
+                if (alignedOffset + size <= CurrentBlock->Capacity)
+                {
+                    usedSize += alignedOffset + size - CurrentBlock->Offset;
+                    CurrentBlock->Offset = alignedOffset + size;
+                    return BlockMemory(CurrentBlock) + alignedOffset;
+                }
+            }
+            AddBlock(size + alignment);
+        }
+        throw "Out of Memory";
+    }
+
+    inline void ArenaAllocator::Deallocate(void* memory, uint64 size, uint64 /*alignment*/)
+    {
+        //	Only the top allocation of the current block can be given back, the rest is released by Reset.
+        if (CurrentBlock != nullptr && static_cast<byte*>(memory) + size == BlockMemory(CurrentBlock) + CurrentBlock->Offset)
+        {
+            CurrentBlock->Offset -= size;
+            usedSize -= size;
+        }
+    }
+
+    inline void ArenaAllocator::Reset()
+    {
+        if (CurrentBlock == nullptr)
+            return;
+
+        //	Blocks are pushed to the front, so the first block is the last one in the chain.
+        while (CurrentBlock->Next != nullptr)
+        {
+            Block* next = CurrentBlock->Next;
+            ::operator delete(CurrentBlock);
+            CurrentBlock = next;
+        }
+        CurrentBlock->Offset = 0;
+        usedSize = 0;
+    }
+
+    inline void ArenaAllocator::Release()
+    {
+        while (CurrentBlock != nullptr)
+        {
+            Block* next = CurrentBlock->Next;
+            ::operator delete(CurrentBlock);
+            CurrentBlock = next;
+        }
+        usedSize = 0;
+    }
+
+    inline uint64 ArenaAllocator::UsedSize() const
+    {
+        return usedSize;
+    }
+
+    inline ArenaAllocator& ArenaAllocator::Get()
+    {
+        thread_local ArenaAllocator instance;
+        return instance;
+    }
+
+    inline void ArenaAllocator::AddBlock(uint64 minimumSize)
+    {
+        const uint64 capacity = minimumSize > BlockSize ? minimumSize : BlockSize;
+
+        Block* block = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+        block->Next = CurrentBlock;
+        block->Capacity = capacity;
+        block->Offset = 0;
+        CurrentBlock = block;
+    }
+
+    inline byte* ArenaAllocator::BlockMemory(Block* block)
+    {
+        return reinterpret_cast<byte*>(block + 1);
+    }
+}
@@ -7,221 +7,583 @@
  *  Current capabilities:
  *  -   All written functions are working properly.
  *  -   [] operator is also working correctly.
+ *  -   Growth relocates every element only once and moves instead of copying.
+ *  -   Reserve, ShrinkToFit, EmplaceBack and Emplace for callers who know their final size.
+ *  -   Spare capacity is raw storage, elements are only constructed when they are added.
+ *  -   Trivially copyable types are relocated with memcpy/memmove.
+ *  -   Insert and Remove shift in place and only allocate when the capacity is full.
+ *  -   RemoveSwap for O(1) removal when the order of elements does not matter.
+ *  -   AppendRange, InsertRange, RemoveRange and RemoveIf with at most one reallocation.
+ *  -   Contiguous iterators (begin/end), so it works with <algorithm> and Containers/Parallel.h.
+ *  -   Allocator policy. (HeapAllocator by default, LinearAllocator, ArenaAllocator, PoolAllocator)
+ *  -   The element block is aligned to alignof(T) or to the explicit TAlignment, whichever is bigger.
  *
  *****************************************************************************************************/
 
 #pragma once
 
+#include "Containers/ContainerMemory.h"
+#include "Containers/HeapAllocator.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace Engine
 {
-    template <typename T>
+    template <typename T, typename TAllocator = HeapAllocator, unsigned int TAlignment = alignof(T)>
     class Array
     {
+        static_assert((TAlignment & (TAlignment - 1)) == 0, "Array alignment has to be a power of two.");
+
     public:
+        //	Alignment of the element block, never less than alignof(T).
+        static constexpr unsigned int Alignment = TAlignment > alignof(T) ? TAlignment : alignof(T);
+
+        using Iterator = T*;
+        using ConstIterator = const T*;
+
         Array();
-        ~Array() = default;
+        explicit Array(TAllocator& allocator);
+        Array(const Array& other);
+        Array(Array&& other) noexcept;
+        ~Array();
+
+        Array& operator=(const Array& other);
+        Array& operator=(Array&& other) noexcept;
 
         void Init(unsigned int initSize);
         T* GetSource() { return ArrayPtr; }
-        
+        const T* GetSource() const { return ArrayPtr; }
+        TAllocator& GetAllocator() const { return *Allocator; }
+
         unsigned int Length() const;
         unsigned int Size() const;
-        
+        unsigned int MaxLength() const;
+
         T& At(unsigned int index);
+        const T& At(unsigned int index) const;
         T& operator[](const unsigned index);
+        const T& operator[](const unsigned index) const;
+
+        Iterator begin() { return ArrayPtr; }
+        Iterator end() { return ArrayPtr + currentLength; }
+        ConstIterator begin() const { return ArrayPtr; }
+        ConstIterator end() const { return ArrayPtr + currentLength; }
+        ConstIterator cbegin() const { return ArrayPtr; }
+        ConstIterator cend() const { return ArrayPtr + currentLength; }
 
         void Add(const T& element);
+        void Add(T&& element);
         void InsertFirst(const T& element);
         void InsertByIndex(const T& element, unsigned index);
         void RemoveFirst();
         void Remove(const unsigned index);
+        void RemoveSwap(const unsigned index);
         void RemoveAll();
 
+        void AppendRange(const T* elements, unsigned int count);
+        void InsertRange(unsigned index, const T* elements, unsigned int count);
+        void RemoveRange(unsigned index, unsigned int count);
+
+        template <typename TPredicate>
+        unsigned int RemoveIf(TPredicate predicate);
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args);
+
+        template <typename... Args>
+        T& Emplace(unsigned index, Args&&... args);
+
+        void Reserve(unsigned int newMaximumLength);
+        void Resize(unsigned int newLength);
+        void ShrinkToFit();
+
         void Swap(const unsigned& swapItemIndex1, const unsigned& swapItemIndex2);
     private:
-        
-        unsigned int maximumLength = 5;
-        unsigned int currentLength;
-        T* ArrayPtr;
+
+        unsigned int maximumLength = 0;
+        unsigned int currentLength = 0;
+        T* ArrayPtr = nullptr;
+        TAllocator* Allocator;
 
         void ChangeSize();
+        void Relocate(unsigned int newMaximumLength);
+        unsigned int GrownLength() const;
+        unsigned int GrownLength(unsigned int requiredLength) const;
+        bool Contains(const T* element) const;
         void ClearMemory();
-        unsigned MaxLength() const;
+
+        T* AllocateMemory(unsigned int length);
+        void FreeMemory(T* memory, unsigned int length);
     };
 
-    template <typename T>
-    Array<T>::Array()
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>::Array() : Allocator(&TAllocator::Get())
     {
-        currentLength = 0;
-        ArrayPtr = new T[this->maximumLength];
     }
 
-    template <typename T>
-    void Array<T>::Init(unsigned initSize)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>::Array(TAllocator& allocator) : Allocator(&allocator)
+    {
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>::Array(const Array& other) : Allocator(other.Allocator)
+    {
+        maximumLength = other.currentLength;
+        currentLength = other.currentLength;
+        ArrayPtr = AllocateMemory(maximumLength);
+
+        ContainerMemory::CopyConstructElements(ArrayPtr, other.ArrayPtr, currentLength);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>::Array(Array&& other) noexcept : Allocator(other.Allocator)
+    {
+        maximumLength = other.maximumLength;
+        currentLength = other.currentLength;
+        ArrayPtr = other.ArrayPtr;
+
+        other.maximumLength = 0;
+        other.currentLength = 0;
+        other.ArrayPtr = nullptr;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>::~Array()
+    {
+        ClearMemory();
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>& Array<T, TAllocator, TAlignment>::operator=(const Array& other)
     {
-        maximumLength = initSize;
-        ArrayPtr = new T*[this->maximumLength];
+        if (this != &other)
+        {
+            Array temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
     }
 
-    template <typename T>
-    unsigned Array<T>::Length() const
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    Array<T, TAllocator, TAlignment>& Array<T, TAllocator, TAlignment>::operator=(Array&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ClearMemory();
+
+            maximumLength = other.maximumLength;
+            currentLength = other.currentLength;
+            ArrayPtr = other.ArrayPtr;
+            Allocator = other.Allocator;
+
+            other.maximumLength = 0;
+            other.currentLength = 0;
+            other.ArrayPtr = nullptr;
+        }
+        return *this;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Init(unsigned initSize)
+    {
+        Reserve(initSize);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    unsigned Array<T, TAllocator, TAlignment>::Length() const
     {
         return currentLength;
     }
 
-    template <typename T>
-    unsigned Array<T>::Size() const
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    unsigned Array<T, TAllocator, TAlignment>::Size() const
     {
         return sizeof(T) * currentLength;
     }
 
-    template <typename T>
-    unsigned Array<T>::MaxLength() const
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    unsigned Array<T, TAllocator, TAlignment>::MaxLength() const
     {
         return maximumLength;
     }
 
-    template <typename T>
-    T& Array<T>::At(unsigned index)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    T& Array<T, TAllocator, TAlignment>::At(unsigned index)
     {
         return ArrayPtr[index];
     }
 
-    template <typename T>
-    T& Array<T>::operator[](const unsigned index)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    const T& Array<T, TAllocator, TAlignment>::At(unsigned index) const
     {
         return ArrayPtr[index];
     }
 
-    template <typename T>
-    void Array<T>::Add(const T& element)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    T& Array<T, TAllocator, TAlignment>::operator[](const unsigned index)
     {
-        if (currentLength == maximumLength)
-        {
-            ChangeSize();
-        }
-        ArrayPtr[currentLength] = element;
-        currentLength++;
+        return ArrayPtr[index];
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    const T& Array<T, TAllocator, TAlignment>::operator[](const unsigned index) const
+    {
+        return ArrayPtr[index];
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Add(const T& element)
+    {
+        EmplaceBack(element);
     }
 
-    template <typename T>
-    void Array<T>::InsertFirst(const T& element)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Add(T&& element)
+    {
+        EmplaceBack(std::move(element));
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::InsertFirst(const T& element)
     {
         InsertByIndex(element, 0);
     }
 
-    template <typename T>
-    void Array<T>::InsertByIndex(const T& element, unsigned index)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::InsertByIndex(const T& element, unsigned index)
     {
-        if (currentLength == maximumLength)
+        Emplace(index, element);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::AppendRange(const T* elements, unsigned int count)
+    {
+        InsertRange(currentLength, elements, count);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::InsertRange(unsigned index, const T* elements, unsigned int count)
+    {
+        if (index > currentLength)
         {
-            maximumLength *= 2;
+            throw "Out of Range";
         }
+        if (count == 0)
+            return;
 
-        T* Temp = new T[maximumLength];
+        if (currentLength + count > maximumLength)
+        {
+            //	The range is copied before the old block is released, because it may point into this array.
+            const unsigned newMaximumLength = GrownLength(currentLength + count);
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            ContainerMemory::CopyConstructElements(newArrayPtr + index, elements, count);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, index);
+            ContainerMemory::RelocateElements(newArrayPtr + index + count, ArrayPtr + index, currentLength - index);
 
-        for (unsigned i = 0; i < currentLength; i++)
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else if (Contains(elements) && index < currentLength)
+        {
+            //	Opening the gap would move the range itself, so it is copied aside first.
+            Array temp(*Allocator);
+            temp.AppendRange(elements, count);
+            InsertRange(index, temp.ArrayPtr, count);
+            return;
+        }
+        else
         {
-            Temp[i] = ArrayPtr[i];
+            ContainerMemory::OpenGap(ArrayPtr, currentLength, index, count);
+            ContainerMemory::CopyConstructElements(ArrayPtr + index, elements, count);
         }
+        currentLength += count;
+    }
 
-        ClearMemory();
-        ArrayPtr = new T[maximumLength];
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::RemoveRange(unsigned index, unsigned int count)
+    {
+        if (index > currentLength || count > currentLength - index)
+        {
+            throw "Out of Range";
+        }
+
+        ContainerMemory::CloseGap(ArrayPtr, currentLength, index, count);
+        currentLength -= count;
+    }
 
-        for (unsigned i = 0; i < index; i++)
+    //	Stable single pass compaction, returns how many elements were removed.
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    template <typename TPredicate>
+    unsigned int Array<T, TAllocator, TAlignment>::RemoveIf(TPredicate predicate)
+    {
+        unsigned writeIndex = 0;
+        for (unsigned readIndex = 0; readIndex < currentLength; readIndex++)
         {
-            ArrayPtr[i] = Temp[i];
+            if (predicate(ArrayPtr[readIndex]))
+                continue;
+
+            if (writeIndex != readIndex)
+            {
+                ArrayPtr[writeIndex] = std::move(ArrayPtr[readIndex]);
+            }
+            writeIndex++;
         }
 
-        ArrayPtr[index] = element;
+        const unsigned removedCount = currentLength - writeIndex;
+        ContainerMemory::DestroyElements(ArrayPtr + writeIndex, removedCount);
+        currentLength = writeIndex;
+        return removedCount;
+    }
 
-        for (unsigned i = index; i < currentLength; i++)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    template <typename... Args>
+    T& Array<T, TAllocator, TAlignment>::EmplaceBack(Args&&... args)
+    {
+        if (currentLength == maximumLength)
         {
-            ArrayPtr[i + 1] = Temp[i];
+            //	The element is built in the new block before the old one is released, because args may refer to an element of this array.
+            const unsigned newMaximumLength = GrownLength();
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            new (newArrayPtr + currentLength) T(std::forward<Args>(args)...);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, currentLength);
+
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else
+        {
+            new (ArrayPtr + currentLength) T(std::forward<Args>(args)...);
         }
-        delete[] Temp;
-        currentLength ++;
+        return ArrayPtr[currentLength++];
     }
 
-    template <typename T>
-    void Array<T>::RemoveFirst()
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    template <typename... Args>
+    T& Array<T, TAllocator, TAlignment>::Emplace(unsigned index, Args&&... args)
     {
-        for (unsigned i = 0; i < currentLength - 1; i++)
+        if (index > currentLength)
         {
-            ArrayPtr[i] = ArrayPtr[i + 1];
+            throw "Out of Range";
         }
-        currentLength--;
+
+        if (currentLength == maximumLength)
+        {
+            //	Growing leaves the gap at index while relocating, so every element is moved only once.
+            const unsigned newMaximumLength = GrownLength();
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            new (newArrayPtr + index) T(std::forward<Args>(args)...);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, index);
+            ContainerMemory::RelocateElements(newArrayPtr + index + 1, ArrayPtr + index, currentLength - index);
+
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else if (index == currentLength)
+        {
+            new (ArrayPtr + index) T(std::forward<Args>(args)...);
+        }
+        else if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            T element(std::forward<Args>(args)...);
+
+            memmove(ArrayPtr + index + 1, ArrayPtr + index, sizeof(T) * (currentLength - index));
+            new (ArrayPtr + index) T(std::move(element));
+        }
+        else
+        {
+            T element(std::forward<Args>(args)...);
+
+            new (ArrayPtr + currentLength) T(std::move(ArrayPtr[currentLength - 1]));
+            for (unsigned i = currentLength - 1; i > index; i--)
+            {
+                ArrayPtr[i] = std::move(ArrayPtr[i - 1]);
+            }
+            ArrayPtr[index] = std::move(element);
+        }
+
+        currentLength++;
+        return ArrayPtr[index];
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::RemoveFirst()
+    {
+        Remove(0);
     }
 
-    template <typename T>
-    void Array<T>::Remove(const unsigned order)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Remove(const unsigned order)
     {
         if (order >= currentLength)
         {
             throw "Out of Range";
         }
 
-        for (unsigned i = order; i < currentLength; i++)
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            memmove(ArrayPtr + order, ArrayPtr + order + 1, sizeof(T) * (currentLength - order - 1));
+        }
+        else
+        {
+            for (unsigned i = order + 1; i < currentLength; i++)
+            {
+                ArrayPtr[i - 1] = std::move(ArrayPtr[i]);
+            }
+        }
+        currentLength--;
+        ContainerMemory::DestroyElements(ArrayPtr + currentLength, 1);
+    }
+
+    //	Fills the hole with the last element instead of shifting the tail, so the order is not preserved.
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::RemoveSwap(const unsigned order)
+    {
+        if (order >= currentLength)
         {
-            ArrayPtr[i - 1] = ArrayPtr[i];
+            throw "Out of Range";
         }
+
         currentLength--;
+        if (order != currentLength)
+        {
+            ArrayPtr[order] = std::move(ArrayPtr[currentLength]);
+        }
+        ContainerMemory::DestroyElements(ArrayPtr + currentLength, 1);
     }
 
-    template <typename T>
-    void Array<T>::RemoveAll()
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::RemoveAll()
     {
         ClearMemory();
-        maximumLength = 5;
+        ArrayPtr = nullptr;
+        maximumLength = 0;
         currentLength = 0;
     }
 
-    template <typename T>
-    void Array<T>::Swap(const unsigned& swapItemIndex1, const unsigned& swapItemIndex2)
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Reserve(unsigned int newMaximumLength)
     {
-        if (swapItemIndex1 >= currentLength || swapItemIndex1 <= currentLength)
+        if (newMaximumLength > maximumLength)
         {
-            throw "Out of Range";
+            Relocate(newMaximumLength);
         }
-        T TempData = ArrayPtr[swapItemIndex1];
-
-        ArrayPtr[swapItemIndex1] = ArrayPtr[swapItemIndex2];
-        ArrayPtr[swapItemIndex2] = TempData;
     }
 
-    template <typename T>
-    void Array<T>::ChangeSize()
+    //	New elements are value initialized, elements past newLength are destroyed.
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Resize(unsigned int newLength)
     {
-        T* TempData = nullptr;
-        if (currentLength == maximumLength)
+        if (newLength < currentLength)
         {
-            TempData = new T[maximumLength];
-            {
-                for (unsigned i = 0; i < currentLength; i++)
-                {
-                    TempData[i] = ArrayPtr[i];
-                }
-            }
+            ContainerMemory::DestroyElements(ArrayPtr + newLength, currentLength - newLength);
+            currentLength = newLength;
+            return;
+        }
 
-            ClearMemory();
+        if (newLength > maximumLength)
+        {
+            Relocate(GrownLength(newLength));
+        }
+        for (unsigned i = currentLength; i < newLength; i++)
+        {
+            new (ArrayPtr + i) T();
+        }
+        currentLength = newLength;
+    }
 
-            maximumLength = maximumLength * 2;
-            ArrayPtr = new T[maximumLength];
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::ShrinkToFit()
+    {
+        if (currentLength < maximumLength)
+        {
+            Relocate(currentLength);
+        }
+    }
 
-            for (unsigned i = 0; i < currentLength; i++)
-            {
-                ArrayPtr[i] = TempData[i];
-            }
-            delete[] TempData;
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Swap(const unsigned& swapItemIndex1, const unsigned& swapItemIndex2)
+    {
+        if (swapItemIndex1 >= currentLength || swapItemIndex2 >= currentLength)
+        {
+            throw "Out of Range";
         }
+        T TempData = std::move(ArrayPtr[swapItemIndex1]);
+
+        ArrayPtr[swapItemIndex1] = std::move(ArrayPtr[swapItemIndex2]);
+        ArrayPtr[swapItemIndex2] = std::move(TempData);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::ChangeSize()
+    {
+        Relocate(GrownLength());
     }
 
-    template <typename T>
-    void Array<T>::ClearMemory()
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::Relocate(unsigned int newMaximumLength)
+    {
+        T* newArrayPtr = AllocateMemory(newMaximumLength);
+        ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, currentLength);
+
+        FreeMemory(ArrayPtr, maximumLength);
+        ArrayPtr = newArrayPtr;
+        maximumLength = newMaximumLength;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    unsigned int Array<T, TAllocator, TAlignment>::GrownLength() const
+    {
+        return maximumLength ? maximumLength * 2 : 5;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    unsigned int Array<T, TAllocator, TAlignment>::GrownLength(unsigned int requiredLength) const
+    {
+        const unsigned grownLength = GrownLength();
+        return grownLength > requiredLength ? grownLength : requiredLength;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    bool Array<T, TAllocator, TAlignment>::Contains(const T* element) const
+    {
+        return element >= ArrayPtr && element < ArrayPtr + currentLength;
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::ClearMemory()
     {
         if (ArrayPtr == nullptr)
             return;
 
-        delete[] ArrayPtr;
+        ContainerMemory::DestroyElements(ArrayPtr, currentLength);
+        FreeMemory(ArrayPtr, maximumLength);
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    T* Array<T, TAllocator, TAlignment>::AllocateMemory(unsigned int length)
+    {
+        if (length == 0)
+            return nullptr;
+
+        return static_cast<T*>(Allocator->Allocate(sizeof(T) * length, Alignment));
+    }
+
+    template <typename T, typename TAllocator, unsigned int TAlignment>
+    void Array<T, TAllocator, TAlignment>::FreeMemory(T* memory, unsigned int length)
+    {
+        if (memory == nullptr)
+            return;
+
+        Allocator->Deallocate(memory, sizeof(T) * length, Alignment);
     }
 }
@@ -0,0 +1,357 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Concurrent Array which many threads can append to at the same time without a lock.
+ *
+ *  Current capabilities:
+ *  -   Add, AddRange and Claim reserve their slots with a single atomic fetch-add.
+ *  -   Storage grows in chunks, chunk k holds FirstChunkLength * 2^(k - 1) elements, so elements never move
+ *      while producers are running and a new chunk is published with one compare-exchange.
+ *  -   Consolidate moves everything into one contiguous block once the producers are done.
+ *
+ *  Producer phase: Add, AddRange, Claim and [] operator on claimed indices can run on any thread.
+ *  Consumer phase: after every producer has finished (thread join, job barrier...), Consolidate and
+ *  then GetSource, begin/end and the Parallel algorithms see one contiguous array.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/ContainerMemory.h"
+#include "Containers/HeapAllocator.h"
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Engine
+{
+    template <typename T>
+    class ConcurrentArray
+    {
+    public:
+        using Iterator = T*;
+        using ConstIterator = const T*;
+
+        static constexpr unsigned int DefaultFirstChunkLength = 1024;
+
+        ConcurrentArray();
+        explicit ConcurrentArray(unsigned int initialChunkLength);
+        ConcurrentArray(const ConcurrentArray&) = delete;
+        ConcurrentArray& operator=(const ConcurrentArray&) = delete;
+        ~ConcurrentArray();
+
+        //	Count of claimed slots. Only exact when no producer is running.
+        unsigned int Length() const;
+
+        T& operator[](const unsigned index);
+        const T& operator[](const unsigned index) const;
+
+        //	Appends one element and gives its index. Thread safe.
+        template <typename... Args>
+        unsigned int Add(Args&&... args);
+
+        //	Appends count elements with one fetch-add and gives the index of the first one. Thread safe.
+        unsigned int AddRange(const T* elements, unsigned int count);
+
+        //	Claims count default initialized slots for the caller to fill through [] operator. Thread safe.
+        unsigned int Claim(unsigned int count);
+
+        //	Moves every element into one contiguous block and gives it. Not thread safe.
+        T* Consolidate();
+        bool IsContiguous() const;
+
+        //	Only valid while IsContiguous is true, which Consolidate guarantees.
+        T* GetSource() { return Chunks[0].load(std::memory_order_acquire); }
+        Iterator begin() { return GetSource(); }
+        Iterator end() { return GetSource() + Length(); }
+        ConstIterator begin() const { return Chunks[0].load(std::memory_order_acquire); }
+        ConstIterator end() const { return begin() + Length(); }
+
+        //	Makes the first chunk hold at least newMaximumLength elements and every current one, so the array is
+        //	contiguous afterwards. Not thread safe.
+        void Reserve(unsigned int newMaximumLength);
+
+        //	Destroys every element and keeps the first chunk for the next use. Not thread safe.
+        void RemoveAll();
+
+    private:
+        static constexpr unsigned int MaximumChunkCount = 32;
+
+        std::atomic<unsigned int> currentLength;
+        std::atomic<T*> Chunks[MaximumChunkCount];
+        unsigned int firstChunkLength;
+        unsigned int firstChunkShift;
+
+        T* Slot(unsigned int index) const;
+        unsigned int ChunkIndex(unsigned int index) const;
+        unsigned int ChunkStart(unsigned int chunk) const;
+        unsigned int ChunkLength(unsigned int chunk) const;
+        void EnsureChunks(unsigned int beginIndex, unsigned int endIndex);
+        void DestroyAndFree(bool keepFirstChunk);
+
+        static unsigned int HighestBit(unsigned int value);
+        static T* AllocateMemory(unsigned int length);
+        static void FreeMemory(T* memory, unsigned int length);
+    };
+
+    template <typename T>
+    ConcurrentArray<T>::ConcurrentArray() : ConcurrentArray(DefaultFirstChunkLength)
+    {
+    }
+
+    template <typename T>
+    ConcurrentArray<T>::ConcurrentArray(unsigned int initialChunkLength) : currentLength(0)
+    {
+        //	The chunk math needs a power of two.
+        firstChunkShift = initialChunkLength > 1 ? HighestBit(initialChunkLength - 1) + 1 : 0;
+        firstChunkLength = 1u << firstChunkShift;
+
+        for (unsigned int c = 0; c < MaximumChunkCount; c++)
+        {
+            Chunks[c].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    ConcurrentArray<T>::~ConcurrentArray()
+    {
+        DestroyAndFree(false);
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::Length() const
+    {
+        return currentLength.load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    T& ConcurrentArray<T>::operator[](const unsigned index)
+    {
+        return *Slot(index);
+    }
+
+    template <typename T>
+    const T& ConcurrentArray<T>::operator[](const unsigned index) const
+    {
+        return *Slot(index);
+    }
+
+    template <typename T>
+    template <typename... Args>
+    unsigned int ConcurrentArray<T>::Add(Args&&... args)
+    {
+        const unsigned index = currentLength.fetch_add(1, std::memory_order_acq_rel);
+        EnsureChunks(index, index + 1);
+
+        new (Slot(index)) T(std::forward<Args>(args)...);
+        return index;
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::AddRange(const T* elements, unsigned int count)
+    {
+        const unsigned int firstIndex = currentLength.fetch_add(count, std::memory_order_acq_rel);
+        EnsureChunks(firstIndex, firstIndex + count);
+
+        //	The claimed range may cross chunk boundaries, every chunk part is copied as one run.
+        unsigned int copied = 0;
+        while (copied < count)
+        {
+            const unsigned index = firstIndex + copied;
+            const unsigned int chunk = ChunkIndex(index);
+            const unsigned int chunkRemaining = ChunkStart(chunk) + ChunkLength(chunk) - index;
+            const unsigned int runLength = chunkRemaining < count - copied ? chunkRemaining : count - copied;
+
+            ContainerMemory::CopyConstructElements(Slot(index), elements + copied, runLength);
+            copied += runLength;
+        }
+        return firstIndex;
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::Claim(unsigned int count)
+    {
+        const unsigned int firstIndex = currentLength.fetch_add(count, std::memory_order_acq_rel);
+        EnsureChunks(firstIndex, firstIndex + count);
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            new (Slot(firstIndex + i)) T;
+        }
+        return firstIndex;
+    }
+
+    template <typename T>
+    T* ConcurrentArray<T>::Consolidate()
+    {
+        if (!IsContiguous())
+        {
+            Reserve(Length());
+        }
+        return GetSource();
+    }
+
+    template <typename T>
+    bool ConcurrentArray<T>::IsContiguous() const
+    {
+        return Length() <= firstChunkLength;
+    }
+
+    template <typename T>
+    void ConcurrentArray<T>::Reserve(unsigned int newMaximumLength)
+    {
+        //	The elements are relocated into the new first chunk, so it never gets smaller than Length.
+        const unsigned int length = Length();
+        if (newMaximumLength < length)
+        {
+            newMaximumLength = length;
+        }
+
+        if (newMaximumLength <= firstChunkLength && Chunks[0].load(std::memory_order_relaxed) != nullptr)
+        {
+            return;
+        }
+
+        const unsigned int newShift = newMaximumLength > firstChunkLength ? HighestBit(newMaximumLength - 1) + 1 : firstChunkShift;
+        const unsigned int newFirstChunkLength = 1u << newShift;
+        T* newFirstChunk = AllocateMemory(newFirstChunkLength);
+
+        unsigned int relocated = 0;
+        for (unsigned int chunk = 0; relocated < length; chunk++)
+        {
+            const unsigned int chunkLength = ChunkLength(chunk);
+            const unsigned int runLength = chunkLength < length - relocated ? chunkLength : length - relocated;
+
+            ContainerMemory::RelocateElements(newFirstChunk + relocated, Chunks[chunk].load(std::memory_order_relaxed), runLength);
+            relocated += runLength;
+        }
+
+        for (unsigned int chunk = 0; chunk < MaximumChunkCount; chunk++)
+        {
+            FreeMemory(Chunks[chunk].load(std::memory_order_relaxed), ChunkLength(chunk));
+            Chunks[chunk].store(nullptr, std::memory_order_relaxed);
+        }
+
+        firstChunkShift = newShift;
+        firstChunkLength = newFirstChunkLength;
+        Chunks[0].store(newFirstChunk, std::memory_order_release);
+    }
+
+    template <typename T>
+    void ConcurrentArray<T>::RemoveAll()
+    {
+        DestroyAndFree(true);
+    }
+
+    template <typename T>
+    T* ConcurrentArray<T>::Slot(unsigned int index) const
+    {
+        const unsigned int chunk = ChunkIndex(index);
+        return Chunks[chunk].load(std::memory_order_acquire) + (index - ChunkStart(chunk));
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::ChunkIndex(unsigned int index) const
+    {
+        const unsigned int scaledIndex = index >> firstChunkShift;
+        return scaledIndex == 0 ? 0 : HighestBit(scaledIndex) + 1;
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::ChunkStart(unsigned int chunk) const
+    {
+        return chunk == 0 ? 0 : firstChunkLength << (chunk - 1);
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::ChunkLength(unsigned int chunk) const
+    {
+        return chunk == 0 ? firstChunkLength : firstChunkLength << (chunk - 1);
+    }
+
+    //	Every missing chunk is allocated by whoever gets there first, losers free their block and use the winner's.
+    template <typename T>
+    void ConcurrentArray<T>::EnsureChunks(unsigned int beginIndex, unsigned int endIndex)
+    {
+        if (beginIndex == endIndex)
+        {
+            return;
+        }
+
+        const unsigned int lastChunk = ChunkIndex(endIndex - 1);
+        if (lastChunk >= MaximumChunkCount)
+        {
+            throw "Out of Range";
+        }
+
+        for (unsigned int chunk = ChunkIndex(beginIndex); chunk <= lastChunk; chunk++)
+        {
+            if (Chunks[chunk].load(std::memory_order_acquire) != nullptr)
+                continue;
+
+            T* newChunk = AllocateMemory(ChunkLength(chunk));
+            T* expected = nullptr;
+            if (!Chunks[chunk].compare_exchange_strong(expected, newChunk, std::memory_order_acq_rel))
+            {
+                FreeMemory(newChunk, ChunkLength(chunk));
+            }
+        }
+    }
+
+    template <typename T>
+    void ConcurrentArray<T>::DestroyAndFree(bool keepFirstChunk)
+    {
+        const unsigned int length = Length();
+        unsigned int destroyed = 0;
+        for (unsigned int chunk = 0; destroyed < length; chunk++)
+        {
+            const unsigned int chunkLength = ChunkLength(chunk);
+            const unsigned int runLength = chunkLength < length - destroyed ? chunkLength : length - destroyed;
+
+            ContainerMemory::DestroyElements(Chunks[chunk].load(std::memory_order_relaxed), runLength);
+            destroyed += runLength;
+        }
+
+        for (unsigned int chunk = keepFirstChunk ? 1 : 0; chunk < MaximumChunkCount; chunk++)
+        {
+            FreeMemory(Chunks[chunk].load(std::memory_order_relaxed), ChunkLength(chunk));
+            Chunks[chunk].store(nullptr, std::memory_order_relaxed);
+        }
+        currentLength.store(0, std::memory_order_release);
+    }
+
+    template <typename T>
+    unsigned int ConcurrentArray<T>::HighestBit(unsigned int value)
+    {
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanReverse(&bit, value);
+        return bit;
+#else
+        return 31 - __builtin_clz(value);
+#endif
+    }
+
+    template <typename T>
+    T* ConcurrentArray<T>::AllocateMemory(unsigned int length)
+    {
+        return static_cast<T*>(HeapAllocator::Get().Allocate(sizeof(T) * length, alignof(T)));
+    }
+
+    template <typename T>
+    void ConcurrentArray<T>::FreeMemory(T* memory, unsigned int length)
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+
+        HeapAllocator::Get().Deallocate(memory, sizeof(T) * length, alignof(T));
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  These are the element lifetime helpers which are shared by the contiguous containers.
+ *
+ *  Current capabilities:
+ *  -   Relocate, copy construct and destroy a run of elements in raw storage.
+ *  -   Open and close a gap inside a run of elements in place.
+ *  -   Trivially copyable types are handled with memcpy and skip their destructors.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Engine
+{
+    namespace ContainerMemory
+    {
+        //	Moves count elements into uninitialized destination and ends the lifetime of the source elements.
+        template <typename T>
+        void RelocateElements(T* destination, T* source, unsigned int count)
+        {
+            if (count == 0)
+                return;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                memcpy(destination, source, sizeof(T) * count);
+            }
+            else
+            {
+                for (unsigned i = 0; i < count; i++)
+                {
+                    new (destination + i) T(std::move(source[i]));
+                    source[i].~T();
+                }
+            }
+        }
+
+        //	Copies count elements into uninitialized destination.
+        template <typename T>
+        void CopyConstructElements(T* destination, const T* source, unsigned int count)
+        {
+            if (count == 0)
+                return;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                memcpy(destination, source, sizeof(T) * count);
+            }
+            else
+            {
+                for (unsigned i = 0; i < count; i++)
+                {
+                    new (destination + i) T(source[i]);
+                }
+            }
+        }
+
+        //	Shifts [index, length) to index + count, the gap left behind is uninitialized. Capacity must already fit.
+        template <typename T>
+        void OpenGap(T* elements, unsigned int length, unsigned int index, unsigned int count)
+        {
+            if (count == 0 || index == length)
+                return;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                memmove(elements + index + count, elements + index, sizeof(T) * (length - index));
+            }
+            else
+            {
+                //	Walking backwards, every destination is either past the end or was already moved away.
+                for (unsigned i = length; i > index; i--)
+                {
+                    new (elements + i - 1 + count) T(std::move(elements[i - 1]));
+                    elements[i - 1].~T();
+                }
+            }
+        }
+
+        //	Destroys [index, index + count) and shifts the rest of the run down to index.
+        template <typename T>
+        void CloseGap(T* elements, unsigned int length, unsigned int index, unsigned int count)
+        {
+            if (count == 0)
+                return;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                memmove(elements + index, elements + index + count, sizeof(T) * (length - index - count));
+            }
+            else
+            {
+                for (unsigned i = index; i < index + count; i++)
+                {
+                    elements[i].~T();
+                }
+                for (unsigned i = index + count; i < length; i++)
+                {
+                    new (elements + i - count) T(std::move(elements[i]));
+                    elements[i].~T();
+                }
+            }
+        }
+
+        template <typename T>
+        void DestroyElements(T* elements, unsigned int count)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (unsigned i = 0; i < count; i++)
+                {
+                    elements[i].~T();
+                }
+            }
+        }
+    }
+}
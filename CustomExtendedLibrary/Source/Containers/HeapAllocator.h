@@ -0,0 +1,55 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is the default allocator of the containers which directly forwards to the global heap.
+ *
+ *  Current capabilities:
+ *  -   Allocate and Deallocate with the same interface as the other container allocators.
+ *  -   Alignments above the default new alignment use the aligned operator new.
+ *  -   Get. (Returns the shared instance, the heap allocator has no state)
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/Types.h"
+
+#include <new>
+
+namespace Engine
+{
+    class HeapAllocator
+    {
+    public:
+        void* Allocate(uint64 size, uint64 alignment);
+        void Deallocate(void* memory, uint64 size, uint64 alignment);
+
+        static HeapAllocator& Get();
+    };
+
+    inline void* HeapAllocator::Allocate(uint64 size, uint64 alignment)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+        return ::operator new(size);
+    }
+
+    inline void HeapAllocator::Deallocate(void* memory, uint64 /*size*/, uint64 alignment)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(memory, std::align_val_t(alignment));
+            return;
+        }
+        ::operator delete(memory);
+    }
+
+    inline HeapAllocator& HeapAllocator::Get()
+    {
+        static HeapAllocator instance;
+        return instance;
+    }
+}
@@ -0,0 +1,439 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a k-d tree over a Vector3<float> point set for nearest neighbour, radius and box queries.
+ *
+ *  Current capabilities:
+ *  -   Balanced median split on the axis with the largest extent, down to leaves of at most LeafSize points.
+ *  -   Flattened layout. Nodes are 8 bytes in breadth first (heap) order, so children are found by index
+ *      and there are no pointers. Points are copied in leaf order, every leaf is one contiguous run.
+ *  -   Nearest, KNearest (sorted by distance), Radius and Box queries. They give the indices of the points
+ *      in the array the tree was built from.
+ *  -   Queries only compare squared distances and skip every cell which is farther than the current bound,
+ *      the distance to a cell is updated per axis on the way down. (No square root in the whole search)
+ *  -   Optional multithreaded build (subtrees on Parallel::For) and multithreaded batch Nearest.
+ *
+ *  The tree is a snapshot, Build it again after the points change.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Vectors/Vector3.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Engine
+{
+    class KdTree
+    {
+    public:
+        struct Neighbour
+        {
+            unsigned int Index;
+            float DistanceSquared;
+        };
+
+        static constexpr unsigned int LeafSize = 8;
+
+        //	Multithreaded build only hands out subtrees with at least this many points.
+        static constexpr unsigned int MultithreadedSubtreeLength = 16384;
+
+        //	If it is not built, it is an empty tree.
+        KdTree();
+
+        template <typename TAllocator, unsigned int TAlignment>
+        explicit KdTree(const Array<Vector3<float>, TAllocator, TAlignment>& points, bool multithreaded = false);
+
+        //	Replaces the tree with one over the given points.
+        void Build(const Vector3<float>* points, unsigned int count, bool multithreaded = false);
+
+        template <typename TAllocator, unsigned int TAlignment>
+        void Build(const Array<Vector3<float>, TAllocator, TAlignment>& points, bool multithreaded = false);
+
+        //	Gives the count of points in the tree.
+        unsigned int Length() const;
+
+        //	Gives the index of the closest point. An empty tree throws "Out of Range".
+        unsigned int Nearest(const Vector3<float>& point) const;
+
+        //	results[i] = Nearest(queries[i]), results is resized to the length of queries.
+        template <typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        void Nearest(const Array<Vector3<float>, TAllocator, TAlignment>& queries, Array<unsigned int, TResultAllocator, TResultAlignment>& results,
+                     bool multithreaded = false) const;
+
+        //	Replaces results with the k closest points, closest first. Gives fewer when the tree has less than k points.
+        template <typename TAllocator, unsigned int TAlignment>
+        void KNearest(const Vector3<float>& point, unsigned int k, Array<Neighbour, TAllocator, TAlignment>& results) const;
+
+        //	Replaces results with every point whose distance is at most radius, in no particular order.
+        template <typename TAllocator, unsigned int TAlignment>
+        void Radius(const Vector3<float>& point, float radius, Array<unsigned int, TAllocator, TAlignment>& results) const;
+
+        //	Replaces results with every point inside the box, both corners included, in no particular order.
+        template <typename TAllocator, unsigned int TAlignment>
+        void Box(const Vector3<float>& minimum, const Vector3<float>& maximum, Array<unsigned int, TAllocator, TAlignment>& results) const;
+
+    private:
+        //	Children of node i are 2i + 1 and 2i + 2. Every node past the last inner node is a leaf.
+        struct Node
+        {
+            float Split;
+            unsigned int Axis;
+        };
+
+        //	Position and the index in the source array, 16 bytes so a leaf is a few cache lines.
+        struct Entry
+        {
+            Vector3<float> Position;
+            unsigned int Index;
+        };
+
+        //	A subtree which is still to be visited. Points of node are [Begin, End).
+        struct Pending
+        {
+            unsigned int Node;
+            unsigned int Begin;
+            unsigned int End;
+            float DistanceSquared;
+            float Offsets[3];
+        };
+
+        static constexpr float Vector3<float>::* Axes[3] = { &Vector3<float>::X, &Vector3<float>::Y, &Vector3<float>::Z };
+
+        //	Median splits halve the ranges, so the tree is 32 levels deep at most.
+        static constexpr unsigned int MaximumDepth = 32;
+
+        //	Picks the axis and the median of one node and gives the median position.
+        unsigned int SplitNode(unsigned int node, unsigned int begin, unsigned int end);
+
+        void BuildSubtree(unsigned int node, unsigned int begin, unsigned int end);
+
+        //	Calls leafFunction(begin, end) for every leaf which may hold a point within boundSquared.
+        //	leafFunction may lower boundSquared, the remaining cells are pruned with the new bound.
+        template <typename TLeafFunction>
+        void Search(const Vector3<float>& point, const float& boundSquared, TLeafFunction leafFunction) const;
+
+        static float DistanceSquared(const Vector3<float>& point, const Entry& entry);
+
+        Array<Node> Nodes;
+        Array<Entry> Entries;
+    };
+
+    inline KdTree::KdTree()
+    {
+    }
+
+    template <typename TAllocator, unsigned int TAlignment>
+    KdTree::KdTree(const Array<Vector3<float>, TAllocator, TAlignment>& points, bool multithreaded)
+    {
+        Build(points.GetSource(), points.Length(), multithreaded);
+    }
+
+    inline void KdTree::Build(const Vector3<float>* points, unsigned int count, bool multithreaded)
+    {
+        Entries.Resize(count);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Entries[i].Position = points[i];
+            Entries[i].Index = i;
+        }
+
+        //	Deep enough that the largest leaf, which is the count divided by 2^depth rounded up, fits in LeafSize.
+        unsigned int depth = 0;
+        while (depth < MaximumDepth && ((static_cast<unsigned long long>(count) + (1ull << depth) - 1) >> depth) > LeafSize)
+        {
+            depth++;
+        }
+        Nodes.Resize(static_cast<unsigned int>((1ull << depth) - 1));
+
+        if (!multithreaded)
+        {
+            BuildSubtree(0, 0, count);
+            return;
+        }
+
+        //	Splits the top levels on this thread until there are enough subtrees to keep every worker busy.
+        Array<Pending> subtrees;
+        subtrees.Add(Pending{ 0, 0, count, 0.0f, { 0.0f, 0.0f, 0.0f } });
+        while (subtrees.Length() < Parallel::WorkerCount() * 2 && subtrees[0].Node < Nodes.Length() &&
+               subtrees[0].End - subtrees[0].Begin > MultithreadedSubtreeLength)
+        {
+            Array<Pending> children;
+            for (const Pending& subtree : subtrees)
+            {
+                const unsigned int middle = SplitNode(subtree.Node, subtree.Begin, subtree.End);
+                children.Add(Pending{ subtree.Node * 2 + 1, subtree.Begin, middle, 0.0f, { 0.0f, 0.0f, 0.0f } });
+                children.Add(Pending{ subtree.Node * 2 + 2, middle, subtree.End, 0.0f, { 0.0f, 0.0f, 0.0f } });
+            }
+            subtrees = std::move(children);
+        }
+
+        Parallel::For(subtrees.Length(), 1, [this, &subtrees](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                BuildSubtree(subtrees[i].Node, subtrees[i].Begin, subtrees[i].End);
+            }
+        });
+    }
+
+    template <typename TAllocator, unsigned int TAlignment>
+    void KdTree::Build(const Array<Vector3<float>, TAllocator, TAlignment>& points, bool multithreaded)
+    {
+        Build(points.GetSource(), points.Length(), multithreaded);
+    }
+
+    inline unsigned int KdTree::Length() const
+    {
+        return Entries.Length();
+    }
+
+    inline unsigned int KdTree::Nearest(const Vector3<float>& point) const
+    {
+        if (Entries.Length() == 0)
+        {
+            throw "Out of Range";
+        }
+
+        float bestDistanceSquared = FLT_MAX;
+        unsigned int best = 0;
+        Search(point, bestDistanceSquared, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; i++)
+            {
+                const float distanceSquared = DistanceSquared(point, Entries[i]);
+                if (distanceSquared < bestDistanceSquared)
+                {
+                    bestDistanceSquared = distanceSquared;
+                    best = i;
+                }
+            }
+        });
+        return Entries[best].Index;
+    }
+
+    template <typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void KdTree::Nearest(const Array<Vector3<float>, TAllocator, TAlignment>& queries, Array<unsigned int, TResultAllocator, TResultAlignment>& results,
+                         bool multithreaded) const
+    {
+        results.Resize(queries.Length());
+
+        const Vector3<float>* querySource = queries.GetSource();
+        unsigned int* resultSource = results.GetSource();
+        auto function = [this, querySource, resultSource](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                resultSource[i] = Nearest(querySource[i]);
+            }
+        };
+
+        if (multithreaded)
+        {
+            Parallel::For(queries.Length(), Parallel::DefaultChunkLength, function);
+        }
+        else if (queries.Length() != 0)
+        {
+            function(0u, queries.Length());
+        }
+    }
+
+    template <typename TAllocator, unsigned int TAlignment>
+    void KdTree::KNearest(const Vector3<float>& point, unsigned int k, Array<Neighbour, TAllocator, TAlignment>& results) const
+    {
+        results.RemoveAll();
+        if (k == 0 || Entries.Length() == 0)
+        {
+            return;
+        }
+
+        //	results is a max heap on distance while searching, so the farthest of the k is on top.
+        const auto farther = [](const Neighbour& left, const Neighbour& right) { return left.DistanceSquared < right.DistanceSquared; };
+        results.Reserve(k < Entries.Length() ? k : Entries.Length());
+
+        float boundSquared = FLT_MAX;
+        Search(point, boundSquared, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; i++)
+            {
+                const float distanceSquared = DistanceSquared(point, Entries[i]);
+                if (results.Length() < k)
+                {
+                    results.Add(Neighbour{ Entries[i].Index, distanceSquared });
+                    std::push_heap(results.begin(), results.end(), farther);
+                }
+                else if (distanceSquared < results[0].DistanceSquared)
+                {
+                    std::pop_heap(results.begin(), results.end(), farther);
+                    results[results.Length() - 1] = Neighbour{ Entries[i].Index, distanceSquared };
+                    std::push_heap(results.begin(), results.end(), farther);
+                }
+            }
+
+            if (results.Length() == k)
+            {
+                boundSquared = results[0].DistanceSquared;
+            }
+        });
+
+        std::sort_heap(results.begin(), results.end(), farther);
+    }
+
+    template <typename TAllocator, unsigned int TAlignment>
+    void KdTree::Radius(const Vector3<float>& point, float radius, Array<unsigned int, TAllocator, TAlignment>& results) const
+    {
+        results.RemoveAll();
+        const float radiusSquared = radius * radius;
+        Search(point, radiusSquared, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; i++)
+            {
+                if (DistanceSquared(point, Entries[i]) <= radiusSquared)
+                {
+                    results.Add(Entries[i].Index);
+                }
+            }
+        });
+    }
+
+    template <typename TAllocator, unsigned int TAlignment>
+    void KdTree::Box(const Vector3<float>& minimum, const Vector3<float>& maximum, Array<unsigned int, TAllocator, TAlignment>& results) const
+    {
+        results.RemoveAll();
+
+        Pending stack[MaximumDepth + 1];
+        unsigned int stackLength = 0;
+        stack[stackLength++] = Pending{ 0, 0, Entries.Length(), 0.0f, { 0.0f, 0.0f, 0.0f } };
+
+        while (stackLength != 0)
+        {
+            const Pending current = stack[--stackLength];
+            if (current.Node >= Nodes.Length())
+            {
+                for (unsigned int i = current.Begin; i < current.End; i++)
+                {
+                    const Vector3<float>& position = Entries[i].Position;
+                    if (position.X >= minimum.X && position.Y >= minimum.Y && position.Z >= minimum.Z &&
+                        position.X <= maximum.X && position.Y <= maximum.Y && position.Z <= maximum.Z)
+                    {
+                        results.Add(Entries[i].Index);
+                    }
+                }
+                continue;
+            }
+
+            //	Left points are at most Split and right points are at least Split on the node axis.
+            const Node& node = Nodes[current.Node];
+            const unsigned int middle = (current.Begin + current.End) / 2;
+            if (maximum.*Axes[node.Axis] >= node.Split)
+            {
+                stack[stackLength++] = Pending{ current.Node * 2 + 2, middle, current.End, 0.0f, { 0.0f, 0.0f, 0.0f } };
+            }
+            if (minimum.*Axes[node.Axis] <= node.Split)
+            {
+                stack[stackLength++] = Pending{ current.Node * 2 + 1, current.Begin, middle, 0.0f, { 0.0f, 0.0f, 0.0f } };
+            }
+        }
+    }
+
+    inline unsigned int KdTree::SplitNode(unsigned int node, unsigned int begin, unsigned int end)
+    {
+        Vector3<float> lower(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vector3<float> upper(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (unsigned int i = begin; i < end; i++)
+        {
+            const Vector3<float>& position = Entries[i].Position;
+            lower = Vector3<float>(position.X < lower.X ? position.X : lower.X, position.Y < lower.Y ? position.Y : lower.Y, position.Z < lower.Z ? position.Z : lower.Z);
+            upper = Vector3<float>(position.X > upper.X ? position.X : upper.X, position.Y > upper.Y ? position.Y : upper.Y, position.Z > upper.Z ? position.Z : upper.Z);
+        }
+
+        const Vector3<float> extent = upper - lower;
+        const unsigned int axis = extent.X >= extent.Y && extent.X >= extent.Z ? 0 : (extent.Y >= extent.Z ? 1 : 2);
+
+        const unsigned int middle = (begin + end) / 2;
+        std::nth_element(Entries.begin() + begin, Entries.begin() + middle, Entries.begin() + end, [axis](const Entry& left, const Entry& right)
+        {
+            return left.Position.*Axes[axis] < right.Position.*Axes[axis];
+        });
+
+        Nodes[node] = Node{ Entries[middle].Position.*Axes[axis], axis };
+        return middle;
+    }
+
+    inline void KdTree::BuildSubtree(unsigned int node, unsigned int begin, unsigned int end)
+    {
+        if (node >= Nodes.Length())
+        {
+            return;
+        }
+
+        const unsigned int middle = SplitNode(node, begin, end);
+        BuildSubtree(node * 2 + 1, begin, middle);
+        BuildSubtree(node * 2 + 2, middle, end);
+    }
+
+    template <typename TLeafFunction>
+    void KdTree::Search(const Vector3<float>& point, const float& boundSquared, TLeafFunction leafFunction) const
+    {
+        //	Only the far children wait on the stack, one per level at most.
+        Pending stack[MaximumDepth + 1];
+        unsigned int stackLength = 0;
+        stack[stackLength++] = Pending{ 0, 0, Entries.Length(), 0.0f, { 0.0f, 0.0f, 0.0f } };
+
+        while (stackLength != 0)
+        {
+            Pending current = stack[--stackLength];
+            if (current.DistanceSquared > boundSquared)
+            {
+                continue;
+            }
+
+            //	Goes down to the leaf of the point. The far cell is as far as the old offset on this axis
+            //	is replaced with the distance to the split plane.
+            while (current.Node < Nodes.Length())
+            {
+                const Node& node = Nodes[current.Node];
+                const unsigned int middle = (current.Begin + current.End) / 2;
+                const float offset = point.*Axes[node.Axis] - node.Split;
+
+                Pending farChild = current;
+                if (offset < 0.0f)
+                {
+                    current.Node = current.Node * 2 + 1;
+                    current.End = middle;
+                    farChild.Node = farChild.Node * 2 + 2;
+                    farChild.Begin = middle;
+                }
+                else
+                {
+                    current.Node = current.Node * 2 + 2;
+                    current.Begin = middle;
+                    farChild.Node = farChild.Node * 2 + 1;
+                    farChild.End = middle;
+                }
+
+                farChild.DistanceSquared += offset * offset - farChild.Offsets[node.Axis] * farChild.Offsets[node.Axis];
+                farChild.Offsets[node.Axis] = offset;
+                if (farChild.DistanceSquared <= boundSquared)
+                {
+                    stack[stackLength++] = farChild;
+                }
+            }
+
+            leafFunction(current.Begin, current.End);
+        }
+    }
+
+    inline float KdTree::DistanceSquared(const Vector3<float>& point, const Entry& entry)
+    {
+        const float xDifference = entry.Position.X - point.X;
+        const float yDifference = entry.Position.Y - point.Y;
+        const float zDifference = entry.Position.Z - point.Z;
+        return xDifference * xDifference + yDifference * yDifference + zDifference * zDifference;
+    }
+}
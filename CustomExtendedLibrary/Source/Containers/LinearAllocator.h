@@ -0,0 +1,107 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Linear (Frame) allocator which hands out memory by bumping an offset inside one block.
+ *
+ *  Current capabilities:
+ *  -   Allocate is only an aligned pointer bump, Deallocate only gives back the latest allocation.
+ *  -   Reset releases every allocation of the frame at once.
+ *  -   Get. (Returns the thread local frame allocator of the calling thread)
+ *
+ *  Containers which use this allocator must not be touched after Reset.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/Types.h"
+
+#include <new>
+
+namespace Engine
+{
+    class LinearAllocator
+    {
+    public:
+        static constexpr uint64 DefaultCapacity = 4 * 1024 * 1024;
+
+        LinearAllocator();
+        explicit LinearAllocator(uint64 blockCapacity);
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+        ~LinearAllocator();
+
+        void* Allocate(uint64 size, uint64 alignment);
+        void Deallocate(void* memory, uint64 size, uint64 alignment);
+        void Reset();
+
+        uint64 Capacity() const;
+        uint64 UsedSize() const;
+
+        static LinearAllocator& Get();
+
+    private:
+        byte* Memory;
+        uint64 capacity;
+        uint64 offset = 0;
+    };
+
+    inline LinearAllocator::LinearAllocator() : LinearAllocator(DefaultCapacity)
+    {
+    }
+
+    inline LinearAllocator::LinearAllocator(uint64 blockCapacity) : capacity(blockCapacity)
+    {
+        Memory = static_cast<byte*>(::operator new(capacity));
+    }
+
+    inline LinearAllocator::~LinearAllocator()
+    {
+        ::operator delete(Memory);
+    }
+
+    inline void* LinearAllocator::Allocate(uint64 size, uint64 alignment)
+    {
+        const uint64 address = reinterpret_cast<uint64>(Memory) + offset;
+        const uint64 alignedOffset = offset + ((alignment - address % alignment) % alignment);
+
+        if (alignedOffset + size > capacity)
+        {
+            throw "Out of Memory";
+        }
+
+        offset = alignedOffset + size;
+        return Memory + alignedOffset;
+    }
+
+    inline void LinearAllocator::Deallocate(void* memory, uint64 size, uint64 /*alignment*/)
+    {
+        //	Only the top allocation can be given back, the rest is released by Reset.
+        if (static_cast<byte*>(memory) + size == Memory + offset)
+        {
+            offset -= size;
+        }
+    }
+
+    inline void LinearAllocator::Reset()
+    {
+        offset = 0;
+    }
+
+    inline uint64 LinearAllocator::Capacity() const
+    {
+        return capacity;
+    }
+
+    inline uint64 LinearAllocator::UsedSize() const
+    {
+        return offset;
+    }
+
+    inline LinearAllocator& LinearAllocator::Get()
+    {
+        thread_local LinearAllocator instance;
+        return instance;
+    }
+}
@@ -0,0 +1,506 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Parallel algorithms library which splits a contiguous container across the cores.
+ *
+ *  Current capabilities:
+ *  -   For. (Runs a function over [0, count) in chunks, one chunk per worker thread. Its [begin, end) form
+ *      takes a multithreaded flag and runs on the calling thread without it, which is what the batch libraries use)
+ *  -   Persistent worker pool. (Started on the first parallel call, chunks go through one task queue,
+ *      so frame to frame batches do not create or join threads)
+ *  -   Sort, ForEach, Transform, Reduce, Find over anything with contiguous begin/end. (Array, SmallArray)
+ *  -   Small inputs run on the calling thread, so there is no thread overhead for them.
+ *  -   ForEach and Transform split on cache line boundaries, so threads never write into the same line
+ *      as long as the container is aligned to CacheLineSize. (Array<T, TAllocator, Parallel::CacheLineSize>)
+ *
+ *  Reduce expects an associative operation, the partial results are combined in chunk order.
+ *  Accumulators of another type than the element (counting into an int, summing into a struct) use the Reduce
+ *  with an identity, a fold and a combine.
+ *  A thread which waits for its chunks runs queued chunks meanwhile, so For can be called from inside a chunk.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+    class Parallel
+    {
+    public:
+        Parallel() = delete;
+        ~Parallel() = delete;
+
+        static constexpr unsigned int DefaultChunkLength = 4096;
+        static constexpr unsigned int CacheLineSize = 64;
+
+        //	Gives the count of worker threads which is the count of hardware threads.
+        static unsigned int WorkerCount();
+
+        //	Calls function(chunkBegin, chunkEnd) for disjoint chunks of [0, count) on different threads.
+        template <typename TFunction>
+        static void For(unsigned int count, unsigned int minimumChunkLength, TFunction function);
+
+        //	Same as For, but every chunk boundary is a multiple of chunkGranularity.
+        template <typename TFunction>
+        static void For(unsigned int count, unsigned int minimumChunkLength, unsigned int chunkGranularity, TFunction function);
+
+        //	Calls function(chunkBegin, chunkEnd) for [begin, end), through For when multithreaded, otherwise once on
+        //	the calling thread. Chunk boundaries are begin plus a multiple of chunkGranularity.
+        template <typename TFunction>
+        static void For(unsigned int begin, unsigned int end, unsigned int minimumChunkLength, unsigned int chunkGranularity, bool multithreaded,
+                        TFunction function);
+
+        //	Gives how many elements of TElement fill one cache line, to use as chunkGranularity.
+        template <typename TElement>
+        static constexpr unsigned int CacheLineGranularity();
+
+        //	Sorts each chunk on its own thread, then merges the chunks pairwise in parallel.
+        template <typename TContainer, typename TCompare = std::less<>>
+        static void Sort(TContainer& container, TCompare compare = TCompare());
+
+        //	Calls function(element) for every element.
+        template <typename TContainer, typename TFunction>
+        static void ForEach(TContainer& container, TFunction function);
+
+        //	Writes function(source[i]) to destination[i], destination is resized to the length of source.
+        template <typename TSource, typename TDestination, typename TFunction>
+        static void Transform(const TSource& source, TDestination& destination, TFunction function);
+
+        //	Folds every element into initialValue with the associative operation, operation(TValue, element).
+        //	Only the first chunk starts from initialValue, the others start from their first element and their
+        //	results are combined with operation(TValue, TValue), so elements have to convert to TValue.
+        template <typename TContainer, typename TValue, typename TOperation>
+        static TValue Reduce(const TContainer& container, TValue initialValue, TOperation operation);
+
+        //	Every chunk starts from identity and folds its elements with fold(TValue, element), the chunk results
+        //	are joined in chunk order with combine(TValue, TValue). identity has to leave both unchanged.
+        template <typename TContainer, typename TValue, typename TFold, typename TCombine>
+        static TValue Reduce(const TContainer& container, TValue identity, TFold fold, TCombine combine);
+
+        //	Gives the first element which satisfies the predicate, or end() when there is none.
+        template <typename TContainer, typename TPredicate>
+        static auto Find(TContainer& container, TPredicate predicate) -> decltype(container.begin());
+
+    private:
+        //	One chunk of a For call. Function is the caller's function object behind a type erased call,
+        //	Remaining belongs to the For call and counts its chunks which are not finished yet.
+        struct Task
+        {
+            void (*Call)(void* function, unsigned int chunkBegin, unsigned int chunkEnd);
+            void* Function;
+            unsigned int ChunkBegin;
+            unsigned int ChunkEnd;
+            unsigned int* Remaining;
+        };
+
+        //	WorkerCount() - 1 threads, the calling thread is the last worker of every For.
+        //	Everything is guarded by one mutex, there are only as many tasks as workers per For.
+        class Pool
+        {
+        public:
+            Pool();
+            ~Pool();
+
+            //	Counts the task in its Remaining and queues it.
+            void Push(const Task& task);
+
+            //	Runs queued tasks until remaining reaches zero, sleeps when the queue is empty.
+            void Wait(unsigned int& remaining);
+
+        private:
+            void WorkerLoop();
+            void Run(std::unique_lock<std::mutex>& lock);
+
+            std::vector<std::thread> Workers;
+            std::deque<Task> Tasks;
+            std::mutex Mutex;
+            std::condition_variable TaskAdded;
+            std::condition_variable TaskFinished;
+            bool Stopping;
+        };
+
+        static Pool& GetPool();
+
+        static unsigned int ChunkCount(unsigned int count, unsigned int minimumChunkLength);
+        static unsigned int ChunkBound(unsigned int count, unsigned int chunk, unsigned int chunkCount, unsigned int chunkGranularity);
+    };
+
+    inline unsigned int Parallel::WorkerCount()
+    {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads ? hardwareThreads : 1;
+    }
+
+    inline Parallel::Pool::Pool() : Stopping(false)
+    {
+        const unsigned int workerCount = WorkerCount() - 1;
+        Workers.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; i++)
+        {
+            Workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    inline Parallel::Pool::~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Stopping = true;
+        }
+        TaskAdded.notify_all();
+
+        for (std::thread& worker : Workers)
+        {
+            worker.join();
+        }
+    }
+
+    inline void Parallel::Pool::Push(const Task& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            ++*task.Remaining;
+            Tasks.push_back(task);
+        }
+        TaskAdded.notify_one();
+    }
+
+    inline void Parallel::Pool::Wait(unsigned int& remaining)
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        while (remaining != 0)
+        {
+            if (Tasks.empty())
+            {
+                TaskFinished.wait(lock);
+                continue;
+            }
+            Run(lock);
+        }
+    }
+
+    inline void Parallel::Pool::WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        while (true)
+        {
+            TaskAdded.wait(lock, [this]() { return Stopping || !Tasks.empty(); });
+            if (Tasks.empty())
+                return;
+
+            Run(lock);
+        }
+    }
+
+    //	Pops the oldest task and runs it with the mutex released. lock is held again on return.
+    inline void Parallel::Pool::Run(std::unique_lock<std::mutex>& lock)
+    {
+        const Task task = Tasks.front();
+        Tasks.pop_front();
+
+        lock.unlock();
+        task.Call(task.Function, task.ChunkBegin, task.ChunkEnd);
+        lock.lock();
+
+        if (--*task.Remaining == 0)
+        {
+            TaskFinished.notify_all();
+        }
+    }
+
+    inline Parallel::Pool& Parallel::GetPool()
+    {
+        static Pool pool;
+        return pool;
+    }
+
+    inline unsigned int Parallel::ChunkCount(unsigned int count, unsigned int minimumChunkLength)
+    {
+        if (minimumChunkLength == 0)
+            minimumChunkLength = 1;
+
+        const unsigned int chunkCount = count / minimumChunkLength;
+        const unsigned int workerCount = WorkerCount();
+        if (chunkCount == 0)
+            return 1;
+
+        return chunkCount < workerCount ? chunkCount : workerCount;
+    }
+
+    inline unsigned int Parallel::ChunkBound(unsigned int count, unsigned int chunk, unsigned int chunkCount, unsigned int chunkGranularity)
+    {
+        if (chunk >= chunkCount)
+            return count;
+
+        const unsigned int bound = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / chunkCount);
+        return bound / chunkGranularity * chunkGranularity;
+    }
+
+    template <typename TElement>
+    constexpr unsigned int Parallel::CacheLineGranularity()
+    {
+        return sizeof(TElement) < CacheLineSize ? CacheLineSize / sizeof(TElement) : 1;
+    }
+
+    template <typename TFunction>
+    void Parallel::For(unsigned int count, unsigned int minimumChunkLength, TFunction function)
+    {
+        For(count, minimumChunkLength, 1, function);
+    }
+
+    template <typename TFunction>
+    void Parallel::For(unsigned int count, unsigned int minimumChunkLength, unsigned int chunkGranularity, TFunction function)
+    {
+        if (count == 0)
+            return;
+
+        if (chunkGranularity == 0)
+            chunkGranularity = 1;
+
+        const unsigned int chunkCount = ChunkCount(count, minimumChunkLength);
+        if (chunkCount == 1)
+        {
+            function(0u, count);
+            return;
+        }
+
+        Pool& pool = GetPool();
+        const auto call = [](void* function, unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            (*static_cast<TFunction*>(function))(chunkBegin, chunkEnd);
+        };
+
+        //	Only read and written under the pool mutex.
+        unsigned int remaining = 0;
+
+        //	The caller runs the last chunk itself instead of waiting idle.
+        for (unsigned int chunk = 0; chunk < chunkCount - 1; chunk++)
+        {
+            const unsigned int chunkBegin = ChunkBound(count, chunk, chunkCount, chunkGranularity);
+            const unsigned int chunkEnd = ChunkBound(count, chunk + 1, chunkCount, chunkGranularity);
+            if (chunkBegin == chunkEnd)
+                continue;
+
+            pool.Push(Task{call, &function, chunkBegin, chunkEnd, &remaining});
+        }
+
+        const unsigned int lastChunkBegin = ChunkBound(count, chunkCount - 1, chunkCount, chunkGranularity);
+        if (lastChunkBegin != count)
+        {
+            function(lastChunkBegin, count);
+        }
+
+        pool.Wait(remaining);
+    }
+
+    template <typename TFunction>
+    void Parallel::For(unsigned int begin, unsigned int end, unsigned int minimumChunkLength, unsigned int chunkGranularity, bool multithreaded,
+                       TFunction function)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        if (!multithreaded)
+        {
+            function(begin, end);
+            return;
+        }
+
+        For(end - begin, minimumChunkLength, chunkGranularity, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            function(begin + chunkBegin, begin + chunkEnd);
+        });
+    }
+
+    template <typename TContainer, typename TCompare>
+    void Parallel::Sort(TContainer& container, TCompare compare)
+    {
+        auto first = container.begin();
+        const unsigned int count = static_cast<unsigned int>(container.end() - first);
+
+        const unsigned int chunkCount = ChunkCount(count, DefaultChunkLength);
+        if (chunkCount == 1)
+        {
+            std::sort(first, container.end(), compare);
+            return;
+        }
+
+        std::vector<unsigned int> bounds(chunkCount + 1);
+        for (unsigned int chunk = 0; chunk <= chunkCount; chunk++)
+        {
+            bounds[chunk] = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / chunkCount);
+        }
+
+        For(chunkCount, 1, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int chunk = chunkBegin; chunk < chunkEnd; chunk++)
+            {
+                std::sort(first + bounds[chunk], first + bounds[chunk + 1], compare);
+            }
+        });
+
+        //	Every round merges neighbour runs, halving the run count until one sorted run is left.
+        for (unsigned int width = 1; width < chunkCount; width *= 2)
+        {
+            const unsigned int mergeCount = (chunkCount + 2 * width - 1) / (2 * width);
+            For(mergeCount, 1, [&](unsigned int mergeBegin, unsigned int mergeEnd)
+            {
+                for (unsigned int merge = mergeBegin; merge < mergeEnd; merge++)
+                {
+                    const unsigned int left = merge * 2 * width;
+                    const unsigned int middle = left + width;
+                    if (middle >= chunkCount)
+                        continue;
+
+                    const unsigned int right = middle + width < chunkCount ? middle + width : chunkCount;
+                    std::inplace_merge(first + bounds[left], first + bounds[middle], first + bounds[right], compare);
+                }
+            });
+        }
+    }
+
+    template <typename TContainer, typename TFunction>
+    void Parallel::ForEach(TContainer& container, TFunction function)
+    {
+        auto first = container.begin();
+        const unsigned int count = static_cast<unsigned int>(container.end() - first);
+        const unsigned int granularity = CacheLineGranularity<std::remove_reference_t<decltype(*first)>>();
+
+        For(count, DefaultChunkLength, granularity, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                function(first[i]);
+            }
+        });
+    }
+
+    template <typename TSource, typename TDestination, typename TFunction>
+    void Parallel::Transform(const TSource& source, TDestination& destination, TFunction function)
+    {
+        auto sourceFirst = source.begin();
+        const unsigned int count = static_cast<unsigned int>(source.end() - sourceFirst);
+
+        destination.Resize(count);
+        auto destinationFirst = destination.begin();
+        const unsigned int granularity = CacheLineGranularity<std::remove_reference_t<decltype(*destinationFirst)>>();
+
+        For(count, DefaultChunkLength, granularity, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                destinationFirst[i] = function(sourceFirst[i]);
+            }
+        });
+    }
+
+    template <typename TContainer, typename TValue, typename TOperation>
+    TValue Parallel::Reduce(const TContainer& container, TValue initialValue, TOperation operation)
+    {
+        auto first = container.begin();
+        const unsigned int count = static_cast<unsigned int>(container.end() - first);
+        if (count == 0)
+            return initialValue;
+
+        const unsigned int chunkCount = ChunkCount(count, DefaultChunkLength);
+        std::vector<TValue> partials(chunkCount, initialValue);
+
+        For(chunkCount, 1, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int chunk = chunkBegin; chunk < chunkEnd; chunk++)
+            {
+                unsigned int elementBegin = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / chunkCount);
+                const unsigned int elementEnd = static_cast<unsigned int>(static_cast<unsigned long long>(count) * (chunk + 1) / chunkCount);
+
+                //	partials[0] already holds initialValue, the other chunks have no identity to start from.
+                TValue partial = chunk == 0 ? partials[0] : static_cast<TValue>(first[elementBegin++]);
+                for (unsigned int i = elementBegin; i < elementEnd; i++)
+                {
+                    partial = operation(partial, first[i]);
+                }
+                partials[chunk] = partial;
+            }
+        });
+
+        TValue result = partials[0];
+        for (unsigned int chunk = 1; chunk < chunkCount; chunk++)
+        {
+            result = operation(result, partials[chunk]);
+        }
+        return result;
+    }
+
+    template <typename TContainer, typename TValue, typename TFold, typename TCombine>
+    TValue Parallel::Reduce(const TContainer& container, TValue identity, TFold fold, TCombine combine)
+    {
+        auto first = container.begin();
+        const unsigned int count = static_cast<unsigned int>(container.end() - first);
+        if (count == 0)
+            return identity;
+
+        const unsigned int chunkCount = ChunkCount(count, DefaultChunkLength);
+        std::vector<TValue> partials(chunkCount, identity);
+
+        For(chunkCount, 1, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int chunk = chunkBegin; chunk < chunkEnd; chunk++)
+            {
+                const unsigned int elementBegin = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / chunkCount);
+                const unsigned int elementEnd = static_cast<unsigned int>(static_cast<unsigned long long>(count) * (chunk + 1) / chunkCount);
+
+                TValue partial = identity;
+                for (unsigned int i = elementBegin; i < elementEnd; i++)
+                {
+                    partial = fold(partial, first[i]);
+                }
+                partials[chunk] = partial;
+            }
+        });
+
+        TValue result = partials[0];
+        for (unsigned int chunk = 1; chunk < chunkCount; chunk++)
+        {
+            result = combine(result, partials[chunk]);
+        }
+        return result;
+    }
+
+    template <typename TContainer, typename TPredicate>
+    auto Parallel::Find(TContainer& container, TPredicate predicate) -> decltype(container.begin())
+    {
+        auto first = container.begin();
+        const unsigned int count = static_cast<unsigned int>(container.end() - first);
+
+        //	Chunks stop early once an earlier index has been found by any thread.
+        std::atomic<unsigned int> foundIndex(count);
+        For(count, DefaultChunkLength, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd && i < foundIndex.load(std::memory_order_relaxed); i++)
+            {
+                if (predicate(first[i]))
+                {
+                    unsigned int current = foundIndex.load(std::memory_order_relaxed);
+                    while (i < current && !foundIndex.compare_exchange_weak(current, i, std::memory_order_relaxed))
+                    {
+                    }
+                    return;
+                }
+            }
+        });
+
+        return first + foundIndex.load();
+    }
+}
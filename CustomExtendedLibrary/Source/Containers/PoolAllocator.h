@@ -0,0 +1,141 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a fixed-block Pool allocator which hands out equally sized blocks from one slab.
+ *
+ *  Current capabilities:
+ *  -   Allocate and Deallocate are a free list pop and push.
+ *  -   Requests bigger than a block, or made when the pool is empty, fall back to the heap.
+ *  -   Reset puts every block back into the free list at once.
+ *  -   Get. (Returns the thread local pool of the calling thread)
+ *
+ *  Containers which use this allocator must not be touched after Reset.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/HeapAllocator.h"
+#include "Core/Types.h"
+
+#include <new>
+
+namespace Engine
+{
+    class PoolAllocator
+    {
+    public:
+        static constexpr uint64 DefaultBlockSize = 256;
+        static constexpr uint64 DefaultBlockCount = 4096;
+        static constexpr uint64 BlockAlignment = 16;
+
+        PoolAllocator();
+        PoolAllocator(uint64 blockSize, uint64 blockCount);
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+        ~PoolAllocator();
+
+        void* Allocate(uint64 size, uint64 alignment);
+        void Deallocate(void* memory, uint64 size, uint64 alignment);
+        void Reset();
+
+        uint64 BlockSize() const;
+        uint64 FreeBlockCount() const;
+
+        static PoolAllocator& Get();
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* Next;
+        };
+
+        byte* Memory;
+        FreeBlock* FreeList = nullptr;
+        uint64 blockSize;
+        uint64 blockCount;
+        uint64 freeBlockCount = 0;
+
+        bool Owns(void* memory) const;
+    };
+
+    inline PoolAllocator::PoolAllocator() : PoolAllocator(DefaultBlockSize, DefaultBlockCount)
+    {
+    }
+
+    inline PoolAllocator::PoolAllocator(uint64 size, uint64 count) : blockCount(count)
+    {
+        //	Every block has to hold the free list link and keep the following blocks aligned.
+        blockSize = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+        blockSize = (blockSize + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+
+        Memory = static_cast<byte*>(::operator new(blockSize * blockCount, std::align_val_t(BlockAlignment)));
+        Reset();
+    }
+
+    inline PoolAllocator::~PoolAllocator()
+    {
+        ::operator delete(Memory, std::align_val_t(BlockAlignment));
+    }
+
+    inline void* PoolAllocator::Allocate(uint64 size, uint64 alignment)
+    {
+        if (size > blockSize || alignment > BlockAlignment || FreeList == nullptr)
+        {
+            return HeapAllocator::Get().Allocate(size, alignment);
+        }
+
+        FreeBlock* block = FreeList;
+        FreeList = block->Next;
+        freeBlockCount--;
+        return block;
+    }
+
+    inline void PoolAllocator::Deallocate(void* memory, uint64 size, uint64 alignment)
+    {
+        if (!Owns(memory))
+        {
+            HeapAllocator::Get().Deallocate(memory, size, alignment);
+            return;
+        }
+
+        FreeBlock* block = static_cast<FreeBlock*>(memory);
+        block->Next = FreeList;
+        FreeList = block;
+        freeBlockCount++;
+    }
+
+    inline void PoolAllocator::Reset()
+    {
+        FreeList = nullptr;
+        for (uint64 i = blockCount; i > 0; i--)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(Memory + (i - 1) * blockSize);
+            block->Next = FreeList;
+            FreeList = block;
+        }
+        freeBlockCount = blockCount;
+    }
+
+    inline uint64 PoolAllocator::BlockSize() const
+    {
+        return blockSize;
+    }
+
+    inline uint64 PoolAllocator::FreeBlockCount() const
+    {
+        return freeBlockCount;
+    }
+
+    inline PoolAllocator& PoolAllocator::Get()
+    {
+        thread_local PoolAllocator instance;
+        return instance;
+    }
+
+    inline bool PoolAllocator::Owns(void* memory) const
+    {
+        return static_cast<byte*>(memory) >= Memory && static_cast<byte*>(memory) < Memory + blockSize * blockCount;
+    }
+}
@@ -0,0 +1,598 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Dynamic Array with inline storage for the first N elements, to use instead of Array on hot paths.
+ *
+ *  Current capabilities:
+ *  -   Same functions as Array, so one can be swapped for the other.
+ *  -   Up to N elements live inside the object itself and never touch the allocator.
+ *  -   Spills to the allocator only when it grows beyond N, ShrinkToFit moves back inline when it fits.
+ *  -   Inline and spilled storage are aligned to alignof(T) or to the explicit TAlignment, whichever is bigger.
+ *  -   AppendRange, InsertRange, RemoveRange and RemoveIf with at most one reallocation.
+ *  -   Contiguous iterators (begin/end), so it works with <algorithm> and Containers/Parallel.h.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/ContainerMemory.h"
+#include "Containers/HeapAllocator.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Engine
+{
+    template <typename T, unsigned int N, typename TAllocator = HeapAllocator, unsigned int TAlignment = alignof(T)>
+    class SmallArray
+    {
+        static_assert(N > 0, "SmallArray needs at least one inline element, use Array instead.");
+        static_assert((TAlignment & (TAlignment - 1)) == 0, "SmallArray alignment has to be a power of two.");
+
+    public:
+        //	Alignment of the inline storage and of the spilled block, never less than alignof(T).
+        static constexpr unsigned int Alignment = TAlignment > alignof(T) ? TAlignment : alignof(T);
+
+        using Iterator = T*;
+        using ConstIterator = const T*;
+
+        SmallArray();
+        explicit SmallArray(TAllocator& allocator);
+        SmallArray(const SmallArray& other);
+        SmallArray(SmallArray&& other) noexcept;
+        ~SmallArray();
+
+        SmallArray& operator=(const SmallArray& other);
+        SmallArray& operator=(SmallArray&& other) noexcept;
+
+        void Init(unsigned int initSize);
+        T* GetSource() { return ArrayPtr; }
+        const T* GetSource() const { return ArrayPtr; }
+        TAllocator& GetAllocator() const { return *Allocator; }
+
+        unsigned int Length() const;
+        unsigned int Size() const;
+        unsigned int MaxLength() const;
+        bool IsInline() const;
+
+        T& At(unsigned int index);
+        const T& At(unsigned int index) const;
+        T& operator[](const unsigned index);
+        const T& operator[](const unsigned index) const;
+
+        Iterator begin() { return ArrayPtr; }
+        Iterator end() { return ArrayPtr + currentLength; }
+        ConstIterator begin() const { return ArrayPtr; }
+        ConstIterator end() const { return ArrayPtr + currentLength; }
+        ConstIterator cbegin() const { return ArrayPtr; }
+        ConstIterator cend() const { return ArrayPtr + currentLength; }
+
+        void Add(const T& element);
+        void Add(T&& element);
+        void InsertFirst(const T& element);
+        void InsertByIndex(const T& element, unsigned index);
+        void RemoveFirst();
+        void Remove(const unsigned index);
+        void RemoveSwap(const unsigned index);
+        void RemoveAll();
+
+        void AppendRange(const T* elements, unsigned int count);
+        void InsertRange(unsigned index, const T* elements, unsigned int count);
+        void RemoveRange(unsigned index, unsigned int count);
+
+        template <typename TPredicate>
+        unsigned int RemoveIf(TPredicate predicate);
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args);
+
+        template <typename... Args>
+        T& Emplace(unsigned index, Args&&... args);
+
+        void Reserve(unsigned int newMaximumLength);
+        void Resize(unsigned int newLength);
+        void ShrinkToFit();
+
+        void Swap(const unsigned& swapItemIndex1, const unsigned& swapItemIndex2);
+    private:
+
+        unsigned int maximumLength = N;
+        unsigned int currentLength = 0;
+        T* ArrayPtr;
+        TAllocator* Allocator;
+
+        alignas(Alignment) unsigned char InlineStorage[sizeof(T) * N];
+
+        void Relocate(unsigned int newMaximumLength);
+        unsigned int GrownLength() const;
+        unsigned int GrownLength(unsigned int requiredLength) const;
+        bool Contains(const T* element) const;
+        void ClearMemory();
+        void StealFrom(SmallArray& other);
+
+        T* InlineElements();
+        T* AllocateMemory(unsigned int length);
+        void FreeMemory(T* memory, unsigned int length);
+    };
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>::SmallArray() : ArrayPtr(InlineElements()), Allocator(&TAllocator::Get())
+    {
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>::SmallArray(TAllocator& allocator) : ArrayPtr(InlineElements()), Allocator(&allocator)
+    {
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>::SmallArray(const SmallArray& other) : ArrayPtr(InlineElements()), Allocator(other.Allocator)
+    {
+        Reserve(other.currentLength);
+        ContainerMemory::CopyConstructElements(ArrayPtr, other.ArrayPtr, other.currentLength);
+        currentLength = other.currentLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>::SmallArray(SmallArray&& other) noexcept : ArrayPtr(InlineElements()), Allocator(other.Allocator)
+    {
+        StealFrom(other);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>::~SmallArray()
+    {
+        ClearMemory();
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>& SmallArray<T, N, TAllocator, TAlignment>::operator=(const SmallArray& other)
+    {
+        if (this != &other)
+        {
+            SmallArray temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    SmallArray<T, N, TAllocator, TAlignment>& SmallArray<T, N, TAllocator, TAlignment>::operator=(SmallArray&& other) noexcept
+    {
+        if (this != &other)
+        {
+            RemoveAll();
+            Allocator = other.Allocator;
+            StealFrom(other);
+        }
+        return *this;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Init(unsigned initSize)
+    {
+        Reserve(initSize);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    unsigned SmallArray<T, N, TAllocator, TAlignment>::Length() const
+    {
+        return currentLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    unsigned SmallArray<T, N, TAllocator, TAlignment>::Size() const
+    {
+        return sizeof(T) * currentLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    unsigned SmallArray<T, N, TAllocator, TAlignment>::MaxLength() const
+    {
+        return maximumLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    bool SmallArray<T, N, TAllocator, TAlignment>::IsInline() const
+    {
+        return ArrayPtr == reinterpret_cast<const T*>(InlineStorage);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    T& SmallArray<T, N, TAllocator, TAlignment>::At(unsigned index)
+    {
+        return ArrayPtr[index];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    const T& SmallArray<T, N, TAllocator, TAlignment>::At(unsigned index) const
+    {
+        return ArrayPtr[index];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    T& SmallArray<T, N, TAllocator, TAlignment>::operator[](const unsigned index)
+    {
+        return ArrayPtr[index];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    const T& SmallArray<T, N, TAllocator, TAlignment>::operator[](const unsigned index) const
+    {
+        return ArrayPtr[index];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Add(const T& element)
+    {
+        EmplaceBack(element);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Add(T&& element)
+    {
+        EmplaceBack(std::move(element));
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::InsertFirst(const T& element)
+    {
+        InsertByIndex(element, 0);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::InsertByIndex(const T& element, unsigned index)
+    {
+        Emplace(index, element);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::AppendRange(const T* elements, unsigned int count)
+    {
+        InsertRange(currentLength, elements, count);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::InsertRange(unsigned index, const T* elements, unsigned int count)
+    {
+        if (index > currentLength)
+        {
+            throw "Out of Range";
+        }
+        if (count == 0)
+            return;
+
+        if (currentLength + count > maximumLength)
+        {
+            //	The range is copied before the old block is released, because it may point into this array.
+            const unsigned newMaximumLength = GrownLength(currentLength + count);
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            ContainerMemory::CopyConstructElements(newArrayPtr + index, elements, count);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, index);
+            ContainerMemory::RelocateElements(newArrayPtr + index + count, ArrayPtr + index, currentLength - index);
+
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else if (Contains(elements) && index < currentLength)
+        {
+            //	Opening the gap would move the range itself, so it is copied aside first.
+            SmallArray temp(*Allocator);
+            temp.AppendRange(elements, count);
+            InsertRange(index, temp.ArrayPtr, count);
+            return;
+        }
+        else
+        {
+            ContainerMemory::OpenGap(ArrayPtr, currentLength, index, count);
+            ContainerMemory::CopyConstructElements(ArrayPtr + index, elements, count);
+        }
+        currentLength += count;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::RemoveRange(unsigned index, unsigned int count)
+    {
+        if (index > currentLength || count > currentLength - index)
+        {
+            throw "Out of Range";
+        }
+
+        ContainerMemory::CloseGap(ArrayPtr, currentLength, index, count);
+        currentLength -= count;
+    }
+
+    //	Stable single pass compaction, returns how many elements were removed.
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    template <typename TPredicate>
+    unsigned int SmallArray<T, N, TAllocator, TAlignment>::RemoveIf(TPredicate predicate)
+    {
+        unsigned writeIndex = 0;
+        for (unsigned readIndex = 0; readIndex < currentLength; readIndex++)
+        {
+            if (predicate(ArrayPtr[readIndex]))
+                continue;
+
+            if (writeIndex != readIndex)
+            {
+                ArrayPtr[writeIndex] = std::move(ArrayPtr[readIndex]);
+            }
+            writeIndex++;
+        }
+
+        const unsigned removedCount = currentLength - writeIndex;
+        ContainerMemory::DestroyElements(ArrayPtr + writeIndex, removedCount);
+        currentLength = writeIndex;
+        return removedCount;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    template <typename... Args>
+    T& SmallArray<T, N, TAllocator, TAlignment>::EmplaceBack(Args&&... args)
+    {
+        if (currentLength == maximumLength)
+        {
+            //	The element is built in the new block before the old one is released, because args may refer to an element of this array.
+            const unsigned newMaximumLength = GrownLength();
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            new (newArrayPtr + currentLength) T(std::forward<Args>(args)...);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, currentLength);
+
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else
+        {
+            new (ArrayPtr + currentLength) T(std::forward<Args>(args)...);
+        }
+        return ArrayPtr[currentLength++];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    template <typename... Args>
+    T& SmallArray<T, N, TAllocator, TAlignment>::Emplace(unsigned index, Args&&... args)
+    {
+        if (index > currentLength)
+        {
+            throw "Out of Range";
+        }
+
+        if (currentLength == maximumLength)
+        {
+            //	Growing leaves the gap at index while relocating, so every element is moved only once.
+            const unsigned newMaximumLength = GrownLength();
+            T* newArrayPtr = AllocateMemory(newMaximumLength);
+
+            new (newArrayPtr + index) T(std::forward<Args>(args)...);
+            ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, index);
+            ContainerMemory::RelocateElements(newArrayPtr + index + 1, ArrayPtr + index, currentLength - index);
+
+            FreeMemory(ArrayPtr, maximumLength);
+            ArrayPtr = newArrayPtr;
+            maximumLength = newMaximumLength;
+        }
+        else if (index == currentLength)
+        {
+            new (ArrayPtr + index) T(std::forward<Args>(args)...);
+        }
+        else if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            T element(std::forward<Args>(args)...);
+
+            memmove(ArrayPtr + index + 1, ArrayPtr + index, sizeof(T) * (currentLength - index));
+            new (ArrayPtr + index) T(std::move(element));
+        }
+        else
+        {
+            T element(std::forward<Args>(args)...);
+
+            new (ArrayPtr + currentLength) T(std::move(ArrayPtr[currentLength - 1]));
+            for (unsigned i = currentLength - 1; i > index; i--)
+            {
+                ArrayPtr[i] = std::move(ArrayPtr[i - 1]);
+            }
+            ArrayPtr[index] = std::move(element);
+        }
+
+        currentLength++;
+        return ArrayPtr[index];
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::RemoveFirst()
+    {
+        Remove(0);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Remove(const unsigned order)
+    {
+        if (order >= currentLength)
+        {
+            throw "Out of Range";
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            memmove(ArrayPtr + order, ArrayPtr + order + 1, sizeof(T) * (currentLength - order - 1));
+        }
+        else
+        {
+            for (unsigned i = order + 1; i < currentLength; i++)
+            {
+                ArrayPtr[i - 1] = std::move(ArrayPtr[i]);
+            }
+        }
+        currentLength--;
+        ContainerMemory::DestroyElements(ArrayPtr + currentLength, 1);
+    }
+
+    //	Fills the hole with the last element instead of shifting the tail, so the order is not preserved.
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::RemoveSwap(const unsigned order)
+    {
+        if (order >= currentLength)
+        {
+            throw "Out of Range";
+        }
+
+        currentLength--;
+        if (order != currentLength)
+        {
+            ArrayPtr[order] = std::move(ArrayPtr[currentLength]);
+        }
+        ContainerMemory::DestroyElements(ArrayPtr + currentLength, 1);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::RemoveAll()
+    {
+        ClearMemory();
+        ArrayPtr = InlineElements();
+        maximumLength = N;
+        currentLength = 0;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Reserve(unsigned int newMaximumLength)
+    {
+        if (newMaximumLength > maximumLength)
+        {
+            Relocate(newMaximumLength);
+        }
+    }
+
+    //	New elements are value initialized, elements past newLength are destroyed.
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Resize(unsigned int newLength)
+    {
+        if (newLength < currentLength)
+        {
+            ContainerMemory::DestroyElements(ArrayPtr + newLength, currentLength - newLength);
+            currentLength = newLength;
+            return;
+        }
+
+        if (newLength > maximumLength)
+        {
+            Relocate(GrownLength(newLength));
+        }
+        for (unsigned i = currentLength; i < newLength; i++)
+        {
+            new (ArrayPtr + i) T();
+        }
+        currentLength = newLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::ShrinkToFit()
+    {
+        if (IsInline() || currentLength == maximumLength)
+            return;
+
+        Relocate(currentLength <= N ? N : currentLength);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Swap(const unsigned& swapItemIndex1, const unsigned& swapItemIndex2)
+    {
+        if (swapItemIndex1 >= currentLength || swapItemIndex2 >= currentLength)
+        {
+            throw "Out of Range";
+        }
+        T TempData = std::move(ArrayPtr[swapItemIndex1]);
+
+        ArrayPtr[swapItemIndex1] = std::move(ArrayPtr[swapItemIndex2]);
+        ArrayPtr[swapItemIndex2] = std::move(TempData);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::Relocate(unsigned int newMaximumLength)
+    {
+        T* newArrayPtr = AllocateMemory(newMaximumLength);
+        ContainerMemory::RelocateElements(newArrayPtr, ArrayPtr, currentLength);
+
+        FreeMemory(ArrayPtr, maximumLength);
+        ArrayPtr = newArrayPtr;
+        maximumLength = newMaximumLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    unsigned int SmallArray<T, N, TAllocator, TAlignment>::GrownLength() const
+    {
+        return maximumLength * 2;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    unsigned int SmallArray<T, N, TAllocator, TAlignment>::GrownLength(unsigned int requiredLength) const
+    {
+        const unsigned grownLength = GrownLength();
+        return grownLength > requiredLength ? grownLength : requiredLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    bool SmallArray<T, N, TAllocator, TAlignment>::Contains(const T* element) const
+    {
+        return element >= ArrayPtr && element < ArrayPtr + currentLength;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::ClearMemory()
+    {
+        ContainerMemory::DestroyElements(ArrayPtr, currentLength);
+        FreeMemory(ArrayPtr, maximumLength);
+    }
+
+    //	Takes the heap block of other as it is, inline elements have to be moved one by one.
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::StealFrom(SmallArray& other)
+    {
+        if (other.IsInline())
+        {
+            ContainerMemory::RelocateElements(InlineElements(), other.ArrayPtr, other.currentLength);
+            ArrayPtr = InlineElements();
+            maximumLength = N;
+        }
+        else
+        {
+            ArrayPtr = other.ArrayPtr;
+            maximumLength = other.maximumLength;
+        }
+        currentLength = other.currentLength;
+
+        other.ArrayPtr = other.InlineElements();
+        other.maximumLength = N;
+        other.currentLength = 0;
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    T* SmallArray<T, N, TAllocator, TAlignment>::InlineElements()
+    {
+        return reinterpret_cast<T*>(InlineStorage);
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    T* SmallArray<T, N, TAllocator, TAlignment>::AllocateMemory(unsigned int length)
+    {
+        if (length <= N)
+            return InlineElements();
+
+        return static_cast<T*>(Allocator->Allocate(sizeof(T) * length, Alignment));
+    }
+
+    template <typename T, unsigned int N, typename TAllocator, unsigned int TAlignment>
+    void SmallArray<T, N, TAllocator, TAlignment>::FreeMemory(T* memory, unsigned int length)
+    {
+        if (memory == InlineElements())
+            return;
+
+        Allocator->Deallocate(memory, sizeof(T) * length, Alignment);
+    }
+}
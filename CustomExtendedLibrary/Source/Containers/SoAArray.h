@@ -0,0 +1,455 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Structure of Arrays container which stores every component of a vector in its own stream.
+ *
+ *  Current capabilities:
+ *  -   Vector2, Vector3, Vector4, Quaternion and ColorRGBA elements. (X, Y, Z, W or Red, Green, Blue, Alpha streams)
+ *  -   Every stream starts on a StreamAlignment boundary and is padded to a multiple of it,
+ *      so full width SIMD loads never cross into the next stream.
+ *  -   [] operator returns a proxy which reads and writes the element through the streams.
+ *  -   Stream. (Returns one component stream as a plain pointer for batch kernels)
+ *  -   FromArray and ToArray convert to and from the interleaved Array layout in one pass.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/HeapAllocator.h"
+#include "Vectors/Vector2.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+#include "Vectors/Quaternion.h"
+#include "Colors/ColorRGBA.h"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace Engine
+{
+    //	Tells SoAArray how many components an element has and how to split and join them.
+    template <typename TVector>
+    struct SoAComponents;
+
+    template <typename TValue>
+    struct SoAComponents<Vector2<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 2;
+
+        static Vector2<TValue> Join(TValue* const* streams, unsigned int index)
+        {
+            return Vector2<TValue>(streams[0][index], streams[1][index]);
+        }
+
+        static void Split(const Vector2<TValue>& element, TValue* const* streams, unsigned int index)
+        {
+            streams[0][index] = element.X;
+            streams[1][index] = element.Y;
+        }
+    };
+
+    template <typename TValue>
+    struct SoAComponents<Vector3<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 3;
+
+        static Vector3<TValue> Join(TValue* const* streams, unsigned int index)
+        {
+            return Vector3<TValue>(streams[0][index], streams[1][index], streams[2][index]);
+        }
+
+        static void Split(const Vector3<TValue>& element, TValue* const* streams, unsigned int index)
+        {
+            streams[0][index] = element.X;
+            streams[1][index] = element.Y;
+            streams[2][index] = element.Z;
+        }
+    };
+
+    template <typename TValue>
+    struct SoAComponents<Vector4<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 4;
+
+        static Vector4<TValue> Join(TValue* const* streams, unsigned int index)
+        {
+            return Vector4<TValue>(streams[0][index], streams[1][index], streams[2][index], streams[3][index]);
+        }
+
+        static void Split(const Vector4<TValue>& element, TValue* const* streams, unsigned int index)
+        {
+            streams[0][index] = element.X;
+            streams[1][index] = element.Y;
+            streams[2][index] = element.Z;
+            streams[3][index] = element.W;
+        }
+    };
+
+    template <typename TValue>
+    struct SoAComponents<Quaternion<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 4;
+
+        static Quaternion<TValue> Join(TValue* const* streams, unsigned int index)
+        {
+            return Quaternion<TValue>(streams[0][index], streams[1][index], streams[2][index], streams[3][index]);
+        }
+
+        static void Split(const Quaternion<TValue>& element, TValue* const* streams, unsigned int index)
+        {
+            streams[0][index] = element.X;
+            streams[1][index] = element.Y;
+            streams[2][index] = element.Z;
+            streams[3][index] = element.W;
+        }
+    };
+
+    template <typename TValue>
+    struct SoAComponents<ColorRGBA<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 4;
+
+        static ColorRGBA<TValue> Join(TValue* const* streams, unsigned int index)
+        {
+            return ColorRGBA<TValue>(streams[0][index], streams[1][index], streams[2][index], streams[3][index]);
+        }
+
+        static void Split(const ColorRGBA<TValue>& element, TValue* const* streams, unsigned int index)
+        {
+            streams[0][index] = element.Red;
+            streams[1][index] = element.Green;
+            streams[2][index] = element.Blue;
+            streams[3][index] = element.Alpha;
+        }
+    };
+
+    template <typename TVector, typename TAllocator = HeapAllocator>
+    class SoAArray
+    {
+    public:
+        using Components = SoAComponents<TVector>;
+        using TValue = typename Components::ValueType;
+
+        static_assert(std::is_trivially_copyable_v<TValue>, "SoAArray streams are moved with memcpy.");
+
+        static constexpr unsigned int ComponentCount = Components::Count;
+        static constexpr unsigned int StreamAlignment = 64;
+
+        //	Reads and writes one element through the streams, it is what [] operator returns.
+        class ElementReference
+        {
+        public:
+            ElementReference(TValue* const* streams, unsigned int index) : Streams(streams), Index(index) {}
+
+            operator TVector() const { return Components::Join(Streams, Index); }
+            ElementReference& operator=(const TVector& element) { Components::Split(element, Streams, Index); return *this; }
+            ElementReference& operator=(const ElementReference& other) { return *this = static_cast<TVector>(other); }
+
+            TValue& operator[](unsigned int component) const { return Streams[component][Index]; }
+
+        private:
+            TValue* const* Streams;
+            unsigned int Index;
+        };
+
+        SoAArray();
+        explicit SoAArray(TAllocator& allocator);
+        SoAArray(const SoAArray& other);
+        SoAArray(SoAArray&& other) noexcept;
+        ~SoAArray();
+
+        SoAArray& operator=(const SoAArray& other);
+        SoAArray& operator=(SoAArray&& other) noexcept;
+
+        unsigned int Length() const;
+        unsigned int MaxLength() const;
+
+        TValue* Stream(unsigned int component) { return Streams[component]; }
+        const TValue* Stream(unsigned int component) const { return Streams[component]; }
+
+        ElementReference operator[](const unsigned index);
+        TVector operator[](const unsigned index) const;
+        TVector Get(unsigned int index) const;
+        void Set(unsigned int index, const TVector& element);
+
+        void Add(const TVector& element);
+        void RemoveSwap(const unsigned index);
+        void RemoveAll();
+
+        void Reserve(unsigned int newMaximumLength);
+        void Resize(unsigned int newLength);
+
+        template <typename TArrayAllocator, unsigned int TArrayAlignment>
+        void FromArray(const Array<TVector, TArrayAllocator, TArrayAlignment>& source);
+
+        template <typename TArrayAllocator, unsigned int TArrayAlignment>
+        void ToArray(Array<TVector, TArrayAllocator, TArrayAlignment>& destination) const;
+
+    private:
+        unsigned int maximumLength = 0;
+        unsigned int currentLength = 0;
+        TValue* Streams[ComponentCount] = {};
+        TAllocator* Allocator;
+
+        void Relocate(unsigned int newMaximumLength);
+        void ClearMemory();
+        static unsigned int PaddedLength(unsigned int length);
+    };
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>::SoAArray() : Allocator(&TAllocator::Get())
+    {
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>::SoAArray(TAllocator& allocator) : Allocator(&allocator)
+    {
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>::SoAArray(const SoAArray& other) : Allocator(other.Allocator)
+    {
+        Reserve(other.currentLength);
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            if (other.currentLength)
+            {
+                memcpy(Streams[c], other.Streams[c], sizeof(TValue) * other.currentLength);
+            }
+        }
+        currentLength = other.currentLength;
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>::SoAArray(SoAArray&& other) noexcept : Allocator(other.Allocator)
+    {
+        maximumLength = other.maximumLength;
+        currentLength = other.currentLength;
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            Streams[c] = other.Streams[c];
+            other.Streams[c] = nullptr;
+        }
+
+        other.maximumLength = 0;
+        other.currentLength = 0;
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>::~SoAArray()
+    {
+        ClearMemory();
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>& SoAArray<TVector, TAllocator>::operator=(const SoAArray& other)
+    {
+        if (this != &other)
+        {
+            SoAArray temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    template <typename TVector, typename TAllocator>
+    SoAArray<TVector, TAllocator>& SoAArray<TVector, TAllocator>::operator=(SoAArray&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ClearMemory();
+
+            maximumLength = other.maximumLength;
+            currentLength = other.currentLength;
+            Allocator = other.Allocator;
+            for (unsigned c = 0; c < ComponentCount; c++)
+            {
+                Streams[c] = other.Streams[c];
+                other.Streams[c] = nullptr;
+            }
+
+            other.maximumLength = 0;
+            other.currentLength = 0;
+        }
+        return *this;
+    }
+
+    template <typename TVector, typename TAllocator>
+    unsigned SoAArray<TVector, TAllocator>::Length() const
+    {
+        return currentLength;
+    }
+
+    template <typename TVector, typename TAllocator>
+    unsigned SoAArray<TVector, TAllocator>::MaxLength() const
+    {
+        return maximumLength;
+    }
+
+    template <typename TVector, typename TAllocator>
+    typename SoAArray<TVector, TAllocator>::ElementReference SoAArray<TVector, TAllocator>::operator[](const unsigned index)
+    {
+        return ElementReference(Streams, index);
+    }
+
+    template <typename TVector, typename TAllocator>
+    TVector SoAArray<TVector, TAllocator>::operator[](const unsigned index) const
+    {
+        return Components::Join(Streams, index);
+    }
+
+    template <typename TVector, typename TAllocator>
+    TVector SoAArray<TVector, TAllocator>::Get(unsigned int index) const
+    {
+        return Components::Join(Streams, index);
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::Set(unsigned int index, const TVector& element)
+    {
+        Components::Split(element, Streams, index);
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::Add(const TVector& element)
+    {
+        if (currentLength == maximumLength)
+        {
+            Relocate(maximumLength ? maximumLength * 2 : PaddedLength(1));
+        }
+        Components::Split(element, Streams, currentLength);
+        currentLength++;
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::RemoveSwap(const unsigned index)
+    {
+        if (index >= currentLength)
+        {
+            throw "Out of Range";
+        }
+
+        currentLength--;
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            Streams[c][index] = Streams[c][currentLength];
+        }
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::RemoveAll()
+    {
+        ClearMemory();
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            Streams[c] = nullptr;
+        }
+        maximumLength = 0;
+        currentLength = 0;
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::Reserve(unsigned int newMaximumLength)
+    {
+        if (newMaximumLength > maximumLength)
+        {
+            Relocate(newMaximumLength);
+        }
+    }
+
+    //	New elements are zeroed, which is what the vector default constructors give as well.
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::Resize(unsigned int newLength)
+    {
+        if (newLength > maximumLength)
+        {
+            Relocate(newLength > maximumLength * 2 ? newLength : maximumLength * 2);
+        }
+        if (newLength > currentLength)
+        {
+            for (unsigned c = 0; c < ComponentCount; c++)
+            {
+                memset(Streams[c] + currentLength, 0, sizeof(TValue) * (newLength - currentLength));
+            }
+        }
+        currentLength = newLength;
+    }
+
+    template <typename TVector, typename TAllocator>
+    template <typename TArrayAllocator, unsigned int TArrayAlignment>
+    void SoAArray<TVector, TAllocator>::FromArray(const Array<TVector, TArrayAllocator, TArrayAlignment>& source)
+    {
+        const unsigned length = source.Length();
+        if (length > maximumLength)
+        {
+            currentLength = 0;
+            Relocate(length);
+        }
+
+        const TVector* elements = source.GetSource();
+        for (unsigned i = 0; i < length; i++)
+        {
+            Components::Split(elements[i], Streams, i);
+        }
+        currentLength = length;
+    }
+
+    template <typename TVector, typename TAllocator>
+    template <typename TArrayAllocator, unsigned int TArrayAlignment>
+    void SoAArray<TVector, TAllocator>::ToArray(Array<TVector, TArrayAllocator, TArrayAlignment>& destination) const
+    {
+        destination.RemoveAll();
+        destination.Reserve(currentLength);
+        for (unsigned i = 0; i < currentLength; i++)
+        {
+            destination.EmplaceBack(Components::Join(Streams, i));
+        }
+    }
+
+    //	All streams share one block, every stream is PaddedLength elements apart from the previous one.
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::Relocate(unsigned int newMaximumLength)
+    {
+        newMaximumLength = PaddedLength(newMaximumLength);
+
+        TValue* newBlock = static_cast<TValue*>(Allocator->Allocate(sizeof(TValue) * newMaximumLength * ComponentCount, StreamAlignment));
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            if (currentLength)
+            {
+                memcpy(newBlock + c * newMaximumLength, Streams[c], sizeof(TValue) * currentLength);
+            }
+        }
+
+        ClearMemory();
+        for (unsigned c = 0; c < ComponentCount; c++)
+        {
+            Streams[c] = newBlock + c * newMaximumLength;
+        }
+        maximumLength = newMaximumLength;
+    }
+
+    template <typename TVector, typename TAllocator>
+    void SoAArray<TVector, TAllocator>::ClearMemory()
+    {
+        if (Streams[0] == nullptr)
+            return;
+
+        Allocator->Deallocate(Streams[0], sizeof(TValue) * maximumLength * ComponentCount, StreamAlignment);
+    }
+
+    template <typename TVector, typename TAllocator>
+    unsigned int SoAArray<TVector, TAllocator>::PaddedLength(unsigned int length)
+    {
+        constexpr unsigned int streamStep = StreamAlignment / sizeof(TValue) ? StreamAlignment / sizeof(TValue) : 1;
+        return (length + streamStep - 1) / streamStep * streamStep;
+    }
+}
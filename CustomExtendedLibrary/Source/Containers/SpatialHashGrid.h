@@ -0,0 +1,394 @@
+// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a spatial hash grid for broad-phase neighbour lookups over floating point Vector2 or Vector3 positions.
+ *
+ *  Current capabilities:
+ *  -   Positions are quantized to cells of CellSize and each cell is hashed into one of a power of two buckets.
+ *  -   Sort based layout. Entries are counting sorted by bucket, so every bucket is one contiguous run
+ *      and BucketStarts gives where it begins. There are no per cell allocations.
+ *  -   Update rebuilds for moved positions in O(n), reusing the memory and the order of the previous frame.
+ *  -   Neighbours (every point within a radius of a position), ForEachPair and FindPairs (every pair of points
+ *      within a radius of each other, each pair once). Only squared distances are compared.
+ *  -   Optional multithreading through Parallel::For, FindPairs appends to a ConcurrentArray from every thread.
+ *
+ *  Queries are fastest when the radius is at most CellSize, larger radii visit more cells.
+ *  Different cells can share a bucket, those points are filtered out by the distance check.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ConcurrentArray.h"
+#include "Containers/Parallel.h"
+#include "Containers/SmallArray.h"
+#include "Core/Types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace Engine
+{
+    template <typename TVector>
+    class SpatialHashGrid
+    {
+    public:
+        using ValueType = decltype(TVector::X);
+
+        static constexpr unsigned int Dimensions = TVector::Num();
+        static_assert(Dimensions == 2 || Dimensions == 3, "SpatialHashGrid works on Vector2 and Vector3 positions");
+        static_assert(std::is_floating_point_v<ValueType>, "SpatialHashGrid quantizes with the inverse cell size, positions have to be floating point");
+
+        //	Indices of two points in the position array, First is always the smaller one.
+        struct Pair
+        {
+            unsigned int First;
+            unsigned int Second;
+        };
+
+        explicit SpatialHashGrid(ValueType cellSize);
+
+        ValueType GetCellSize() const { return CellSize; }
+
+        //	Gives the count of points in the grid.
+        unsigned int Length() const;
+
+        //	Replaces the grid with the given positions.
+        void Build(const TVector* positions, unsigned int count, bool multithreaded = false);
+
+        template <typename TAllocator, unsigned int TAlignment>
+        void Build(const Array<TVector, TAllocator, TAlignment>& positions, bool multithreaded = false);
+
+        //	Same as Build for positions which moved since the last one. The previous order is the starting point of
+        //	the sort, so entries that stay in their cell keep their place. A different count falls back to Build.
+        void Update(const TVector* positions, unsigned int count, bool multithreaded = false);
+
+        template <typename TAllocator, unsigned int TAlignment>
+        void Update(const Array<TVector, TAllocator, TAlignment>& positions, bool multithreaded = false);
+
+        //	Replaces results with every point whose distance to position is at most radius, in no particular order.
+        template <typename TAllocator, unsigned int TAlignment>
+        void Neighbours(const TVector& position, ValueType radius, Array<unsigned int, TAllocator, TAlignment>& results) const;
+
+        //	Calls function(first, second) once for every pair of points within radius of each other.
+        template <typename TFunction>
+        void ForEachPair(ValueType radius, TFunction function) const;
+
+        //	Appends every pair of points within radius of each other. The order is only fixed when not multithreaded.
+        void FindPairs(ValueType radius, ConcurrentArray<Pair>& pairs, bool multithreaded = false) const;
+
+    private:
+        struct Entry
+        {
+            TVector Position;
+            unsigned int Index;
+            unsigned int Bucket;
+        };
+
+        struct Cell
+        {
+            int32 Coordinates[3];
+
+            bool operator==(const Cell& other) const;
+        };
+
+        static constexpr unsigned int MinimumBucketCount = 64;
+        static constexpr unsigned int PairBufferLength = 256;
+
+        //	The buckets of a cell and its neighbours, with the duplicates removed. 27 is the 3x3x3 block.
+        using BucketList = SmallArray<unsigned int, 27>;
+
+        Cell CellOf(const TVector& position) const;
+        unsigned int BucketOf(const Cell& cell) const;
+
+        //	How many cells away a point within radius can be.
+        int32 Reach(ValueType radius) const;
+
+        void NeighbourBuckets(const Cell& cell, int32 reach, BucketList& buckets) const;
+
+        //	Recomputes the buckets in the current order and counting sorts the entries by bucket.
+        void Sort(const TVector* positions, bool multithreaded);
+
+        //	Calls function(first, second) for the pairs whose lower sorted position is in [begin, end).
+        template <typename TFunction>
+        void VisitPairs(unsigned int begin, unsigned int end, ValueType radius, TFunction function) const;
+
+        ValueType CellSize;
+        ValueType InverseCellSize;
+        unsigned int BucketShift;
+
+        Array<Entry> Entries;
+        Array<Entry> SortedEntries;
+
+        //	Entries of bucket b are [BucketStarts[b], BucketStarts[b + 1]).
+        Array<unsigned int> BucketStarts;
+    };
+
+    template <typename TVector>
+    SpatialHashGrid<TVector>::SpatialHashGrid(ValueType cellSize)
+        : CellSize(cellSize), InverseCellSize(static_cast<ValueType>(1) / cellSize), BucketShift(32)
+    {
+    }
+
+    template <typename TVector>
+    unsigned int SpatialHashGrid<TVector>::Length() const
+    {
+        return Entries.Length();
+    }
+
+    template <typename TVector>
+    void SpatialHashGrid<TVector>::Build(const TVector* positions, unsigned int count, bool multithreaded)
+    {
+        Entries.Resize(count);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Entries[i].Index = i;
+        }
+        Sort(positions, multithreaded);
+    }
+
+    template <typename TVector>
+    template <typename TAllocator, unsigned int TAlignment>
+    void SpatialHashGrid<TVector>::Build(const Array<TVector, TAllocator, TAlignment>& positions, bool multithreaded)
+    {
+        Build(positions.GetSource(), positions.Length(), multithreaded);
+    }
+
+    template <typename TVector>
+    void SpatialHashGrid<TVector>::Update(const TVector* positions, unsigned int count, bool multithreaded)
+    {
+        if (count != Entries.Length())
+        {
+            Build(positions, count, multithreaded);
+            return;
+        }
+        Sort(positions, multithreaded);
+    }
+
+    template <typename TVector>
+    template <typename TAllocator, unsigned int TAlignment>
+    void SpatialHashGrid<TVector>::Update(const Array<TVector, TAllocator, TAlignment>& positions, bool multithreaded)
+    {
+        Update(positions.GetSource(), positions.Length(), multithreaded);
+    }
+
+    template <typename TVector>
+    template <typename TAllocator, unsigned int TAlignment>
+    void SpatialHashGrid<TVector>::Neighbours(const TVector& position, ValueType radius, Array<unsigned int, TAllocator, TAlignment>& results) const
+    {
+        results.RemoveAll();
+        if (Entries.Length() == 0)
+        {
+            return;
+        }
+
+        BucketList buckets;
+        NeighbourBuckets(CellOf(position), Reach(radius), buckets);
+
+        const ValueType radiusSquared = radius * radius;
+        for (unsigned int bucket : buckets)
+        {
+            for (unsigned int i = BucketStarts[bucket]; i < BucketStarts[bucket + 1]; i++)
+            {
+                if (TVector::DistanceSquared(position, Entries[i].Position) <= radiusSquared)
+                {
+                    results.Add(Entries[i].Index);
+                }
+            }
+        }
+    }
+
+    template <typename TVector>
+    template <typename TFunction>
+    void SpatialHashGrid<TVector>::ForEachPair(ValueType radius, TFunction function) const
+    {
+        VisitPairs(0, Entries.Length(), radius, function);
+    }
+
+    template <typename TVector>
+    void SpatialHashGrid<TVector>::FindPairs(ValueType radius, ConcurrentArray<Pair>& pairs, bool multithreaded) const
+    {
+        //	Every chunk collects its pairs on the stack and appends them with one fetch-add per buffer.
+        auto function = [this, radius, &pairs](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            SmallArray<Pair, PairBufferLength> buffer;
+            VisitPairs(chunkBegin, chunkEnd, radius, [&](unsigned int first, unsigned int second)
+            {
+                buffer.Add(Pair{ first, second });
+                if (buffer.Length() == PairBufferLength)
+                {
+                    pairs.AddRange(buffer.GetSource(), buffer.Length());
+                    buffer.RemoveAll();
+                }
+            });
+
+            if (buffer.Length() != 0)
+            {
+                pairs.AddRange(buffer.GetSource(), buffer.Length());
+            }
+        };
+
+        if (multithreaded)
+        {
+            Parallel::For(Entries.Length(), Parallel::DefaultChunkLength, function);
+        }
+        else if (Entries.Length() != 0)
+        {
+            function(0u, Entries.Length());
+        }
+    }
+
+    template <typename TVector>
+    bool SpatialHashGrid<TVector>::Cell::operator==(const Cell& other) const
+    {
+        return Coordinates[0] == other.Coordinates[0] && Coordinates[1] == other.Coordinates[1] && Coordinates[2] == other.Coordinates[2];
+    }
+
+    template <typename TVector>
+    typename SpatialHashGrid<TVector>::Cell SpatialHashGrid<TVector>::CellOf(const TVector& position) const
+    {
+        Cell cell = { { static_cast<int32>(std::floor(position.X * InverseCellSize)), static_cast<int32>(std::floor(position.Y * InverseCellSize)), 0 } };
+        if constexpr (Dimensions == 3)
+        {
+            cell.Coordinates[2] = static_cast<int32>(std::floor(position.Z * InverseCellSize));
+        }
+        return cell;
+    }
+
+    template <typename TVector>
+    unsigned int SpatialHashGrid<TVector>::BucketOf(const Cell& cell) const
+    {
+        //	Prime multipliers mix the axes, then a multiplicative hash moves every bit into the top bits it keeps.
+        const uint32 hash = static_cast<uint32>(cell.Coordinates[0]) * 73856093u ^ static_cast<uint32>(cell.Coordinates[1]) * 19349663u ^
+                            static_cast<uint32>(cell.Coordinates[2]) * 83492791u;
+        return static_cast<unsigned int>(static_cast<uint64>(hash * 2654435769u) >> BucketShift);
+    }
+
+    template <typename TVector>
+    int32 SpatialHashGrid<TVector>::Reach(ValueType radius) const
+    {
+        return static_cast<int32>(std::ceil(radius * InverseCellSize));
+    }
+
+    template <typename TVector>
+    void SpatialHashGrid<TVector>::NeighbourBuckets(const Cell& cell, int32 reach, BucketList& buckets) const
+    {
+        buckets.RemoveAll();
+
+        const int32 zReach = Dimensions == 3 ? reach : 0;
+        for (int32 z = -zReach; z <= zReach; z++)
+        {
+            for (int32 y = -reach; y <= reach; y++)
+            {
+                for (int32 x = -reach; x <= reach; x++)
+                {
+                    const Cell neighbour = { { cell.Coordinates[0] + x, cell.Coordinates[1] + y, cell.Coordinates[2] + z } };
+                    buckets.Add(BucketOf(neighbour));
+                }
+            }
+        }
+
+        std::sort(buckets.begin(), buckets.end());
+        buckets.Resize(static_cast<unsigned int>(std::unique(buckets.begin(), buckets.end()) - buckets.begin()));
+    }
+
+    template <typename TVector>
+    void SpatialHashGrid<TVector>::Sort(const TVector* positions, bool multithreaded)
+    {
+        const unsigned int count = Entries.Length();
+
+        //	At least two buckets per point keeps the collisions low.
+        unsigned int bucketBits = 6;
+        while (bucketBits < 31 && (1u << bucketBits) < count * 2ull)
+        {
+            bucketBits++;
+        }
+        const unsigned int bucketCount = 1u << bucketBits;
+        BucketShift = 32 - bucketBits;
+
+        auto refresh = [this, positions](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                Entries[i].Position = positions[Entries[i].Index];
+                Entries[i].Bucket = BucketOf(CellOf(Entries[i].Position));
+            }
+        };
+
+        if (multithreaded)
+        {
+            Parallel::For(count, Parallel::DefaultChunkLength, refresh);
+        }
+        else if (count != 0)
+        {
+            refresh(0u, count);
+        }
+
+        //	Counting sort. BucketStarts first holds where each bucket ends, walking backwards turns it into
+        //	where each bucket starts and keeps entries of the same bucket in their previous order.
+        BucketStarts.Resize(bucketCount + 1);
+        std::fill(BucketStarts.begin(), BucketStarts.end(), 0u);
+        for (const Entry& entry : Entries)
+        {
+            BucketStarts[entry.Bucket]++;
+        }
+
+        unsigned int end = 0;
+        for (unsigned int bucket = 0; bucket <= bucketCount; bucket++)
+        {
+            end += BucketStarts[bucket];
+            BucketStarts[bucket] = end;
+        }
+
+        SortedEntries.Resize(count);
+        for (unsigned int i = count; i-- != 0;)
+        {
+            SortedEntries[--BucketStarts[Entries[i].Bucket]] = Entries[i];
+        }
+        std::swap(Entries, SortedEntries);
+    }
+
+    template <typename TVector>
+    template <typename TFunction>
+    void SpatialHashGrid<TVector>::VisitPairs(unsigned int begin, unsigned int end, ValueType radius, TFunction function) const
+    {
+        const ValueType radiusSquared = radius * radius;
+        const int32 reach = Reach(radius);
+
+        //	Entries of one cell are next to each other unless another cell shares their bucket, so the bucket list
+        //	is only rebuilt when the cell changes.
+        BucketList buckets;
+        Cell lastCell = {};
+        bool hasCell = false;
+
+        for (unsigned int i = begin; i < end; i++)
+        {
+            const Entry& entry = Entries[i];
+            const Cell cell = CellOf(entry.Position);
+            if (!hasCell || !(cell == lastCell))
+            {
+                NeighbourBuckets(cell, reach, buckets);
+                lastCell = cell;
+                hasCell = true;
+            }
+
+            //	A pair is only reported from the entry which comes first in sorted order.
+            for (unsigned int bucket : buckets)
+            {
+                const unsigned int bucketBegin = BucketStarts[bucket] > i ? BucketStarts[bucket] : i + 1;
+                for (unsigned int j = bucketBegin; j < BucketStarts[bucket + 1]; j++)
+                {
+                    const Entry& other = Entries[j];
+                    if (TVector::DistanceSquared(entry.Position, other.Position) <= radiusSquared)
+                    {
+                        function(entry.Index < other.Index ? entry.Index : other.Index, entry.Index < other.Index ? other.Index : entry.Index);
+                    }
+                }
+            }
+        }
+    }
+}
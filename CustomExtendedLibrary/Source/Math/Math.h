@@ -2,6 +2,10 @@
 
 #include <Core/CoreAPI.h>
 #include <Core/Types.h>
+#include <Math/SIMD.h>
+
+#include <cstring>
+#include <type_traits>
 
 namespace Engine
 {
@@ -10,13 +14,28 @@ namespace Engine
 #define DEG_TO_RAD 0.01745329252f
 #define RAD_TO_DEG 357.295779513f
 
+    //	Precision policy of the square root based functions.
+    //	Exact is the correctly rounded result. Fast trades a few ULPs for throughput, it is only applied to float.
+    enum class Precision : byte
+    {
+        Exact,
+        Fast
+    };
+
     class Math
     {
     public:
         Math() = delete;
         ~Math() = delete;
         
-        FORCEINLINE static float Sqrt(const float value);
+        //	Fast is value * InverseSqrt<Fast>(value), zero and negative values give zero.
+        template <Precision TPrecision = Precision::Exact, typename TValue>
+        FORCEINLINE static TValue Sqrt(const TValue value);
+
+        //	1 / sqrt(value). Fast is the hardware estimate refined with one Newton-Raphson step,
+        //	the relative error is below 2^-21 on SSE targets and below 2^-9 on the scalar fallback.
+        template <Precision TPrecision = Precision::Exact, typename TValue>
+        FORCEINLINE static TValue InverseSqrt(const TValue value);
 
         FORCEINLINE static float Pow(const float value, const float power);
 
@@ -38,9 +57,41 @@ namespace Engine
     };
 
 
-    inline float Math::Sqrt(const float value)
+    template <Precision TPrecision, typename TValue>
+    inline TValue Math::Sqrt(const TValue value)
+    {
+        if constexpr (TPrecision == Precision::Fast && std::is_same_v<TValue, float>)
+        {
+            return value > 0.0f ? value * InverseSqrt<Precision::Fast>(value) : 0.0f;
+        }
+        else
+        {
+            return static_cast<TValue>(std::sqrt(value));
+        }
+    }
+
+    template <Precision TPrecision, typename TValue>
+    inline TValue Math::InverseSqrt(const TValue value)
     {
-        return sqrtf(value);
+        if constexpr (TPrecision == Precision::Fast && std::is_same_v<TValue, float>)
+        {
+#if ENGINE_SIMD_SSE
+            return _mm_cvtss_f32(SIMD::InverseSqrtFast4(_mm_set_ss(value)));
+#else
+            //	Bit level initial guess, then the same Newton-Raphson step as the SSE path.
+            uint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = 0x5F375A86 - (bits >> 1);
+
+            float estimate;
+            std::memcpy(&estimate, &bits, sizeof(estimate));
+            return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#endif
+        }
+        else
+        {
+            return static_cast<TValue>(1 / std::sqrt(value));
+        }
     }
 
     inline float Math::Pow(const float value, const float power)
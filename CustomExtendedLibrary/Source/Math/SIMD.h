@@ -0,0 +1,723 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is the SIMD backend selection of the math types. Everything is decided at compile time.
+ *
+ *  Current capabilities:
+ *  -   ENGINE_SIMD_SSE, ENGINE_SIMD_SSE41, ENGINE_SIMD_AVX, ENGINE_SIMD_AVX2, ENGINE_SIMD_FMA, ENGINE_SIMD_BMI2 are 1
+ *      when the compiler targets that instruction set (/arch:AVX2, -mavx2 ...), otherwise 0.
+ *  -   Define ENGINE_DISABLE_SIMD before including any math header to force the scalar fallback.
+ *  -   Float4 helpers which the Vector4<float>, ColorRGBA<float> and Matrix4x4<float> specializations are built on.
+ *  -   Fast reciprocal square root. (Estimate refined with one Newton-Raphson step)
+ *  -   Runtime instruction set detection (SSE, AVX2, AVX-512) for the batch kernels, which are compiled for
+ *      every instruction set through ENGINE_TARGET_AVX2 / ENGINE_TARGET_AVX512 and picked at run time
+ *      by SIMD::Dispatch.
+ *  -   Float4Lanes, Float8Lanes, Float16Lanes. (Same operations for 4, 8 and 16 float lanes)
+ *      Float4Lanes and Float8Lanes also load and store interleaved Vector3 and Vector4 with shuffles, store
+ *      Vector4 at a stride (matrix rows), and stream.
+ *  -   ENGINE_CONSTANT_EVALUATED, so constexpr functions can take a scalar path at compile time and SIMD at run time.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/Types.h"
+
+#if !defined(ENGINE_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ENGINE_SIMD_SSE 1
+#else
+#define ENGINE_SIMD_SSE 0
+#endif
+
+#if ENGINE_SIMD_SSE && (defined(__SSE4_1__) || defined(__AVX__))
+#define ENGINE_SIMD_SSE41 1
+#else
+#define ENGINE_SIMD_SSE41 0
+#endif
+
+#if ENGINE_SIMD_SSE && defined(__AVX__)
+#define ENGINE_SIMD_AVX 1
+#else
+#define ENGINE_SIMD_AVX 0
+#endif
+
+#if ENGINE_SIMD_SSE && defined(__AVX2__)
+#define ENGINE_SIMD_AVX2 1
+#else
+#define ENGINE_SIMD_AVX2 0
+#endif
+
+//	MSVC has no __FMA__ macro, every AVX2 target it supports has FMA3 as well.
+#if ENGINE_SIMD_SSE && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define ENGINE_SIMD_FMA 1
+#else
+#define ENGINE_SIMD_FMA 0
+#endif
+
+//	pdep and pext. They are only used when the build targets BMI2, AMD before Zen 3 runs them in microcode
+//	which is slower than the shift and mask fallback, so there is no run time detection for them. 64 bit only.
+#if ENGINE_SIMD_SSE && (defined(__x86_64__) || defined(_M_X64)) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define ENGINE_SIMD_BMI2 1
+#else
+#define ENGINE_SIMD_BMI2 0
+#endif
+
+//	Lets a single function use a wider instruction set than the rest of the build, only GCC and Clang need it.
+#if defined(__GNUC__) || defined(__clang__)
+#define ENGINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define ENGINE_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#define ENGINE_TARGET_F16C __attribute__((target("avx,f16c")))
+#else
+#define ENGINE_TARGET_AVX2
+#define ENGINE_TARGET_AVX512
+#define ENGINE_TARGET_F16C
+#endif
+
+//	True while a constexpr function is evaluated at compile time. Intrinsics are not constexpr, so SIMD paths branch on it.
+//	Compilers without the builtin only get the SIMD path, which means those specializations are run time only there.
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define ENGINE_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define ENGINE_CONSTANT_EVALUATED() false
+#endif
+
+#if ENGINE_SIMD_SSE
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace Engine
+{
+    namespace SIMD
+    {
+        enum class InstructionSet : byte
+        {
+            Scalar,
+            SSE,
+            AVX2,
+            AVX512
+        };
+
+        //	Asks the CPU and the OS which instruction set can run. AVX2 is only reported together with FMA.
+        inline InstructionSet DetectInstructionSet()
+        {
+#if !ENGINE_SIMD_SSE
+            return InstructionSet::Scalar;
+#elif defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            const int highestLeaf = info[0];
+
+            __cpuid(info, 1);
+            const bool osSavesRegisters = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            if (!osSavesRegisters || !avx || !fma || highestLeaf < 7)
+                return InstructionSet::SSE;
+
+            //	The OS has to save the YMM (and for AVX-512 the ZMM and mask) registers on context switch.
+            const unsigned long long enabledRegisters = _xgetbv(0);
+            if ((enabledRegisters & 0x6) != 0x6)
+                return InstructionSet::SSE;
+
+            __cpuidex(info, 7, 0);
+            const bool avx2 = (info[1] & (1 << 5)) != 0;
+            const bool avx512 = (info[1] & (1 << 16)) != 0;
+            if (avx2 && avx512 && (enabledRegisters & 0xE6) == 0xE6)
+                return InstructionSet::AVX512;
+
+            return avx2 ? InstructionSet::AVX2 : InstructionSet::SSE;
+#else
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+                return InstructionSet::SSE;
+
+            if (__builtin_cpu_supports("avx512f"))
+                return InstructionSet::AVX512;
+
+            return InstructionSet::AVX2;
+#endif
+        }
+
+        //	F16C half float conversions, detected on their own so a CPU without them keeps its AVX2 level
+        //	for everything else. Its 256 bit forms need the same OS register support as AVX.
+        inline bool DetectF16C()
+        {
+#if !ENGINE_SIMD_SSE
+            return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            const bool osSavesRegisters = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            const bool f16c = (info[2] & (1 << 29)) != 0;
+            return osSavesRegisters && avx && f16c && (_xgetbv(0) & 0x6) == 0x6;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+        }
+
+        inline bool HasF16C()
+        {
+            static const bool hasF16C = DetectF16C();
+            return hasF16C;
+        }
+
+        inline InstructionSet& ActiveInstructionSetStorage()
+        {
+            static InstructionSet activeInstructionSet = DetectInstructionSet();
+            return activeInstructionSet;
+        }
+
+        //	Instruction set the batch kernels run with. It is detected on the first call.
+        inline InstructionSet ActiveInstructionSet()
+        {
+            return ActiveInstructionSetStorage();
+        }
+
+        //	Lowers the active instruction set, to compare the paths or to test the narrower ones.
+        //	It can never go above the detected one. Not thread safe, call it before any batch work starts.
+        inline void LimitInstructionSet(InstructionSet limit)
+        {
+            const InstructionSet detected = DetectInstructionSet();
+            ActiveInstructionSetStorage() = limit < detected ? limit : detected;
+        }
+
+        //	Kernel structs of one batch library, one per instruction set. An instruction set without kernels of its
+        //	own names the struct of a narrower one.
+        template <typename TSSE, typename TAVX2, typename TAVX512>
+        struct Kernels
+        {
+            using SSE = TSSE;
+            using AVX2 = TAVX2;
+            using AVX512 = TAVX512;
+        };
+
+        //	Calls function with the struct of TKernels for the active instruction set and gives its result,
+        //	which is how many elements the kernel processed. Gives 0 when there is no SIMD at all.
+        template <typename TKernels, typename TFunction>
+        unsigned int Dispatch(TFunction function)
+        {
+#if ENGINE_SIMD_SSE
+            switch (ActiveInstructionSet())
+            {
+            case InstructionSet::AVX512:
+                return function(typename TKernels::AVX512());
+            case InstructionSet::AVX2:
+                return function(typename TKernels::AVX2());
+            case InstructionSet::SSE:
+                return function(typename TKernels::SSE());
+            default:
+                return 0;
+            }
+#else
+            return 0;
+#endif
+        }
+    }
+}
+
+#if ENGINE_SIMD_SSE
+
+namespace Engine
+{
+    namespace SIMD
+    {
+        //	Loads four consecutive floats, alignment is not required.
+        inline __m128 Load4(const float* values)
+        {
+            return _mm_loadu_ps(values);
+        }
+
+        inline void Store4(float* values, __m128 vector)
+        {
+            _mm_storeu_ps(values, vector);
+        }
+
+        //	Dot product of all four lanes, the result is in every lane.
+        inline __m128 Dot4(__m128 left, __m128 right)
+        {
+#if ENGINE_SIMD_SSE41
+            return _mm_dp_ps(left, right, 0xFF);
+#else
+            __m128 product = _mm_mul_ps(left, right);
+            __m128 swapped = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sums = _mm_add_ps(product, swapped);
+            swapped = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2));
+            return _mm_add_ps(sums, swapped);
+#endif
+        }
+
+        inline float Dot4Scalar(__m128 left, __m128 right)
+        {
+            return _mm_cvtss_f32(Dot4(left, right));
+        }
+
+        inline float Length4(__m128 vector)
+        {
+            return _mm_cvtss_f32(_mm_sqrt_ss(Dot4(vector, vector)));
+        }
+
+        inline __m128 Normalize4(__m128 vector)
+        {
+            return _mm_div_ps(vector, _mm_sqrt_ps(Dot4(vector, vector)));
+        }
+
+        //	rsqrtps estimate (12 bits) plus one Newton-Raphson step, which gives about 21 bits.
+        inline __m128 InverseSqrtFast4(__m128 value)
+        {
+            const __m128 estimate = _mm_rsqrt_ps(value);
+            const __m128 halfValue = _mm_mul_ps(_mm_set1_ps(0.5f), value);
+            const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfValue, _mm_mul_ps(estimate, estimate)));
+            return _mm_mul_ps(estimate, correction);
+        }
+
+        inline __m128 NormalizeFast4(__m128 vector)
+        {
+            return _mm_mul_ps(vector, InverseSqrtFast4(Dot4(vector, vector)));
+        }
+
+        //	Cross product of the X, Y and Z lanes. W of the result is 0 as long as both W lanes are finite.
+        inline __m128 Cross3(__m128 left, __m128 right)
+        {
+            const __m128 leftYZX = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 rightYZX = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 crossZXY = _mm_sub_ps(_mm_mul_ps(left, rightYZX), _mm_mul_ps(leftYZX, right));
+            return _mm_shuffle_ps(crossZXY, crossZXY, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        //	left * right + addend, one fused instruction when the build targets FMA.
+        inline __m128 MultiplyAdd4(__m128 left, __m128 right, __m128 addend)
+        {
+#if ENGINE_SIMD_FMA
+            return _mm_fmadd_ps(left, right, addend);
+#else
+            return _mm_add_ps(_mm_mul_ps(left, right), addend);
+#endif
+        }
+
+        //	Row vector times a 4x4 matrix, x * row0 + y * row1 + z * row2 + w * row3. Two independent sums halve the latency.
+        inline __m128 TransformRow4(__m128 vector, __m128 row0, __m128 row1, __m128 row2, __m128 row3)
+        {
+            const __m128 low = MultiplyAdd4(_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1)), row1,
+                                            _mm_mul_ps(_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0)), row0));
+            const __m128 high = MultiplyAdd4(_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3)), row3,
+                                             _mm_mul_ps(_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+            return _mm_add_ps(low, high);
+        }
+
+        //	4 float lanes with SSE2. LoadStrided reads base[0], base[stride] ... which turns an array of vectors
+        //	into one register per component. Max gives right when either side is NaN, on every width.
+        //	FlipSign negates the lanes of vector whose sign lane has the sign bit set, FlipSign(x, x) is the absolute value.
+        struct Float4Lanes
+        {
+            using Register = __m128;
+            static constexpr unsigned int Width = 4;
+
+            static Register Load(const float* values) { return _mm_loadu_ps(values); }
+            static void Store(float* values, Register vector) { _mm_storeu_ps(values, vector); }
+            static Register Set(float value) { return _mm_set1_ps(value); }
+            static Register Add(Register left, Register right) { return _mm_add_ps(left, right); }
+            static Register Subtract(Register left, Register right) { return _mm_sub_ps(left, right); }
+            static Register Multiply(Register left, Register right) { return _mm_mul_ps(left, right); }
+            static Register Divide(Register left, Register right) { return _mm_div_ps(left, right); }
+            static Register MultiplyAdd(Register left, Register right, Register addend) { return _mm_add_ps(_mm_mul_ps(left, right), addend); }
+            static Register Sqrt(Register vector) { return _mm_sqrt_ps(vector); }
+            static Register Max(Register left, Register right) { return _mm_max_ps(left, right); }
+            static Register FlipSign(Register vector, Register sign) { return _mm_xor_ps(vector, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+            static Register InverseSqrtFast(Register vector) { return InverseSqrtFast4(vector); }
+
+            static Register LoadStrided(const float* base, unsigned int stride)
+            {
+                return _mm_setr_ps(base[0], base[stride], base[stride * 2], base[stride * 3]);
+            }
+
+            static void StoreStrided(float* base, unsigned int stride, Register vector)
+            {
+                alignas(16) float lanes[Width];
+                _mm_store_ps(lanes, vector);
+                for (unsigned int lane = 0; lane < Width; lane++)
+                {
+                    base[lane * stride] = lanes[lane];
+                }
+            }
+
+            //	Non-temporal store, values has to be 16 byte aligned. The writer has to call _mm_sfence before others read.
+            static void Stream(float* values, Register vector) { _mm_stream_ps(values, vector); }
+
+            //	Width Vector2 from 2 * Width consecutive floats into one register per component.
+            static void LoadInterleaved2(const float* values, Register& x, Register& y)
+            {
+                const __m128 first = _mm_loadu_ps(values);
+                const __m128 second = _mm_loadu_ps(values + 4);
+                x = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+                y = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+            }
+
+            static void StoreInterleaved2(float* values, Register x, Register y)
+            {
+                _mm_storeu_ps(values, _mm_unpacklo_ps(x, y));
+                _mm_storeu_ps(values + 4, _mm_unpackhi_ps(x, y));
+            }
+
+            //	Width Vector3 from 3 * Width consecutive floats into one register per component, with shuffles instead of gathers.
+            static void LoadInterleaved3(const float* values, Register& x, Register& y, Register& z)
+            {
+                const __m128 first = _mm_loadu_ps(values);
+                const __m128 second = _mm_loadu_ps(values + 4);
+                const __m128 third = _mm_loadu_ps(values + 8);
+                const __m128 xy = _mm_shuffle_ps(second, third, _MM_SHUFFLE(2, 1, 3, 2));
+                const __m128 yz = _mm_shuffle_ps(first, second, _MM_SHUFFLE(1, 0, 2, 1));
+                x = _mm_shuffle_ps(first, xy, _MM_SHUFFLE(2, 0, 3, 0));
+                y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                z = _mm_shuffle_ps(yz, third, _MM_SHUFFLE(3, 0, 3, 1));
+            }
+
+            //	Reverse of LoadInterleaved3. TStream uses non-temporal stores, which need values to be 16 byte aligned.
+            template <bool TStream = false>
+            static void StoreInterleaved3(float* values, Register x, Register y, Register z)
+            {
+                const __m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+                const __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+                StoreOrStream<TStream>(values, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+                StoreOrStream<TStream>(values + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+                StoreOrStream<TStream>(values + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+
+            //	Width Vector4 from 4 * Width consecutive floats into one register per component.
+            static void LoadInterleaved4(const float* values, Register& x, Register& y, Register& z, Register& w)
+            {
+                x = _mm_loadu_ps(values);
+                y = _mm_loadu_ps(values + 4);
+                z = _mm_loadu_ps(values + 8);
+                w = _mm_loadu_ps(values + 12);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+            }
+
+            template <bool TStream = false>
+            static void StoreInterleaved4(float* values, Register x, Register y, Register z, Register w)
+            {
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+                StoreOrStream<TStream>(values, x);
+                StoreOrStream<TStream>(values + 4, y);
+                StoreOrStream<TStream>(values + 8, z);
+                StoreOrStream<TStream>(values + 12, w);
+            }
+
+            //	Vector4 i = (x[i], y[i], z[i], w[i]) goes to values + i * stride. (One row of Width consecutive matrices)
+            static void StoreStrided4(float* values, unsigned int stride, Register x, Register y, Register z, Register w)
+            {
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+                _mm_storeu_ps(values, x);
+                _mm_storeu_ps(values + stride, y);
+                _mm_storeu_ps(values + stride * 2, z);
+                _mm_storeu_ps(values + stride * 3, w);
+            }
+
+            template <bool TStream>
+            static void StoreOrStream(float* values, Register vector)
+            {
+                if constexpr (TStream)
+                {
+                    _mm_stream_ps(values, vector);
+                }
+                else
+                {
+                    _mm_storeu_ps(values, vector);
+                }
+            }
+        };
+
+        //	8 float lanes with AVX2 and FMA. Strided loads are gathers, AVX2 has no scatter so stores go through the stack.
+        struct Float8Lanes
+        {
+            using Register = __m256;
+            static constexpr unsigned int Width = 8;
+
+            ENGINE_TARGET_AVX2 static Register Load(const float* values) { return _mm256_loadu_ps(values); }
+            ENGINE_TARGET_AVX2 static void Store(float* values, Register vector) { _mm256_storeu_ps(values, vector); }
+            ENGINE_TARGET_AVX2 static Register Set(float value) { return _mm256_set1_ps(value); }
+            ENGINE_TARGET_AVX2 static Register Add(Register left, Register right) { return _mm256_add_ps(left, right); }
+            ENGINE_TARGET_AVX2 static Register Subtract(Register left, Register right) { return _mm256_sub_ps(left, right); }
+            ENGINE_TARGET_AVX2 static Register Multiply(Register left, Register right) { return _mm256_mul_ps(left, right); }
+            ENGINE_TARGET_AVX2 static Register Divide(Register left, Register right) { return _mm256_div_ps(left, right); }
+            ENGINE_TARGET_AVX2 static Register MultiplyAdd(Register left, Register right, Register addend) { return _mm256_fmadd_ps(left, right, addend); }
+            ENGINE_TARGET_AVX2 static Register Sqrt(Register vector) { return _mm256_sqrt_ps(vector); }
+            ENGINE_TARGET_AVX2 static Register Max(Register left, Register right) { return _mm256_max_ps(left, right); }
+            ENGINE_TARGET_AVX2 static Register FlipSign(Register vector, Register sign) { return _mm256_xor_ps(vector, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+
+            ENGINE_TARGET_AVX2 static Register InverseSqrtFast(Register vector)
+            {
+                const __m256 estimate = _mm256_rsqrt_ps(vector);
+                const __m256 halfVector = _mm256_mul_ps(_mm256_set1_ps(0.5f), vector);
+                return _mm256_mul_ps(estimate, _mm256_fnmadd_ps(halfVector, _mm256_mul_ps(estimate, estimate), _mm256_set1_ps(1.5f)));
+            }
+
+            ENGINE_TARGET_AVX2 static Register LoadStrided(const float* base, unsigned int stride)
+            {
+                const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+                return _mm256_i32gather_ps(base, offsets, sizeof(float));
+            }
+
+            ENGINE_TARGET_AVX2 static void StoreStrided(float* base, unsigned int stride, Register vector)
+            {
+                alignas(32) float lanes[Width];
+                _mm256_store_ps(lanes, vector);
+                for (unsigned int lane = 0; lane < Width; lane++)
+                {
+                    base[lane * stride] = lanes[lane];
+                }
+            }
+
+            //	Non-temporal store, values has to be 32 byte aligned. The writer has to call _mm_sfence before others read.
+            ENGINE_TARGET_AVX2 static void Stream(float* values, Register vector) { _mm256_stream_ps(values, vector); }
+
+            //	The shuffles only work inside 128 bit halves, so the low half gets vectors 0-3 and the high half 4-7,
+            //	then the same shuffles as Float4Lanes run on both halves at once.
+            ENGINE_TARGET_AVX2 static void LoadInterleaved2(const float* values, Register& x, Register& y)
+            {
+                const __m256 first = Combine(_mm_loadu_ps(values), _mm_loadu_ps(values + 8));
+                const __m256 second = Combine(_mm_loadu_ps(values + 4), _mm_loadu_ps(values + 12));
+                x = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+                y = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+            }
+
+            ENGINE_TARGET_AVX2 static void StoreInterleaved2(float* values, Register x, Register y)
+            {
+                const __m256 low = _mm256_unpacklo_ps(x, y);
+                const __m256 high = _mm256_unpackhi_ps(x, y);
+                _mm256_storeu_ps(values, _mm256_permute2f128_ps(low, high, 0x20));
+                _mm256_storeu_ps(values + 8, _mm256_permute2f128_ps(low, high, 0x31));
+            }
+
+            ENGINE_TARGET_AVX2 static void LoadInterleaved3(const float* values, Register& x, Register& y, Register& z)
+            {
+                const __m256 first = Combine(_mm_loadu_ps(values), _mm_loadu_ps(values + 12));
+                const __m256 second = Combine(_mm_loadu_ps(values + 4), _mm_loadu_ps(values + 16));
+                const __m256 third = Combine(_mm_loadu_ps(values + 8), _mm_loadu_ps(values + 20));
+                const __m256 xy = _mm256_shuffle_ps(second, third, _MM_SHUFFLE(2, 1, 3, 2));
+                const __m256 yz = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(1, 0, 2, 1));
+                x = _mm256_shuffle_ps(first, xy, _MM_SHUFFLE(2, 0, 3, 0));
+                y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                z = _mm256_shuffle_ps(yz, third, _MM_SHUFFLE(3, 0, 3, 1));
+            }
+
+            //	TStream uses non-temporal stores, which need values to be 32 byte aligned.
+            template <bool TStream = false>
+            ENGINE_TARGET_AVX2 static void StoreInterleaved3(float* values, Register x, Register y, Register z)
+            {
+                const __m256 xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+                const __m256 zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+                const __m256 first = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 second = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                const __m256 third = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+                StoreOrStream<TStream>(values, _mm256_permute2f128_ps(first, second, 0x20));
+                StoreOrStream<TStream>(values + 8, _mm256_permute2f128_ps(third, first, 0x30));
+                StoreOrStream<TStream>(values + 16, _mm256_permute2f128_ps(second, third, 0x31));
+            }
+
+            //	Same halves as LoadInterleaved3, vector k and k + 4 share a register before the in half transpose.
+            ENGINE_TARGET_AVX2 static void LoadInterleaved4(const float* values, Register& x, Register& y, Register& z, Register& w)
+            {
+                x = Combine(_mm_loadu_ps(values), _mm_loadu_ps(values + 16));
+                y = Combine(_mm_loadu_ps(values + 4), _mm_loadu_ps(values + 20));
+                z = Combine(_mm_loadu_ps(values + 8), _mm_loadu_ps(values + 24));
+                w = Combine(_mm_loadu_ps(values + 12), _mm_loadu_ps(values + 28));
+                Transpose4(x, y, z, w);
+            }
+
+            template <bool TStream = false>
+            ENGINE_TARGET_AVX2 static void StoreInterleaved4(float* values, Register x, Register y, Register z, Register w)
+            {
+                Transpose4(x, y, z, w);
+                StoreOrStream<TStream>(values, _mm256_permute2f128_ps(x, y, 0x20));
+                StoreOrStream<TStream>(values + 8, _mm256_permute2f128_ps(z, w, 0x20));
+                StoreOrStream<TStream>(values + 16, _mm256_permute2f128_ps(x, y, 0x31));
+                StoreOrStream<TStream>(values + 24, _mm256_permute2f128_ps(z, w, 0x31));
+            }
+
+            //	After the in half transpose a register holds vector k in its low half and vector k + 4 in its high half.
+            ENGINE_TARGET_AVX2 static void StoreStrided4(float* values, unsigned int stride, Register x, Register y, Register z, Register w)
+            {
+                Transpose4(x, y, z, w);
+                _mm_storeu_ps(values, _mm256_castps256_ps128(x));
+                _mm_storeu_ps(values + stride, _mm256_castps256_ps128(y));
+                _mm_storeu_ps(values + stride * 2, _mm256_castps256_ps128(z));
+                _mm_storeu_ps(values + stride * 3, _mm256_castps256_ps128(w));
+                _mm_storeu_ps(values + stride * 4, _mm256_extractf128_ps(x, 1));
+                _mm_storeu_ps(values + stride * 5, _mm256_extractf128_ps(y, 1));
+                _mm_storeu_ps(values + stride * 6, _mm256_extractf128_ps(z, 1));
+                _mm_storeu_ps(values + stride * 7, _mm256_extractf128_ps(w, 1));
+            }
+
+            ENGINE_TARGET_AVX2 static Register Combine(__m128 low, __m128 high)
+            {
+                return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+            }
+
+            //	_MM_TRANSPOSE4_PS on both 128 bit halves.
+            ENGINE_TARGET_AVX2 static void Transpose4(Register& x, Register& y, Register& z, Register& w)
+            {
+                const __m256 low0 = _mm256_unpacklo_ps(x, y);
+                const __m256 low1 = _mm256_unpacklo_ps(z, w);
+                const __m256 high0 = _mm256_unpackhi_ps(x, y);
+                const __m256 high1 = _mm256_unpackhi_ps(z, w);
+                x = _mm256_shuffle_ps(low0, low1, _MM_SHUFFLE(1, 0, 1, 0));
+                y = _mm256_shuffle_ps(low0, low1, _MM_SHUFFLE(3, 2, 3, 2));
+                z = _mm256_shuffle_ps(high0, high1, _MM_SHUFFLE(1, 0, 1, 0));
+                w = _mm256_shuffle_ps(high0, high1, _MM_SHUFFLE(3, 2, 3, 2));
+            }
+
+            template <bool TStream>
+            ENGINE_TARGET_AVX2 static void StoreOrStream(float* values, Register vector)
+            {
+                if constexpr (TStream)
+                {
+                    _mm256_stream_ps(values, vector);
+                }
+                else
+                {
+                    _mm256_storeu_ps(values, vector);
+                }
+            }
+        };
+
+        //	16 float lanes with AVX-512F, strided loads and stores are gathers and scatters.
+        //	The interleaved loads and stores use two register permutes instead, a permutex2var picks from the first
+        //	32 floats and a masked permutexvar fills the lanes which come from the rest. Both read only the low bits
+        //	of an index, so one index vector serves both steps.
+        struct Float16Lanes
+        {
+            using Register = __m512;
+            static constexpr unsigned int Width = 16;
+
+            ENGINE_TARGET_AVX512 static Register Load(const float* values) { return _mm512_loadu_ps(values); }
+            ENGINE_TARGET_AVX512 static void Store(float* values, Register vector) { _mm512_storeu_ps(values, vector); }
+            ENGINE_TARGET_AVX512 static Register Set(float value) { return _mm512_set1_ps(value); }
+            ENGINE_TARGET_AVX512 static Register Add(Register left, Register right) { return _mm512_add_ps(left, right); }
+            ENGINE_TARGET_AVX512 static Register Subtract(Register left, Register right) { return _mm512_sub_ps(left, right); }
+            ENGINE_TARGET_AVX512 static Register Multiply(Register left, Register right) { return _mm512_mul_ps(left, right); }
+            ENGINE_TARGET_AVX512 static Register Divide(Register left, Register right) { return _mm512_div_ps(left, right); }
+            ENGINE_TARGET_AVX512 static Register MultiplyAdd(Register left, Register right, Register addend) { return _mm512_fmadd_ps(left, right, addend); }
+            ENGINE_TARGET_AVX512 static Register Sqrt(Register vector) { return _mm512_sqrt_ps(vector); }
+            ENGINE_TARGET_AVX512 static Register Max(Register left, Register right) { return _mm512_max_ps(left, right); }
+
+            //	AVX-512F has no float bitwise operations, they are in AVX-512DQ, so the sign bit goes through the integer ones.
+            ENGINE_TARGET_AVX512 static Register FlipSign(Register vector, Register sign)
+            {
+                const __m512i signBits = _mm512_and_epi32(_mm512_castps_si512(sign), _mm512_set1_epi32(static_cast<int>(0x80000000u)));
+                return _mm512_castsi512_ps(_mm512_xor_epi32(_mm512_castps_si512(vector), signBits));
+            }
+
+            //	rsqrt14 already has 14 bits, the Newton-Raphson step takes it to the precision of the other widths.
+            ENGINE_TARGET_AVX512 static Register InverseSqrtFast(Register vector)
+            {
+                const __m512 estimate = _mm512_rsqrt14_ps(vector);
+                const __m512 halfVector = _mm512_mul_ps(_mm512_set1_ps(0.5f), vector);
+                return _mm512_mul_ps(estimate, _mm512_fnmadd_ps(halfVector, _mm512_mul_ps(estimate, estimate), _mm512_set1_ps(1.5f)));
+            }
+
+            ENGINE_TARGET_AVX512 static __m512i StridedOffsets(unsigned int stride)
+            {
+                return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(static_cast<int>(stride)));
+            }
+
+            ENGINE_TARGET_AVX512 static Register LoadStrided(const float* base, unsigned int stride)
+            {
+                return _mm512_i32gather_ps(StridedOffsets(stride), base, sizeof(float));
+            }
+
+            ENGINE_TARGET_AVX512 static void StoreStrided(float* base, unsigned int stride, Register vector)
+            {
+                _mm512_i32scatter_ps(base, StridedOffsets(stride), vector, sizeof(float));
+            }
+
+            ENGINE_TARGET_AVX512 static void LoadInterleaved2(const float* values, Register& x, Register& y)
+            {
+                const __m512 first = _mm512_loadu_ps(values);
+                const __m512 second = _mm512_loadu_ps(values + 16);
+                const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+                x = _mm512_permutex2var_ps(first, even, second);
+                y = _mm512_permutex2var_ps(first, _mm512_add_epi32(even, _mm512_set1_epi32(1)), second);
+            }
+
+            ENGINE_TARGET_AVX512 static void StoreInterleaved2(float* values, Register x, Register y)
+            {
+                _mm512_storeu_ps(values, _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23), y));
+                _mm512_storeu_ps(values + 16, _mm512_permutex2var_ps(x, _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31), y));
+            }
+
+            //	Component c of vector i is float 3 * i + c, the lanes from float 32 on come from third.
+            ENGINE_TARGET_AVX512 static void LoadInterleaved3(const float* values, Register& x, Register& y, Register& z)
+            {
+                const __m512 first = _mm512_loadu_ps(values);
+                const __m512 second = _mm512_loadu_ps(values + 16);
+                const __m512 third = _mm512_loadu_ps(values + 32);
+                const __m512i indexX = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45);
+                const __m512i indexY = _mm512_add_epi32(indexX, _mm512_set1_epi32(1));
+                const __m512i indexZ = _mm512_add_epi32(indexX, _mm512_set1_epi32(2));
+                x = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(first, indexX, second), 0xF800, indexX, third);
+                y = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(first, indexY, second), 0xF800, indexY, third);
+                z = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(first, indexZ, second), 0xFC00, indexZ, third);
+            }
+
+            //	Float j of an output is a component of vector j / 3, X lanes index x, Y lanes index 16 + y and the
+            //	masked Z lanes are filled from z.
+            ENGINE_TARGET_AVX512 static void StoreInterleaved3(float* values, Register x, Register y, Register z)
+            {
+                const __m512i first = _mm512_setr_epi32(0, 16, 0, 1, 17, 1, 2, 18, 2, 3, 19, 3, 4, 20, 4, 5);
+                const __m512i second = _mm512_setr_epi32(21, 5, 6, 22, 6, 7, 23, 7, 8, 24, 8, 9, 25, 9, 10, 26);
+                const __m512i third = _mm512_setr_epi32(10, 11, 27, 11, 12, 28, 12, 13, 29, 13, 14, 30, 14, 15, 31, 15);
+                _mm512_storeu_ps(values, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x, first, y), 0x4924, first, z));
+                _mm512_storeu_ps(values + 16, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x, second, y), 0x2492, second, z));
+                _mm512_storeu_ps(values + 32, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(x, third, y), 0x9249, third, z));
+            }
+
+            //	First pass splits X and Y from Z and W for vectors 0-7 and 8-15, the second joins the halves.
+            ENGINE_TARGET_AVX512 static void LoadInterleaved4(const float* values, Register& x, Register& y, Register& z, Register& w)
+            {
+                const __m512i evenPairs = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 1, 5, 9, 13, 17, 21, 25, 29);
+                const __m512i oddPairs = _mm512_add_epi32(evenPairs, _mm512_set1_epi32(2));
+                const __m512 first = _mm512_loadu_ps(values);
+                const __m512 second = _mm512_loadu_ps(values + 16);
+                const __m512 third = _mm512_loadu_ps(values + 32);
+                const __m512 fourth = _mm512_loadu_ps(values + 48);
+                const __m512 lowXY = _mm512_permutex2var_ps(first, evenPairs, second);
+                const __m512 lowZW = _mm512_permutex2var_ps(first, oddPairs, second);
+                const __m512 highXY = _mm512_permutex2var_ps(third, evenPairs, fourth);
+                const __m512 highZW = _mm512_permutex2var_ps(third, oddPairs, fourth);
+
+                const __m512i lowHalves = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23);
+                const __m512i highHalves = _mm512_add_epi32(lowHalves, _mm512_set1_epi32(8));
+                x = _mm512_permutex2var_ps(lowXY, lowHalves, highXY);
+                y = _mm512_permutex2var_ps(lowXY, highHalves, highXY);
+                z = _mm512_permutex2var_ps(lowZW, lowHalves, highZW);
+                w = _mm512_permutex2var_ps(lowZW, highHalves, highZW);
+            }
+
+            ENGINE_TARGET_AVX512 static void StoreInterleaved4(float* values, Register x, Register y, Register z, Register w)
+            {
+                const __m512i lowHalves = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23);
+                const __m512i highHalves = _mm512_add_epi32(lowHalves, _mm512_set1_epi32(8));
+                const __m512 lowXY = _mm512_permutex2var_ps(x, lowHalves, y);
+                const __m512 highXY = _mm512_permutex2var_ps(x, highHalves, y);
+                const __m512 lowZW = _mm512_permutex2var_ps(z, lowHalves, w);
+                const __m512 highZW = _mm512_permutex2var_ps(z, highHalves, w);
+
+                const __m512i vectors = _mm512_setr_epi32(0, 8, 16, 24, 1, 9, 17, 25, 2, 10, 18, 26, 3, 11, 19, 27);
+                const __m512i nextVectors = _mm512_add_epi32(vectors, _mm512_set1_epi32(4));
+                _mm512_storeu_ps(values, _mm512_permutex2var_ps(lowXY, vectors, lowZW));
+                _mm512_storeu_ps(values + 16, _mm512_permutex2var_ps(lowXY, nextVectors, lowZW));
+                _mm512_storeu_ps(values + 32, _mm512_permutex2var_ps(highXY, vectors, highZW));
+                _mm512_storeu_ps(values + 48, _mm512_permutex2var_ps(highXY, nextVectors, highZW));
+            }
+        };
+    }
+}
+#endif
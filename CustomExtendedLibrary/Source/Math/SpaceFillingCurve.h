@@ -0,0 +1,439 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is the space filling curve library which maps integer grid coordinates to one key, so that points
+ *  which are close in space are mostly close in memory after sorting by that key.
+ *
+ *  Current capabilities:
+ *  -   Morton (Z-order) encode and decode for Vector2 (32 bits per axis) and Vector3 (21 bits per axis).
+ *      pdep and pext when the build targets BMI2 (ENGINE_SIMD_BMI2), shifts and masks otherwise, same keys.
+ *  -   Hilbert encode and decode for Vector2 and Vector3 with a chosen order. (Bits per axis)
+ *      Consecutive Hilbert keys are always neighbouring cells, Morton keys jump at every quadrant border.
+ *  -   SortedOrder and Reorder, which sort any Array by a key function with an LSD radix sort.
+ *      Equal keys keep their order, key computation and the gather run through Parallel::For when multithreaded.
+ *
+ *  Coordinates are used as unsigned bits. Negative coordinates land at the far end of the curve,
+ *  so offset them by the minimum of the grid first. Bits above the per axis limit are ignored.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Core/CoreAPI.h"
+#include "Core/Types.h"
+#include "Math/SIMD.h"
+#include "Vectors/Vector2.h"
+#include "Vectors/Vector3.h"
+
+#include <type_traits>
+#include <utility>
+
+namespace Engine
+{
+    class SpaceFillingCurve
+    {
+    public:
+        SpaceFillingCurve() = delete;
+        ~SpaceFillingCurve() = delete;
+
+        //	Bits of each axis which fit in a 64 bit key.
+        static constexpr unsigned int MaximumOrder2 = 32;
+        static constexpr unsigned int MaximumOrder3 = 21;
+
+        //	Each thread gets at least this many elements, so smaller inputs stay on the calling thread.
+        static constexpr unsigned int MultithreadedChunkLength = 16384;
+
+        //	Interleaves the bits of the coordinates, X is the lowest bit of every group.
+        template <typename TValue>
+        FORCEINLINE static uint64 MortonEncode(const Vector2<TValue>& coordinates);
+
+        template <typename TValue>
+        FORCEINLINE static uint64 MortonEncode(const Vector3<TValue>& coordinates);
+
+        //	Gives the coordinates back from a Morton key.
+        template <typename TValue>
+        FORCEINLINE static Vector2<TValue> MortonDecode2(uint64 key);
+
+        template <typename TValue>
+        FORCEINLINE static Vector3<TValue> MortonDecode3(uint64 key);
+
+        //	Position along the Hilbert curve which covers a 2^order cell wide square or cube.
+        //	order goes from 1 to MaximumOrder2 or MaximumOrder3, anything else throws.
+        template <typename TValue>
+        static uint64 HilbertEncode(const Vector2<TValue>& coordinates, unsigned int order = MaximumOrder2);
+
+        template <typename TValue>
+        static uint64 HilbertEncode(const Vector3<TValue>& coordinates, unsigned int order = MaximumOrder3);
+
+        //	Gives the coordinates back from a Hilbert key of the same order.
+        template <typename TValue>
+        static Vector2<TValue> HilbertDecode2(uint64 key, unsigned int order = MaximumOrder2);
+
+        template <typename TValue>
+        static Vector3<TValue> HilbertDecode3(uint64 key, unsigned int order = MaximumOrder3);
+
+        //	Replaces order with the indices of elements sorted by keyOf(element), which gives a uint64.
+        //	It is the remap table for anything else which refers to the elements by index.
+        template <typename TElement, typename TAllocator, unsigned int TAlignment, typename TKeyFunction, typename TOrderAllocator, unsigned int TOrderAlignment>
+        static void SortedOrder(const Array<TElement, TAllocator, TAlignment>& elements, TKeyFunction keyOf, Array<unsigned int, TOrderAllocator, TOrderAlignment>& order,
+                                bool multithreaded = false);
+
+        //	Sorts elements by keyOf(element). For example, to lay a voxel list out along the Morton curve:
+        //	SpaceFillingCurve::Reorder(voxels, [](const Vector3<int32>& voxel) { return SpaceFillingCurve::MortonEncode(voxel); });
+        //	Elements have to be default constructible and movable.
+        template <typename TElement, typename TAllocator, unsigned int TAlignment, typename TKeyFunction>
+        static void Reorder(Array<TElement, TAllocator, TAlignment>& elements, TKeyFunction keyOf, bool multithreaded = false);
+
+    private:
+        struct KeyedIndex
+        {
+            uint64 Key;
+            unsigned int Index;
+        };
+
+        //	Spreads the low 32 bits to the even bits, and gathers them back.
+        static uint64 SpreadBy1(uint64 value);
+        static uint64 CompactBy1(uint64 value);
+
+        //	Spreads the low 21 bits to every third bit, and gathers them back.
+        static uint64 SpreadBy2(uint64 value);
+        static uint64 CompactBy2(uint64 value);
+
+        //	Skilling's "Programming the Hilbert curve". Turns coordinates into the transposed Hilbert key, whose
+        //	interleaved bits are the key with coordinates[0] as the most significant bit of every group, and back.
+        template <unsigned int TDimensions>
+        static void AxesToTranspose(uint32 (&coordinates)[TDimensions], unsigned int order);
+
+        template <unsigned int TDimensions>
+        static void TransposeToAxes(uint32 (&coordinates)[TDimensions], unsigned int order);
+
+        //	Stable sort by Key, one counting pass per byte which is not the same in every key.
+        static void RadixSort(Array<KeyedIndex>& entries, Array<KeyedIndex>& scratch);
+
+        template <typename TFunction>
+        static void Split(unsigned int count, bool multithreaded, TFunction function);
+    };
+
+    template <typename TValue>
+    uint64 SpaceFillingCurve::MortonEncode(const Vector2<TValue>& coordinates)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        return SpreadBy1(static_cast<uint32>(coordinates.X)) | SpreadBy1(static_cast<uint32>(coordinates.Y)) << 1;
+    }
+
+    template <typename TValue>
+    uint64 SpaceFillingCurve::MortonEncode(const Vector3<TValue>& coordinates)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        return SpreadBy2(static_cast<uint32>(coordinates.X)) | SpreadBy2(static_cast<uint32>(coordinates.Y)) << 1 |
+               SpreadBy2(static_cast<uint32>(coordinates.Z)) << 2;
+    }
+
+    template <typename TValue>
+    Vector2<TValue> SpaceFillingCurve::MortonDecode2(uint64 key)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        return Vector2<TValue>(static_cast<TValue>(CompactBy1(key)), static_cast<TValue>(CompactBy1(key >> 1)));
+    }
+
+    template <typename TValue>
+    Vector3<TValue> SpaceFillingCurve::MortonDecode3(uint64 key)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        return Vector3<TValue>(static_cast<TValue>(CompactBy2(key)), static_cast<TValue>(CompactBy2(key >> 1)), static_cast<TValue>(CompactBy2(key >> 2)));
+    }
+
+    template <typename TValue>
+    uint64 SpaceFillingCurve::HilbertEncode(const Vector2<TValue>& coordinates, unsigned int order)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        if (order == 0 || order > MaximumOrder2)
+        {
+            throw "Out of Range";
+        }
+
+        const uint32 mask = order >= 32 ? ~0u : (1u << order) - 1;
+        uint32 transposed[2] = { static_cast<uint32>(coordinates.X) & mask, static_cast<uint32>(coordinates.Y) & mask };
+        AxesToTranspose(transposed, order);
+        return SpreadBy1(transposed[1]) | SpreadBy1(transposed[0]) << 1;
+    }
+
+    template <typename TValue>
+    uint64 SpaceFillingCurve::HilbertEncode(const Vector3<TValue>& coordinates, unsigned int order)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        if (order == 0 || order > MaximumOrder3)
+        {
+            throw "Out of Range";
+        }
+
+        const uint32 mask = (1u << order) - 1;
+        uint32 transposed[3] = { static_cast<uint32>(coordinates.X) & mask, static_cast<uint32>(coordinates.Y) & mask, static_cast<uint32>(coordinates.Z) & mask };
+        AxesToTranspose(transposed, order);
+        return SpreadBy2(transposed[2]) | SpreadBy2(transposed[1]) << 1 | SpreadBy2(transposed[0]) << 2;
+    }
+
+    template <typename TValue>
+    Vector2<TValue> SpaceFillingCurve::HilbertDecode2(uint64 key, unsigned int order)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        if (order == 0 || order > MaximumOrder2)
+        {
+            throw "Out of Range";
+        }
+
+        uint32 coordinates[2] = { static_cast<uint32>(CompactBy1(key >> 1)), static_cast<uint32>(CompactBy1(key)) };
+        TransposeToAxes(coordinates, order);
+        return Vector2<TValue>(static_cast<TValue>(coordinates[0]), static_cast<TValue>(coordinates[1]));
+    }
+
+    template <typename TValue>
+    Vector3<TValue> SpaceFillingCurve::HilbertDecode3(uint64 key, unsigned int order)
+    {
+        static_assert(std::is_integral_v<TValue>, "Space filling curves work on integer coordinates");
+        if (order == 0 || order > MaximumOrder3)
+        {
+            throw "Out of Range";
+        }
+
+        uint32 coordinates[3] = { static_cast<uint32>(CompactBy2(key >> 2)), static_cast<uint32>(CompactBy2(key >> 1)), static_cast<uint32>(CompactBy2(key)) };
+        TransposeToAxes(coordinates, order);
+        return Vector3<TValue>(static_cast<TValue>(coordinates[0]), static_cast<TValue>(coordinates[1]), static_cast<TValue>(coordinates[2]));
+    }
+
+    template <typename TElement, typename TAllocator, unsigned int TAlignment, typename TKeyFunction, typename TOrderAllocator, unsigned int TOrderAlignment>
+    void SpaceFillingCurve::SortedOrder(const Array<TElement, TAllocator, TAlignment>& elements, TKeyFunction keyOf, Array<unsigned int, TOrderAllocator, TOrderAlignment>& order,
+                                        bool multithreaded)
+    {
+        const unsigned int count = elements.Length();
+
+        Array<KeyedIndex> entries;
+        entries.Resize(count);
+        Split(count, multithreaded, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                entries[i] = KeyedIndex{ static_cast<uint64>(keyOf(elements[i])), i };
+            }
+        });
+
+        Array<KeyedIndex> scratch;
+        RadixSort(entries, scratch);
+
+        order.Resize(count);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            order[i] = entries[i].Index;
+        }
+    }
+
+    template <typename TElement, typename TAllocator, unsigned int TAlignment, typename TKeyFunction>
+    void SpaceFillingCurve::Reorder(Array<TElement, TAllocator, TAlignment>& elements, TKeyFunction keyOf, bool multithreaded)
+    {
+        Array<unsigned int> order;
+        SortedOrder(elements, keyOf, order, multithreaded);
+
+        Array<TElement, TAllocator, TAlignment> reordered;
+        reordered.Resize(elements.Length());
+        Split(elements.Length(), multithreaded, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                reordered[i] = std::move(elements[order[i]]);
+            }
+        });
+        elements = std::move(reordered);
+    }
+
+    inline uint64 SpaceFillingCurve::SpreadBy1(uint64 value)
+    {
+#if ENGINE_SIMD_BMI2
+        return _pdep_u64(value, 0x5555555555555555ull);
+#else
+        value &= 0x00000000FFFFFFFFull;
+        value = (value | value << 16) & 0x0000FFFF0000FFFFull;
+        value = (value | value << 8) & 0x00FF00FF00FF00FFull;
+        value = (value | value << 4) & 0x0F0F0F0F0F0F0F0Full;
+        value = (value | value << 2) & 0x3333333333333333ull;
+        return (value | value << 1) & 0x5555555555555555ull;
+#endif
+    }
+
+    inline uint64 SpaceFillingCurve::CompactBy1(uint64 value)
+    {
+#if ENGINE_SIMD_BMI2
+        return _pext_u64(value, 0x5555555555555555ull);
+#else
+        value &= 0x5555555555555555ull;
+        value = (value | value >> 1) & 0x3333333333333333ull;
+        value = (value | value >> 2) & 0x0F0F0F0F0F0F0F0Full;
+        value = (value | value >> 4) & 0x00FF00FF00FF00FFull;
+        value = (value | value >> 8) & 0x0000FFFF0000FFFFull;
+        return (value | value >> 16) & 0x00000000FFFFFFFFull;
+#endif
+    }
+
+    inline uint64 SpaceFillingCurve::SpreadBy2(uint64 value)
+    {
+#if ENGINE_SIMD_BMI2
+        return _pdep_u64(value, 0x1249249249249249ull);
+#else
+        value &= 0x00000000001FFFFFull;
+        value = (value | value << 32) & 0x001F00000000FFFFull;
+        value = (value | value << 16) & 0x001F0000FF0000FFull;
+        value = (value | value << 8) & 0x100F00F00F00F00Full;
+        value = (value | value << 4) & 0x10C30C30C30C30C3ull;
+        return (value | value << 2) & 0x1249249249249249ull;
+#endif
+    }
+
+    inline uint64 SpaceFillingCurve::CompactBy2(uint64 value)
+    {
+#if ENGINE_SIMD_BMI2
+        return _pext_u64(value, 0x1249249249249249ull);
+#else
+        value &= 0x1249249249249249ull;
+        value = (value | value >> 2) & 0x10C30C30C30C30C3ull;
+        value = (value | value >> 4) & 0x100F00F00F00F00Full;
+        value = (value | value >> 8) & 0x001F0000FF0000FFull;
+        value = (value | value >> 16) & 0x001F00000000FFFFull;
+        return (value | value >> 32) & 0x00000000001FFFFFull;
+#endif
+    }
+
+    template <unsigned int TDimensions>
+    void SpaceFillingCurve::AxesToTranspose(uint32 (&coordinates)[TDimensions], unsigned int order)
+    {
+        //	Inverse undo, from the top bit down.
+        for (uint32 bit = 1u << (order - 1); bit > 1; bit >>= 1)
+        {
+            const uint32 lowerBits = bit - 1;
+            for (unsigned int i = 0; i < TDimensions; i++)
+            {
+                if (coordinates[i] & bit)
+                {
+                    coordinates[0] ^= lowerBits;
+                }
+                else
+                {
+                    const uint32 swapped = (coordinates[0] ^ coordinates[i]) & lowerBits;
+                    coordinates[0] ^= swapped;
+                    coordinates[i] ^= swapped;
+                }
+            }
+        }
+
+        //	Gray encode.
+        for (unsigned int i = 1; i < TDimensions; i++)
+        {
+            coordinates[i] ^= coordinates[i - 1];
+        }
+
+        uint32 flip = 0;
+        for (uint32 bit = 1u << (order - 1); bit > 1; bit >>= 1)
+        {
+            if (coordinates[TDimensions - 1] & bit)
+            {
+                flip ^= bit - 1;
+            }
+        }
+
+        for (unsigned int i = 0; i < TDimensions; i++)
+        {
+            coordinates[i] ^= flip;
+        }
+    }
+
+    template <unsigned int TDimensions>
+    void SpaceFillingCurve::TransposeToAxes(uint32 (&coordinates)[TDimensions], unsigned int order)
+    {
+        //	Gray decode.
+        const uint32 flip = coordinates[TDimensions - 1] >> 1;
+        for (unsigned int i = TDimensions - 1; i > 0; i--)
+        {
+            coordinates[i] ^= coordinates[i - 1];
+        }
+        coordinates[0] ^= flip;
+
+        //	Undo the excess work, from the bottom bit up.
+        const uint64 end = 1ull << order;
+        for (uint64 bit = 2; bit != end; bit <<= 1)
+        {
+            const uint32 lowerBits = static_cast<uint32>(bit - 1);
+            for (unsigned int i = TDimensions; i-- != 0;)
+            {
+                if (coordinates[i] & static_cast<uint32>(bit))
+                {
+                    coordinates[0] ^= lowerBits;
+                }
+                else
+                {
+                    const uint32 swapped = (coordinates[0] ^ coordinates[i]) & lowerBits;
+                    coordinates[0] ^= swapped;
+                    coordinates[i] ^= swapped;
+                }
+            }
+        }
+    }
+
+    inline void SpaceFillingCurve::RadixSort(Array<KeyedIndex>& entries, Array<KeyedIndex>& scratch)
+    {
+        const unsigned int count = entries.Length();
+        if (count < 2)
+        {
+            return;
+        }
+
+        //	Morton keys of small grids only use a few of the low bytes, the others need no pass.
+        uint64 varyingBits = 0;
+        for (const KeyedIndex& entry : entries)
+        {
+            varyingBits |= entry.Key ^ entries[0].Key;
+        }
+
+        scratch.Resize(count);
+        for (unsigned int shift = 0; shift < 64; shift += 8)
+        {
+            if (((varyingBits >> shift) & 0xFF) == 0)
+            {
+                continue;
+            }
+
+            unsigned int offsets[256] = {};
+            for (const KeyedIndex& entry : entries)
+            {
+                offsets[(entry.Key >> shift) & 0xFF]++;
+            }
+
+            unsigned int start = 0;
+            for (unsigned int& offset : offsets)
+            {
+                const unsigned int length = offset;
+                offset = start;
+                start += length;
+            }
+
+            for (const KeyedIndex& entry : entries)
+            {
+                scratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+            }
+            std::swap(entries, scratch);
+        }
+    }
+
+    template <typename TFunction>
+    void SpaceFillingCurve::Split(unsigned int count, bool multithreaded, TFunction function)
+    {
+        if (multithreaded)
+        {
+            Parallel::For(count, MultithreadedChunkLength, function);
+        }
+        else if (count != 0)
+        {
+            function(0u, count);
+        }
+    }
+}
@@ -0,0 +1,299 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a 3x3 Matrix library for rotation, scale and normal matrices which need no translation.
+ *
+ *  Current capabilities:
+ *  -   Initialization without defining the elements. (Every element is 0, like Matrix4x4)
+ *  -   IdentityMatrix, FromMatrix4x4 (upper 3x3) and ToMatrix4x4.
+ *  -   NormalMatrix of a Matrix4x4. (Inverse transpose of the upper 3x3, keeps normals perpendicular under scale)
+ *  -   Multiplication, Transform of Vector3, Transpose, Determinant, Inverse.
+ *  -   Float multiplication runs on SSE rows, compile time evaluation takes the scalar path.
+ *
+ *  Same conventions as Matrix4x4: row major, vectors are rows (v' = v * M), A * B applies A first.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/CoreAPI.h"
+#include "Core/Types.h"
+#include "Math/SIMD.h"
+#include "Matrix/Matrix4x4.h"
+#include "Vectors/Vector3.h"
+
+namespace Engine
+{
+    template <typename TValue>
+    class Matrix3x3
+    {
+    public:
+        FORCEINLINE static constexpr Matrix3x3 IdentityMatrix();
+
+        //	Upper 3x3 of matrix, the rotation and scale without the translation.
+        FORCEINLINE static constexpr Matrix3x3 FromMatrix4x4(const Matrix4x4<TValue>& matrix);
+
+        //	Inverse transpose of the upper 3x3 of matrix. Normals transformed by it stay perpendicular to
+        //	their surfaces under non-uniform scale, for rotations it is the rotation itself.
+        FORCEINLINE static constexpr Matrix3x3 NormalMatrix(const Matrix4x4<TValue>& matrix);
+
+        constexpr Matrix3x3(
+            const TValue a11, const TValue a12, const TValue a13,
+            const TValue a21, const TValue a22, const TValue a23,
+            const TValue a31, const TValue a32, const TValue a33);
+
+        FORCEINLINE constexpr TValue& operator[](const byte index);
+        FORCEINLINE constexpr const TValue& operator[](const byte index) const;
+
+        //	Matrix3x3 * Matrix3x3. Vectors are rows, so the result applies this matrix first and Other second.
+        FORCEINLINE constexpr Matrix3x3 operator*(const Matrix3x3& Other) const;
+
+        //	Matrix3x3 * Matrix3x3 and overwrites on related Matrix3x3.
+        FORCEINLINE constexpr Matrix3x3& operator*=(const Matrix3x3& Other);
+
+        //	Row vector times the matrix.
+        FORCEINLINE constexpr Engine::Vector3<TValue> Transform(const Engine::Vector3<TValue>& vector) const;
+
+        //	Same matrix in a Matrix4x4 with no translation.
+        FORCEINLINE constexpr Matrix4x4<TValue> ToMatrix4x4() const;
+
+        //	Rows become columns. For rotations it is the inverse.
+        FORCEINLINE constexpr Matrix3x3 Transpose() const;
+
+        FORCEINLINE constexpr TValue Determinant() const;
+
+        //	Cross products of the rows divided by the determinant. A singular matrix gives non-finite elements.
+        FORCEINLINE constexpr Matrix3x3 Inverse() const;
+
+        constexpr Matrix3x3(const TValue value);
+        constexpr Matrix3x3();
+        ~Matrix3x3() = default;
+
+    private:
+        TValue MatrixArray[9];
+    };
+
+    //	Vector3 * Matrix3x3. Vectors are rows.
+    template <typename TValue>
+    FORCEINLINE constexpr Engine::Vector3<TValue> operator*(const Engine::Vector3<TValue>& vector, const Matrix3x3<TValue>& matrix);
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::IdentityMatrix()
+    {
+        return Matrix3x3<TValue>(
+            1, 0, 0,
+            0, 1, 0,
+            0, 0, 1
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::FromMatrix4x4(const Matrix4x4<TValue>& matrix)
+    {
+        return Matrix3x3<TValue>(
+            matrix[0], matrix[1], matrix[2],
+            matrix[4], matrix[5], matrix[6],
+            matrix[8], matrix[9], matrix[10]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::NormalMatrix(const Matrix4x4<TValue>& matrix)
+    {
+        return FromMatrix4x4(matrix).Inverse().Transpose();
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue>::Matrix3x3(const TValue a11, const TValue a12, const TValue a13, const TValue a21, const TValue a22, const TValue a23,
+                                           const TValue a31, const TValue a32, const TValue a33) : MatrixArray{}
+    {
+        MatrixArray[0] = a11;
+        MatrixArray[1] = a12;
+        MatrixArray[2] = a13;
+
+        MatrixArray[3] = a21;
+        MatrixArray[4] = a22;
+        MatrixArray[5] = a23;
+
+        MatrixArray[6] = a31;
+        MatrixArray[7] = a32;
+        MatrixArray[8] = a33;
+    }
+
+    template <typename TValue>
+    constexpr TValue& Matrix3x3<TValue>::operator[](const byte index)
+    {
+        return MatrixArray[index];
+    }
+
+    template <typename TValue>
+    constexpr const TValue& Matrix3x3<TValue>::operator[](const byte index) const
+    {
+        return MatrixArray[index];
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::operator*(const Matrix3x3& Other) const
+    {
+        Matrix3x3<TValue> matrix;
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            for (unsigned int column = 0; column < 3; column++)
+            {
+                matrix.MatrixArray[row * 3 + column] = MatrixArray[row * 3] * Other.MatrixArray[column] + MatrixArray[row * 3 + 1] * Other.MatrixArray[3 + column] +
+                                                       MatrixArray[row * 3 + 2] * Other.MatrixArray[6 + column];
+            }
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue>& Matrix3x3<TValue>::operator*=(const Matrix3x3& Other)
+    {
+        *this = *this * Other;
+        return *this;
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix3x3<TValue>::Transform(const Engine::Vector3<TValue>& vector) const
+    {
+        return Engine::Vector3<TValue>(
+            vector.X * MatrixArray[0] + vector.Y * MatrixArray[3] + vector.Z * MatrixArray[6],
+            vector.X * MatrixArray[1] + vector.Y * MatrixArray[4] + vector.Z * MatrixArray[7],
+            vector.X * MatrixArray[2] + vector.Y * MatrixArray[5] + vector.Z * MatrixArray[8]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix3x3<TValue>::ToMatrix4x4() const
+    {
+        return Matrix4x4<TValue>(
+            MatrixArray[0], MatrixArray[1], MatrixArray[2], 0,
+            MatrixArray[3], MatrixArray[4], MatrixArray[5], 0,
+            MatrixArray[6], MatrixArray[7], MatrixArray[8], 0,
+            0, 0, 0, 1
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::Transpose() const
+    {
+        return Matrix3x3<TValue>(
+            MatrixArray[0], MatrixArray[3], MatrixArray[6],
+            MatrixArray[1], MatrixArray[4], MatrixArray[7],
+            MatrixArray[2], MatrixArray[5], MatrixArray[8]
+        );
+    }
+
+    template <typename TValue>
+    constexpr TValue Matrix3x3<TValue>::Determinant() const
+    {
+        const TValue* m = MatrixArray;
+        return m[0] * (m[4] * m[8] - m[5] * m[7]) + m[1] * (m[5] * m[6] - m[3] * m[8]) + m[2] * (m[3] * m[7] - m[4] * m[6]);
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x3<TValue>::Inverse() const
+    {
+        const TValue* m = MatrixArray;
+
+        //	The columns of the inverse are the cross products of the rows, like Matrix4x4::InverseAffine.
+        const TValue c00 = m[4] * m[8] - m[5] * m[7];
+        const TValue c01 = m[5] * m[6] - m[3] * m[8];
+        const TValue c02 = m[3] * m[7] - m[4] * m[6];
+        const TValue inverseDeterminant = TValue(1) / (m[0] * c00 + m[1] * c01 + m[2] * c02);
+
+        return Matrix3x3<TValue>(
+            c00 * inverseDeterminant, (m[7] * m[2] - m[8] * m[1]) * inverseDeterminant, (m[1] * m[5] - m[2] * m[4]) * inverseDeterminant,
+            c01 * inverseDeterminant, (m[8] * m[0] - m[6] * m[2]) * inverseDeterminant, (m[2] * m[3] - m[0] * m[5]) * inverseDeterminant,
+            c02 * inverseDeterminant, (m[6] * m[1] - m[7] * m[0]) * inverseDeterminant, (m[0] * m[4] - m[1] * m[3]) * inverseDeterminant
+        );
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> operator*(const Engine::Vector3<TValue>& vector, const Matrix3x3<TValue>& matrix)
+    {
+        return matrix.Transform(vector);
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue>::Matrix3x3(const TValue value) : MatrixArray{}
+    {
+        for (unsigned int i = 0; i < 9; i++)
+        {
+            MatrixArray[i] = value;
+        }
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue>::Matrix3x3() : MatrixArray{}
+    {
+    }
+
+#if ENGINE_SIMD_SSE
+    //	Matrix3x3<float> specialization. Rows are 12 bytes, so they are loaded 4 floats at a time with one float of
+    //	the next row in W (the last row is loaded from element 5 and shifted, so nothing past the matrix is read).
+    //	W lanes are ignored, and the rows are stored in order so every stray W is overwritten by the next row.
+
+    template <>
+    FORCEINLINE constexpr Matrix3x3<float> Matrix3x3<float>::operator*(const Matrix3x3& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Matrix3x3<float> matrix;
+            for (unsigned int row = 0; row < 3; row++)
+            {
+                for (unsigned int column = 0; column < 3; column++)
+                {
+                    matrix.MatrixArray[row * 3 + column] = MatrixArray[row * 3] * Other.MatrixArray[column] + MatrixArray[row * 3 + 1] * Other.MatrixArray[3 + column] +
+                                                           MatrixArray[row * 3 + 2] * Other.MatrixArray[6 + column];
+                }
+            }
+            return matrix;
+        }
+
+        const __m128 row0 = SIMD::Load4(&Other.MatrixArray[0]);
+        const __m128 row1 = SIMD::Load4(&Other.MatrixArray[3]);
+        const __m128 lastRow = SIMD::Load4(&Other.MatrixArray[5]);
+        const __m128 row2 = _mm_shuffle_ps(lastRow, lastRow, _MM_SHUFFLE(3, 3, 2, 1));
+
+        __m128 results[3] = {};
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            const float* left = &MatrixArray[row * 3];
+            results[row] = SIMD::MultiplyAdd4(_mm_set1_ps(left[2]), row2, SIMD::MultiplyAdd4(_mm_set1_ps(left[1]), row1, _mm_mul_ps(_mm_set1_ps(left[0]), row0)));
+        }
+
+        Matrix3x3<float> matrix;
+        SIMD::Store4(&matrix.MatrixArray[0], results[0]);
+        SIMD::Store4(&matrix.MatrixArray[3], results[1]);
+
+        //	Element 5 is stored again from the second row, then the last row after it.
+        const __m128 shifted = _mm_shuffle_ps(results[1], results[2], _MM_SHUFFLE(0, 0, 2, 2));
+        SIMD::Store4(&matrix.MatrixArray[5], _mm_shuffle_ps(shifted, results[2], _MM_SHUFFLE(2, 1, 2, 0)));
+        return matrix;
+    }
+
+    template <>
+    FORCEINLINE constexpr Engine::Vector3<float> Matrix3x3<float>::Transform(const Engine::Vector3<float>& vector) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Engine::Vector3<float>(
+                vector.X * MatrixArray[0] + vector.Y * MatrixArray[3] + vector.Z * MatrixArray[6],
+                vector.X * MatrixArray[1] + vector.Y * MatrixArray[4] + vector.Z * MatrixArray[7],
+                vector.X * MatrixArray[2] + vector.Y * MatrixArray[5] + vector.Z * MatrixArray[8]
+            );
+        }
+
+        const __m128 lastRow = SIMD::Load4(&MatrixArray[5]);
+        const __m128 xy = SIMD::MultiplyAdd4(_mm_set1_ps(vector.Y), SIMD::Load4(&MatrixArray[3]), _mm_mul_ps(_mm_set1_ps(vector.X), SIMD::Load4(&MatrixArray[0])));
+        const __m128 xyz = SIMD::MultiplyAdd4(_mm_set1_ps(vector.Z), _mm_shuffle_ps(lastRow, lastRow, _MM_SHUFFLE(3, 3, 2, 1)), xy);
+
+        alignas(16) float result[4] = {};
+        _mm_store_ps(result, xyz);
+        return Engine::Vector3<float>(result[0], result[1], result[2]);
+    }
+#endif
+}
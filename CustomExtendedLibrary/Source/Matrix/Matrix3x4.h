@@ -0,0 +1,319 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a 48 byte affine matrix library, a Matrix4x4 whose last column is always (0, 0, 0, 1) stored without it.
+ *
+ *  Current capabilities:
+ *  -   Initialization without defining the elements. (Every element is 0, like Matrix4x4)
+ *  -   IdentityMatrix, FromMatrix4x4, ToMatrix4x4, and building from a Matrix3x3 and a translation.
+ *  -   Multiplication, TransformPoint and TransformDirection of Vector3.
+ *  -   Float multiplication and transforms run on SSE rows, compile time evaluation takes the scalar path.
+ *
+ *  The rows of Matrix3x4 are the first three columns of the equivalent Matrix4x4, the float3x4 layout of shaders.
+ *  Row i is (m[0][i], m[1][i], m[2][i], m[3][i]), so the translation is the W of every row and a point
+ *  transforms as dot(row i, (x, y, z, 1)). Every row fills one SSE register.
+ *  Multiplication keeps the Matrix4x4 order, (A * B).ToMatrix4x4() == A.ToMatrix4x4() * B.ToMatrix4x4().
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/CoreAPI.h"
+#include "Core/Types.h"
+#include "Math/SIMD.h"
+#include "Matrix/Matrix3x3.h"
+#include "Matrix/Matrix4x4.h"
+#include "Vectors/Vector3.h"
+
+namespace Engine
+{
+    template <typename TValue>
+    class Matrix3x4
+    {
+    public:
+        FORCEINLINE static constexpr Matrix3x4 IdentityMatrix();
+
+        //	matrix has to be affine, its last column (0, 0, 0, 1) is dropped.
+        FORCEINLINE static constexpr Matrix3x4 FromMatrix4x4(const Matrix4x4<TValue>& matrix);
+
+        //	Elements are given row by row in the stored layout, the column of the Matrix4x4 first and the translation last.
+        constexpr Matrix3x4(
+            const TValue a11, const TValue a12, const TValue a13, const TValue a14,
+            const TValue a21, const TValue a22, const TValue a23, const TValue a24,
+            const TValue a31, const TValue a32, const TValue a33, const TValue a34);
+
+        //	Rotation and scale of matrix followed by translation.
+        constexpr Matrix3x4(const Matrix3x3<TValue>& matrix, const Engine::Vector3<TValue>& translation);
+
+        FORCEINLINE constexpr TValue& operator[](const byte index);
+        FORCEINLINE constexpr const TValue& operator[](const byte index) const;
+
+        //	Matrix3x4 * Matrix3x4. Same order as Matrix4x4, the result applies this matrix first and Other second.
+        FORCEINLINE constexpr Matrix3x4 operator*(const Matrix3x4& Other) const;
+
+        //	Matrix3x4 * Matrix3x4 and overwrites on related Matrix3x4.
+        FORCEINLINE constexpr Matrix3x4& operator*=(const Matrix3x4& Other);
+
+        //	Transforms (x, y, z, 1), so translation applies.
+        FORCEINLINE constexpr Engine::Vector3<TValue> TransformPoint(const Engine::Vector3<TValue>& point) const;
+
+        //	Transforms (x, y, z, 0), so translation does not apply.
+        FORCEINLINE constexpr Engine::Vector3<TValue> TransformDirection(const Engine::Vector3<TValue>& direction) const;
+
+        //	Same matrix in a Matrix4x4, the last column becomes (0, 0, 0, 1).
+        FORCEINLINE constexpr Matrix4x4<TValue> ToMatrix4x4() const;
+
+        //	Rotation and scale without the translation.
+        FORCEINLINE constexpr Matrix3x3<TValue> ToMatrix3x3() const;
+
+        FORCEINLINE constexpr Engine::Vector3<TValue> GetTranslation() const;
+
+        constexpr Matrix3x4(const TValue value);
+        constexpr Matrix3x4();
+        ~Matrix3x4() = default;
+
+    private:
+        TValue MatrixArray[12];
+    };
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue> Matrix3x4<TValue>::IdentityMatrix()
+    {
+        return Matrix3x4<TValue>(
+            1, 0, 0, 0,
+            0, 1, 0, 0,
+            0, 0, 1, 0
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue> Matrix3x4<TValue>::FromMatrix4x4(const Matrix4x4<TValue>& matrix)
+    {
+        return Matrix3x4<TValue>(
+            matrix[0], matrix[4], matrix[8], matrix[12],
+            matrix[1], matrix[5], matrix[9], matrix[13],
+            matrix[2], matrix[6], matrix[10], matrix[14]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue>::Matrix3x4(const TValue a11, const TValue a12, const TValue a13, const TValue a14, const TValue a21, const TValue a22,
+                                           const TValue a23, const TValue a24, const TValue a31, const TValue a32, const TValue a33, const TValue a34) : MatrixArray{}
+    {
+        MatrixArray[0] = a11;
+        MatrixArray[1] = a12;
+        MatrixArray[2] = a13;
+        MatrixArray[3] = a14;
+
+        MatrixArray[4] = a21;
+        MatrixArray[5] = a22;
+        MatrixArray[6] = a23;
+        MatrixArray[7] = a24;
+
+        MatrixArray[8] = a31;
+        MatrixArray[9] = a32;
+        MatrixArray[10] = a33;
+        MatrixArray[11] = a34;
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue>::Matrix3x4(const Matrix3x3<TValue>& matrix, const Engine::Vector3<TValue>& translation) : MatrixArray{}
+    {
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            MatrixArray[row * 4] = matrix[row];
+            MatrixArray[row * 4 + 1] = matrix[3 + row];
+            MatrixArray[row * 4 + 2] = matrix[6 + row];
+        }
+        MatrixArray[3] = translation.X;
+        MatrixArray[7] = translation.Y;
+        MatrixArray[11] = translation.Z;
+    }
+
+    template <typename TValue>
+    constexpr TValue& Matrix3x4<TValue>::operator[](const byte index)
+    {
+        return MatrixArray[index];
+    }
+
+    template <typename TValue>
+    constexpr const TValue& Matrix3x4<TValue>::operator[](const byte index) const
+    {
+        return MatrixArray[index];
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue> Matrix3x4<TValue>::operator*(const Matrix3x4& Other) const
+    {
+        //	The stored rows are transposed, so every row of the result is a row of Other times the rows of this matrix,
+        //	with the implicit (0, 0, 0, 1) as the fourth row.
+        Matrix3x4<TValue> matrix;
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            for (unsigned int column = 0; column < 4; column++)
+            {
+                matrix.MatrixArray[row * 4 + column] = Other.MatrixArray[row * 4] * MatrixArray[column] + Other.MatrixArray[row * 4 + 1] * MatrixArray[4 + column] +
+                                                       Other.MatrixArray[row * 4 + 2] * MatrixArray[8 + column];
+            }
+            matrix.MatrixArray[row * 4 + 3] += Other.MatrixArray[row * 4 + 3];
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue>& Matrix3x4<TValue>::operator*=(const Matrix3x4& Other)
+    {
+        *this = *this * Other;
+        return *this;
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix3x4<TValue>::TransformPoint(const Engine::Vector3<TValue>& point) const
+    {
+        return Engine::Vector3<TValue>(
+            point.X * MatrixArray[0] + point.Y * MatrixArray[1] + point.Z * MatrixArray[2] + MatrixArray[3],
+            point.X * MatrixArray[4] + point.Y * MatrixArray[5] + point.Z * MatrixArray[6] + MatrixArray[7],
+            point.X * MatrixArray[8] + point.Y * MatrixArray[9] + point.Z * MatrixArray[10] + MatrixArray[11]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix3x4<TValue>::TransformDirection(const Engine::Vector3<TValue>& direction) const
+    {
+        return Engine::Vector3<TValue>(
+            direction.X * MatrixArray[0] + direction.Y * MatrixArray[1] + direction.Z * MatrixArray[2],
+            direction.X * MatrixArray[4] + direction.Y * MatrixArray[5] + direction.Z * MatrixArray[6],
+            direction.X * MatrixArray[8] + direction.Y * MatrixArray[9] + direction.Z * MatrixArray[10]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix3x4<TValue>::ToMatrix4x4() const
+    {
+        return Matrix4x4<TValue>(
+            MatrixArray[0], MatrixArray[4], MatrixArray[8], 0,
+            MatrixArray[1], MatrixArray[5], MatrixArray[9], 0,
+            MatrixArray[2], MatrixArray[6], MatrixArray[10], 0,
+            MatrixArray[3], MatrixArray[7], MatrixArray[11], 1
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x3<TValue> Matrix3x4<TValue>::ToMatrix3x3() const
+    {
+        return Matrix3x3<TValue>(
+            MatrixArray[0], MatrixArray[4], MatrixArray[8],
+            MatrixArray[1], MatrixArray[5], MatrixArray[9],
+            MatrixArray[2], MatrixArray[6], MatrixArray[10]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix3x4<TValue>::GetTranslation() const
+    {
+        return Engine::Vector3<TValue>(MatrixArray[3], MatrixArray[7], MatrixArray[11]);
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue>::Matrix3x4(const TValue value) : MatrixArray{}
+    {
+        for (unsigned int i = 0; i < 12; i++)
+        {
+            MatrixArray[i] = value;
+        }
+    }
+
+    template <typename TValue>
+    constexpr Matrix3x4<TValue>::Matrix3x4() : MatrixArray{}
+    {
+    }
+
+#if ENGINE_SIMD_SSE
+    //	Matrix3x4<float> specialization. Every row is one register, the transforms transpose them to columns
+    //	with a zero fourth row and sum them like Matrix4x4::TransformPoint.
+
+    template <>
+    FORCEINLINE constexpr Matrix3x4<float> Matrix3x4<float>::operator*(const Matrix3x4& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Matrix3x4<float> matrix;
+            for (unsigned int row = 0; row < 3; row++)
+            {
+                for (unsigned int column = 0; column < 4; column++)
+                {
+                    matrix.MatrixArray[row * 4 + column] = Other.MatrixArray[row * 4] * MatrixArray[column] + Other.MatrixArray[row * 4 + 1] * MatrixArray[4 + column] +
+                                                           Other.MatrixArray[row * 4 + 2] * MatrixArray[8 + column];
+                }
+                matrix.MatrixArray[row * 4 + 3] += Other.MatrixArray[row * 4 + 3];
+            }
+            return matrix;
+        }
+
+        const __m128 row0 = SIMD::Load4(&MatrixArray[0]);
+        const __m128 row1 = SIMD::Load4(&MatrixArray[4]);
+        const __m128 row2 = SIMD::Load4(&MatrixArray[8]);
+        const __m128 row3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+        Matrix3x4<float> matrix;
+        for (unsigned int row = 0; row < 3; row++)
+        {
+            SIMD::Store4(&matrix.MatrixArray[row * 4], SIMD::TransformRow4(SIMD::Load4(&Other.MatrixArray[row * 4]), row0, row1, row2, row3));
+        }
+        return matrix;
+    }
+
+    template <>
+    FORCEINLINE constexpr Engine::Vector3<float> Matrix3x4<float>::TransformPoint(const Engine::Vector3<float>& point) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Engine::Vector3<float>(
+                point.X * MatrixArray[0] + point.Y * MatrixArray[1] + point.Z * MatrixArray[2] + MatrixArray[3],
+                point.X * MatrixArray[4] + point.Y * MatrixArray[5] + point.Z * MatrixArray[6] + MatrixArray[7],
+                point.X * MatrixArray[8] + point.Y * MatrixArray[9] + point.Z * MatrixArray[10] + MatrixArray[11]
+            );
+        }
+
+        __m128 column0 = SIMD::Load4(&MatrixArray[0]);
+        __m128 column1 = SIMD::Load4(&MatrixArray[4]);
+        __m128 column2 = SIMD::Load4(&MatrixArray[8]);
+        __m128 column3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+        const __m128 low = SIMD::MultiplyAdd4(_mm_set1_ps(point.X), column0, column3);
+        const __m128 high = SIMD::MultiplyAdd4(_mm_set1_ps(point.Z), column2, _mm_mul_ps(_mm_set1_ps(point.Y), column1));
+
+        alignas(16) float result[4] = {};
+        _mm_store_ps(result, _mm_add_ps(low, high));
+        return Engine::Vector3<float>(result[0], result[1], result[2]);
+    }
+
+    template <>
+    FORCEINLINE constexpr Engine::Vector3<float> Matrix3x4<float>::TransformDirection(const Engine::Vector3<float>& direction) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Engine::Vector3<float>(
+                direction.X * MatrixArray[0] + direction.Y * MatrixArray[1] + direction.Z * MatrixArray[2],
+                direction.X * MatrixArray[4] + direction.Y * MatrixArray[5] + direction.Z * MatrixArray[6],
+                direction.X * MatrixArray[8] + direction.Y * MatrixArray[9] + direction.Z * MatrixArray[10]
+            );
+        }
+
+        __m128 column0 = SIMD::Load4(&MatrixArray[0]);
+        __m128 column1 = SIMD::Load4(&MatrixArray[4]);
+        __m128 column2 = SIMD::Load4(&MatrixArray[8]);
+        __m128 column3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+        const __m128 xy = SIMD::MultiplyAdd4(_mm_set1_ps(direction.Y), column1, _mm_mul_ps(_mm_set1_ps(direction.X), column0));
+        const __m128 xyz = SIMD::MultiplyAdd4(_mm_set1_ps(direction.Z), column2, xy);
+
+        alignas(16) float result[4] = {};
+        _mm_store_ps(result, xyz);
+        return Engine::Vector3<float>(result[0], result[1], result[2]);
+    }
+#endif
+}
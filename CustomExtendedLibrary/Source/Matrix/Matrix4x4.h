@@ -4,40 +4,94 @@
 #include <Core/Types.h>
 
 #include <Math/Math.h>
-#include <Math/Vector3.h>
+#include <Math/SIMD.h>
+#include <Vectors/Vector3.h>
+#include <Vectors/Vector4.h>
 
 namespace Engine
 {
+    template <typename TValue>
+    class Quaternion;
+
     template <typename TValue>
     class Matrix4x4
     {
     public:
         FORCEINLINE static constexpr Matrix4x4 IdentityMatrix();
 
-        FORCEINLINE static Matrix4x4 TranslationMatrix(Engine::Vector3<TValue>& translationPos);
+        FORCEINLINE static constexpr Matrix4x4 TranslationMatrix(const Engine::Vector3<TValue>& translationPos);
         FORCEINLINE static Matrix4x4 RotationX(TValue rotationAngle);
         FORCEINLINE static Matrix4x4 RotationY(TValue rotationAngle);
         FORCEINLINE static Matrix4x4 RotationZ(TValue rotationAngle);
-        FORCEINLINE static Matrix4x4 Scale(Engine::Vector3<TValue>& scalePos);
+        FORCEINLINE static constexpr Matrix4x4 Scale(const Engine::Vector3<TValue>& scalePos);
 
-        FORCEINLINE static Matrix4x4 TransformationMatrix(Engine::Vector3<TValue>& transformationPos);
+        //	Scale, rotation and translation written straight into one matrix, the same as
+        //	Scale(scale) * RotationX(rotation.X) * RotationY(rotation.Y) * RotationZ(rotation.Z) * TranslationMatrix(translation).
+        //	rotation is Euler angles in degrees, applied around X first, then Y, then Z.
+        FORCEINLINE static Matrix4x4 TransformationMatrix(const Engine::Vector3<TValue>& translation, const Engine::Vector3<TValue>& rotation,
+                                                          const Engine::Vector3<TValue>& scale);
 
-        Matrix4x4(
+        //	Same with the rotation of a unit quaternion, Scale(scale) * rotation.ToMatrix4x4() * TranslationMatrix(translation).
+        FORCEINLINE static constexpr Matrix4x4 TransformationMatrix(const Engine::Vector3<TValue>& translation, const Engine::Quaternion<TValue>& rotation,
+                                                                    const Engine::Vector3<TValue>& scale);
+
+        constexpr Matrix4x4(
             const TValue a11, const TValue a12, const TValue a13, const TValue a14,
             const TValue a21, const TValue a22, const TValue a23, const TValue a24,
             const TValue a31, const TValue a32, const TValue a33, const TValue a34,
             const TValue a41, const TValue a42, const TValue a43, const TValue a44);
 
-        FORCEINLINE TValue& operator[](const byte index);
+        FORCEINLINE constexpr TValue& operator[](const byte index);
+        FORCEINLINE constexpr const TValue& operator[](const byte index) const;
+
+        //	Matrix4x4 * Matrix4x4. Vectors are rows, so the result applies this matrix first and Other second.
+        FORCEINLINE constexpr Matrix4x4 operator*(const Matrix4x4& Other) const;
+
+        //	Matrix4x4 * Matrix4x4 and overwrites on related Matrix4x4.
+        FORCEINLINE constexpr Matrix4x4& operator*=(const Matrix4x4& Other);
+
+        //	Row vector times the matrix, the same as vector * matrix.
+        FORCEINLINE constexpr Engine::Vector4<TValue> Transform(const Engine::Vector4<TValue>& vector) const;
+
+        //	Transforms (x, y, z, 1), so translation applies. There is no perspective divide, W of the result is dropped.
+        FORCEINLINE constexpr Engine::Vector3<TValue> TransformPoint(const Engine::Vector3<TValue>& point) const;
+
+        //	Transforms (x, y, z, 0), so translation does not apply.
+        FORCEINLINE constexpr Engine::Vector3<TValue> TransformDirection(const Engine::Vector3<TValue>& direction) const;
+
+        //	Rows become columns.
+        FORCEINLINE constexpr Matrix4x4 Transpose() const;
+
+        FORCEINLINE constexpr TValue Determinant() const;
+
+        //	General inverse, the adjugate divided by the determinant (Cramer's rule). A singular matrix gives
+        //	non-finite elements, check Determinant first when that can happen.
+        FORCEINLINE constexpr Matrix4x4 Inverse() const;
+
+        //	Inverse of an affine matrix, the last column has to be (0, 0, 0, 1). The upper 3x3 can hold any rotation,
+        //	scale or shear, it is inverted with three cross products and the translation follows. About half of Inverse.
+        FORCEINLINE constexpr Matrix4x4 InverseAffine() const;
+
+        //	Inverse of rotation and translation only, the upper 3x3 is transposed. Scaled matrices need InverseAffine.
+        FORCEINLINE constexpr Matrix4x4 InverseRigid() const;
 
-        Matrix4x4(const TValue value);
-        Matrix4x4();
+        constexpr Matrix4x4(const TValue value);
+        constexpr Matrix4x4();
         ~Matrix4x4() = default;
 
     private:
+        //	Scalar inverses, the float specializations use them when evaluated at compile time.
+        constexpr Matrix4x4 InverseScalar() const;
+        constexpr Matrix4x4 InverseAffineScalar() const;
+        constexpr Matrix4x4 InverseRigidScalar() const;
+
         TValue MatrixArray[16];
     };
 
+    //	Vector4 * Matrix4x4. Vectors are rows, like in TranslationMatrix.
+    template <typename TValue>
+    FORCEINLINE constexpr Engine::Vector4<TValue> operator*(const Engine::Vector4<TValue>& vector, const Matrix4x4<TValue>& matrix);
+
     template <typename TValue>
     constexpr Matrix4x4<TValue> Matrix4x4<TValue>::IdentityMatrix()
     {
@@ -50,7 +104,7 @@ namespace Engine
     }
 
     template <typename TValue>
-    Matrix4x4<TValue> Matrix4x4<TValue>::TranslationMatrix(Engine::Vector3<TValue>& translationPos)
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::TranslationMatrix(const Engine::Vector3<TValue>& translationPos)
     {
         Matrix4x4<TValue> matrix = Matrix4x4<TValue>::IdentityMatrix();
 
@@ -92,8 +146,8 @@ namespace Engine
     {
         Matrix4x4 matrix = Matrix4x4::IdentityMatrix();
 
-        matrix[0] = (3.0f/4.0f) * Engine::Math::Cos(rotationAngle);
-        matrix[1] = (3.0f/4.0f) * Engine::Math::Sin(rotationAngle);
+        matrix[0] = Engine::Math::Cos(rotationAngle);
+        matrix[1] = Engine::Math::Sin(rotationAngle);
         matrix[4] = -Engine::Math::Sin(rotationAngle);
         matrix[5] = Engine::Math::Cos(rotationAngle);
 
@@ -101,25 +155,55 @@ namespace Engine
     }
 
     template <typename TValue>
-    Matrix4x4<TValue> Matrix4x4<TValue>::Scale(Engine::Vector3<TValue>& scalePos)
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::Scale(const Engine::Vector3<TValue>& scalePos)
     {
         Matrix4x4<TValue> matrix = Matrix4x4<TValue>::IdentityMatrix();
         matrix[0] = scalePos.X;
         matrix[5] = scalePos.Y;
         matrix[10] = scalePos.Z;
+
+        return matrix;
+    }
+
+    template <typename TValue>
+    Matrix4x4<TValue> Matrix4x4<TValue>::TransformationMatrix(const Engine::Vector3<TValue>& translation, const Engine::Vector3<TValue>& rotation,
+                                                              const Engine::Vector3<TValue>& scale)
+    {
+        const TValue sinX = Engine::Math::Sin(rotation.X), cosX = Engine::Math::Cos(rotation.X);
+        const TValue sinY = Engine::Math::Sin(rotation.Y), cosY = Engine::Math::Cos(rotation.Y);
+        const TValue sinZ = Engine::Math::Sin(rotation.Z), cosZ = Engine::Math::Cos(rotation.Z);
+
+        //	RotationX * RotationY * RotationZ multiplied out, every row scaled by its scale component.
+        return Matrix4x4<TValue>(
+            scale.X * cosY * cosZ, scale.X * cosY * sinZ, -scale.X * sinY, 0,
+            scale.Y * (sinX * sinY * cosZ - cosX * sinZ), scale.Y * (sinX * sinY * sinZ + cosX * cosZ), scale.Y * sinX * cosY, 0,
+            scale.Z * (cosX * sinY * cosZ + sinX * sinZ), scale.Z * (cosX * sinY * sinZ - sinX * cosZ), scale.Z * cosX * cosY, 0,
+            translation.X, translation.Y, translation.Z, 1
+        );
     }
 
+    //	Quaternion is only forward declared here, its members are looked up when this is instantiated.
     template <typename TValue>
-    Matrix4x4<TValue> Matrix4x4<TValue>::TransformationMatrix(Engine::Vector3<TValue>& transformationPos)
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::TransformationMatrix(const Engine::Vector3<TValue>& translation, const Engine::Quaternion<TValue>& rotation,
+                                                                        const Engine::Vector3<TValue>& scale)
     {
-        return Matrix4x4<TValue>();
+        const TValue xx = rotation.X * rotation.X, yy = rotation.Y * rotation.Y, zz = rotation.Z * rotation.Z;
+        const TValue xy = rotation.X * rotation.Y, xz = rotation.X * rotation.Z, yz = rotation.Y * rotation.Z;
+        const TValue wx = rotation.W * rotation.X, wy = rotation.W * rotation.Y, wz = rotation.W * rotation.Z;
+
+        return Matrix4x4<TValue>(
+            scale.X * (1 - 2 * (yy + zz)), scale.X * 2 * (xy + wz), scale.X * 2 * (xz - wy), 0,
+            scale.Y * 2 * (xy - wz), scale.Y * (1 - 2 * (xx + zz)), scale.Y * 2 * (yz + wx), 0,
+            scale.Z * 2 * (xz + wy), scale.Z * 2 * (yz - wx), scale.Z * (1 - 2 * (xx + yy)), 0,
+            translation.X, translation.Y, translation.Z, 1
+        );
     }
 
     template <typename TValue>
-    Matrix4x4<TValue>::Matrix4x4(const TValue a11, const TValue a12, const TValue a13, const TValue a14, const TValue a21, const TValue a22, const TValue a23,
+    constexpr Matrix4x4<TValue>::Matrix4x4(const TValue a11, const TValue a12, const TValue a13, const TValue a14, const TValue a21, const TValue a22, const TValue a23,
                                  const TValue a24, const TValue a31, const TValue a32, const TValue a33, const TValue a34, const TValue a41, const TValue a42,
                                  const TValue a43,
-                                 const TValue a44)
+                                 const TValue a44) : MatrixArray{}
     {
         MatrixArray[0] = a11;
         MatrixArray[1] = a12;
@@ -143,13 +227,229 @@ namespace Engine
     }
 
     template <typename TValue>
-    TValue& Matrix4x4<TValue>::operator[](const byte index)
+    constexpr TValue& Matrix4x4<TValue>::operator[](const byte index)
     {
         return MatrixArray[index];
     }
 
     template <typename TValue>
-    Matrix4x4<TValue>::Matrix4x4(const TValue value)
+    constexpr const TValue& Matrix4x4<TValue>::operator[](const byte index) const
+    {
+        return MatrixArray[index];
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::operator*(const Matrix4x4& Other) const
+    {
+        Matrix4x4<TValue> matrix;
+        for (unsigned int row = 0; row < 4; row++)
+        {
+            for (unsigned int column = 0; column < 4; column++)
+            {
+                matrix.MatrixArray[row * 4 + column] = MatrixArray[row * 4] * Other.MatrixArray[column] + MatrixArray[row * 4 + 1] * Other.MatrixArray[4 + column] +
+                                                       MatrixArray[row * 4 + 2] * Other.MatrixArray[8 + column] + MatrixArray[row * 4 + 3] * Other.MatrixArray[12 + column];
+            }
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue>& Matrix4x4<TValue>::operator*=(const Matrix4x4& Other)
+    {
+        *this = *this * Other;
+        return *this;
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector4<TValue> Matrix4x4<TValue>::Transform(const Engine::Vector4<TValue>& vector) const
+    {
+        return Engine::Vector4<TValue>(
+            vector.X * MatrixArray[0] + vector.Y * MatrixArray[4] + vector.Z * MatrixArray[8] + vector.W * MatrixArray[12],
+            vector.X * MatrixArray[1] + vector.Y * MatrixArray[5] + vector.Z * MatrixArray[9] + vector.W * MatrixArray[13],
+            vector.X * MatrixArray[2] + vector.Y * MatrixArray[6] + vector.Z * MatrixArray[10] + vector.W * MatrixArray[14],
+            vector.X * MatrixArray[3] + vector.Y * MatrixArray[7] + vector.Z * MatrixArray[11] + vector.W * MatrixArray[15]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix4x4<TValue>::TransformPoint(const Engine::Vector3<TValue>& point) const
+    {
+        return Engine::Vector3<TValue>(
+            point.X * MatrixArray[0] + point.Y * MatrixArray[4] + point.Z * MatrixArray[8] + MatrixArray[12],
+            point.X * MatrixArray[1] + point.Y * MatrixArray[5] + point.Z * MatrixArray[9] + MatrixArray[13],
+            point.X * MatrixArray[2] + point.Y * MatrixArray[6] + point.Z * MatrixArray[10] + MatrixArray[14]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector3<TValue> Matrix4x4<TValue>::TransformDirection(const Engine::Vector3<TValue>& direction) const
+    {
+        return Engine::Vector3<TValue>(
+            direction.X * MatrixArray[0] + direction.Y * MatrixArray[4] + direction.Z * MatrixArray[8],
+            direction.X * MatrixArray[1] + direction.Y * MatrixArray[5] + direction.Z * MatrixArray[9],
+            direction.X * MatrixArray[2] + direction.Y * MatrixArray[6] + direction.Z * MatrixArray[10]
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::Transpose() const
+    {
+        Matrix4x4<TValue> matrix;
+        for (unsigned int row = 0; row < 4; row++)
+        {
+            for (unsigned int column = 0; column < 4; column++)
+            {
+                matrix.MatrixArray[column * 4 + row] = MatrixArray[row * 4 + column];
+            }
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr TValue Matrix4x4<TValue>::Determinant() const
+    {
+        const TValue* m = MatrixArray;
+
+        //	Laplace expansion over the 2x2 determinants of the upper two rows and the lower two rows.
+        const TValue s0 = m[0] * m[5] - m[1] * m[4];
+        const TValue s1 = m[0] * m[6] - m[2] * m[4];
+        const TValue s2 = m[0] * m[7] - m[3] * m[4];
+        const TValue s3 = m[1] * m[6] - m[2] * m[5];
+        const TValue s4 = m[1] * m[7] - m[3] * m[5];
+        const TValue s5 = m[2] * m[7] - m[3] * m[6];
+
+        const TValue c0 = m[8] * m[13] - m[9] * m[12];
+        const TValue c1 = m[8] * m[14] - m[10] * m[12];
+        const TValue c2 = m[8] * m[15] - m[11] * m[12];
+        const TValue c3 = m[9] * m[14] - m[10] * m[13];
+        const TValue c4 = m[9] * m[15] - m[11] * m[13];
+        const TValue c5 = m[10] * m[15] - m[11] * m[14];
+
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::Inverse() const
+    {
+        return InverseScalar();
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::InverseAffine() const
+    {
+        return InverseAffineScalar();
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::InverseRigid() const
+    {
+        return InverseRigidScalar();
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::InverseScalar() const
+    {
+        const TValue* m = MatrixArray;
+
+        //	Same 2x2 determinants as Determinant, every cofactor is built from three of them.
+        const TValue s0 = m[0] * m[5] - m[1] * m[4];
+        const TValue s1 = m[0] * m[6] - m[2] * m[4];
+        const TValue s2 = m[0] * m[7] - m[3] * m[4];
+        const TValue s3 = m[1] * m[6] - m[2] * m[5];
+        const TValue s4 = m[1] * m[7] - m[3] * m[5];
+        const TValue s5 = m[2] * m[7] - m[3] * m[6];
+
+        const TValue c0 = m[8] * m[13] - m[9] * m[12];
+        const TValue c1 = m[8] * m[14] - m[10] * m[12];
+        const TValue c2 = m[8] * m[15] - m[11] * m[12];
+        const TValue c3 = m[9] * m[14] - m[10] * m[13];
+        const TValue c4 = m[9] * m[15] - m[11] * m[13];
+        const TValue c5 = m[10] * m[15] - m[11] * m[14];
+
+        const TValue inverseDeterminant = TValue(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+        return Matrix4x4<TValue>(
+            (m[5] * c5 - m[6] * c4 + m[7] * c3) * inverseDeterminant,
+            (m[2] * c4 - m[1] * c5 - m[3] * c3) * inverseDeterminant,
+            (m[13] * s5 - m[14] * s4 + m[15] * s3) * inverseDeterminant,
+            (m[10] * s4 - m[9] * s5 - m[11] * s3) * inverseDeterminant,
+
+            (m[6] * c2 - m[4] * c5 - m[7] * c1) * inverseDeterminant,
+            (m[0] * c5 - m[2] * c2 + m[3] * c1) * inverseDeterminant,
+            (m[14] * s2 - m[12] * s5 - m[15] * s1) * inverseDeterminant,
+            (m[8] * s5 - m[10] * s2 + m[11] * s1) * inverseDeterminant,
+
+            (m[4] * c4 - m[5] * c2 + m[7] * c0) * inverseDeterminant,
+            (m[1] * c2 - m[0] * c4 - m[3] * c0) * inverseDeterminant,
+            (m[12] * s4 - m[13] * s2 + m[15] * s0) * inverseDeterminant,
+            (m[9] * s2 - m[8] * s4 - m[11] * s0) * inverseDeterminant,
+
+            (m[5] * c1 - m[4] * c3 - m[6] * c0) * inverseDeterminant,
+            (m[0] * c3 - m[1] * c1 + m[2] * c0) * inverseDeterminant,
+            (m[13] * s1 - m[12] * s3 - m[14] * s0) * inverseDeterminant,
+            (m[8] * s3 - m[9] * s1 + m[10] * s0) * inverseDeterminant
+        );
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::InverseAffineScalar() const
+    {
+        const TValue* m = MatrixArray;
+
+        //	The columns of the inverse 3x3 are the cross products of its rows, divided by the determinant.
+        const TValue c00 = m[5] * m[10] - m[6] * m[9];
+        const TValue c01 = m[6] * m[8] - m[4] * m[10];
+        const TValue c02 = m[4] * m[9] - m[5] * m[8];
+        const TValue c10 = m[9] * m[2] - m[10] * m[1];
+        const TValue c11 = m[10] * m[0] - m[8] * m[2];
+        const TValue c12 = m[8] * m[1] - m[9] * m[0];
+        const TValue c20 = m[1] * m[6] - m[2] * m[5];
+        const TValue c21 = m[2] * m[4] - m[0] * m[6];
+        const TValue c22 = m[0] * m[5] - m[1] * m[4];
+
+        const TValue inverseDeterminant = TValue(1) / (m[0] * c00 + m[1] * c01 + m[2] * c02);
+
+        Matrix4x4<TValue> matrix(
+            c00 * inverseDeterminant, c10 * inverseDeterminant, c20 * inverseDeterminant, 0,
+            c01 * inverseDeterminant, c11 * inverseDeterminant, c21 * inverseDeterminant, 0,
+            c02 * inverseDeterminant, c12 * inverseDeterminant, c22 * inverseDeterminant, 0,
+            0, 0, 0, 1
+        );
+
+        for (unsigned int column = 0; column < 3; column++)
+        {
+            matrix.MatrixArray[12 + column] = -(m[12] * matrix.MatrixArray[column] + m[13] * matrix.MatrixArray[4 + column] + m[14] * matrix.MatrixArray[8 + column]);
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Matrix4x4<TValue>::InverseRigidScalar() const
+    {
+        const TValue* m = MatrixArray;
+
+        Matrix4x4<TValue> matrix(
+            m[0], m[4], m[8], 0,
+            m[1], m[5], m[9], 0,
+            m[2], m[6], m[10], 0,
+            0, 0, 0, 1
+        );
+
+        for (unsigned int column = 0; column < 3; column++)
+        {
+            matrix.MatrixArray[12 + column] = -(m[12] * matrix.MatrixArray[column] + m[13] * matrix.MatrixArray[4 + column] + m[14] * matrix.MatrixArray[8 + column]);
+        }
+        return matrix;
+    }
+
+    template <typename TValue>
+    constexpr Engine::Vector4<TValue> operator*(const Engine::Vector4<TValue>& vector, const Matrix4x4<TValue>& matrix)
+    {
+        return matrix.Transform(vector);
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue>::Matrix4x4(const TValue value) : MatrixArray{}
     {
         for (unsigned int i = 0; i < 16; i++)
         {
@@ -158,11 +458,291 @@ namespace Engine
     }
 
     template <typename TValue>
-    Matrix4x4<TValue>::Matrix4x4()
+    constexpr Matrix4x4<TValue>::Matrix4x4() : MatrixArray{}
     {
-        for (unsigned int i = 0; i < 16; i++)
+    }
+
+#if ENGINE_SIMD_SSE
+    //	Matrix4x4<float> specializations. Every row is one SSE register, a row of the product is that row of the left
+    //	matrix times the right one. With AVX two rows go through one 256 bit register. FMA is used when the build targets it.
+
+    template <>
+    FORCEINLINE constexpr Matrix4x4<float> Matrix4x4<float>::operator*(const Matrix4x4& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Matrix4x4<float> matrix;
+            for (unsigned int row = 0; row < 4; row++)
+            {
+                for (unsigned int column = 0; column < 4; column++)
+                {
+                    matrix.MatrixArray[row * 4 + column] = MatrixArray[row * 4] * Other.MatrixArray[column] + MatrixArray[row * 4 + 1] * Other.MatrixArray[4 + column] +
+                                                           MatrixArray[row * 4 + 2] * Other.MatrixArray[8 + column] + MatrixArray[row * 4 + 3] * Other.MatrixArray[12 + column];
+                }
+            }
+            return matrix;
+        }
+
+        Matrix4x4<float> matrix;
+#if ENGINE_SIMD_AVX
+        const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&Other.MatrixArray[0]));
+        const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&Other.MatrixArray[4]));
+        const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&Other.MatrixArray[8]));
+        const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&Other.MatrixArray[12]));
+
+        for (unsigned int row = 0; row < 4; row += 2)
+        {
+            const __m256 rows = _mm256_loadu_ps(&MatrixArray[row * 4]);
+#if ENGINE_SIMD_FMA
+            const __m256 low = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), row1, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), row0));
+            const __m256 high = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), row3, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+#else
+            const __m256 low = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), row0), _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+            const __m256 high = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), row2), _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+#endif
+            _mm256_storeu_ps(&matrix.MatrixArray[row * 4], _mm256_add_ps(low, high));
+        }
+#else
+        const __m128 row0 = SIMD::Load4(&Other.MatrixArray[0]);
+        const __m128 row1 = SIMD::Load4(&Other.MatrixArray[4]);
+        const __m128 row2 = SIMD::Load4(&Other.MatrixArray[8]);
+        const __m128 row3 = SIMD::Load4(&Other.MatrixArray[12]);
+
+        for (unsigned int row = 0; row < 4; row++)
+        {
+            SIMD::Store4(&matrix.MatrixArray[row * 4], SIMD::TransformRow4(SIMD::Load4(&MatrixArray[row * 4]), row0, row1, row2, row3));
+        }
+#endif
+        return matrix;
+    }
+
+    template <>
+    FORCEINLINE constexpr Engine::Vector4<float> Matrix4x4<float>::Transform(const Engine::Vector4<float>& vector) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
         {
-            MatrixArray[i] = 0;
+            return Engine::Vector4<float>(
+                vector.X * MatrixArray[0] + vector.Y * MatrixArray[4] + vector.Z * MatrixArray[8] + vector.W * MatrixArray[12],
+                vector.X * MatrixArray[1] + vector.Y * MatrixArray[5] + vector.Z * MatrixArray[9] + vector.W * MatrixArray[13],
+                vector.X * MatrixArray[2] + vector.Y * MatrixArray[6] + vector.Z * MatrixArray[10] + vector.W * MatrixArray[14],
+                vector.X * MatrixArray[3] + vector.Y * MatrixArray[7] + vector.Z * MatrixArray[11] + vector.W * MatrixArray[15]
+            );
         }
+
+        Engine::Vector4<float> result;
+        SIMD::Store4(&result.X, SIMD::TransformRow4(SIMD::Load4(&vector.X), SIMD::Load4(&MatrixArray[0]), SIMD::Load4(&MatrixArray[4]),
+                                                    SIMD::Load4(&MatrixArray[8]), SIMD::Load4(&MatrixArray[12])));
+        return result;
+    }
+
+    //	Vector3 is 12 bytes, so the elements are broadcast one by one instead of a 16 byte load past its end.
+    template <>
+    FORCEINLINE constexpr Engine::Vector3<float> Matrix4x4<float>::TransformPoint(const Engine::Vector3<float>& point) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Engine::Vector3<float>(
+                point.X * MatrixArray[0] + point.Y * MatrixArray[4] + point.Z * MatrixArray[8] + MatrixArray[12],
+                point.X * MatrixArray[1] + point.Y * MatrixArray[5] + point.Z * MatrixArray[9] + MatrixArray[13],
+                point.X * MatrixArray[2] + point.Y * MatrixArray[6] + point.Z * MatrixArray[10] + MatrixArray[14]
+            );
+        }
+
+        const __m128 low = SIMD::MultiplyAdd4(_mm_set1_ps(point.X), SIMD::Load4(&MatrixArray[0]), SIMD::Load4(&MatrixArray[12]));
+        const __m128 high = SIMD::MultiplyAdd4(_mm_set1_ps(point.Z), SIMD::Load4(&MatrixArray[8]), _mm_mul_ps(_mm_set1_ps(point.Y), SIMD::Load4(&MatrixArray[4])));
+
+        alignas(16) float result[4] = {};
+        _mm_store_ps(result, _mm_add_ps(low, high));
+        return Engine::Vector3<float>(result[0], result[1], result[2]);
+    }
+
+    template <>
+    FORCEINLINE constexpr Engine::Vector3<float> Matrix4x4<float>::TransformDirection(const Engine::Vector3<float>& direction) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Engine::Vector3<float>(
+                direction.X * MatrixArray[0] + direction.Y * MatrixArray[4] + direction.Z * MatrixArray[8],
+                direction.X * MatrixArray[1] + direction.Y * MatrixArray[5] + direction.Z * MatrixArray[9],
+                direction.X * MatrixArray[2] + direction.Y * MatrixArray[6] + direction.Z * MatrixArray[10]
+            );
+        }
+
+        const __m128 xy = SIMD::MultiplyAdd4(_mm_set1_ps(direction.Y), SIMD::Load4(&MatrixArray[4]), _mm_mul_ps(_mm_set1_ps(direction.X), SIMD::Load4(&MatrixArray[0])));
+        const __m128 xyz = SIMD::MultiplyAdd4(_mm_set1_ps(direction.Z), SIMD::Load4(&MatrixArray[8]), xy);
+
+        alignas(16) float result[4] = {};
+        _mm_store_ps(result, xyz);
+        return Engine::Vector3<float>(result[0], result[1], result[2]);
+    }
+
+    template <>
+    FORCEINLINE constexpr Matrix4x4<float> Matrix4x4<float>::Transpose() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            Matrix4x4<float> matrix;
+            for (unsigned int row = 0; row < 4; row++)
+            {
+                for (unsigned int column = 0; column < 4; column++)
+                {
+                    matrix.MatrixArray[column * 4 + row] = MatrixArray[row * 4 + column];
+                }
+            }
+            return matrix;
+        }
+
+        __m128 row0 = SIMD::Load4(&MatrixArray[0]);
+        __m128 row1 = SIMD::Load4(&MatrixArray[4]);
+        __m128 row2 = SIMD::Load4(&MatrixArray[8]);
+        __m128 row3 = SIMD::Load4(&MatrixArray[12]);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        Matrix4x4<float> matrix;
+        SIMD::Store4(&matrix.MatrixArray[0], row0);
+        SIMD::Store4(&matrix.MatrixArray[4], row1);
+        SIMD::Store4(&matrix.MatrixArray[8], row2);
+        SIMD::Store4(&matrix.MatrixArray[12], row3);
+        return matrix;
+    }
+
+    //	The matrix is split into the 2x2 blocks A B / C D, each packed row major into one register.
+    //	The adjugate comes from 2x2 products of the blocks and their adjugates, and the determinant from the
+    //	block determinants, so every cofactor is computed four at a time with shuffles.
+    template <>
+    FORCEINLINE constexpr Matrix4x4<float> Matrix4x4<float>::Inverse() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return InverseScalar();
+        }
+
+        //	left * right, adjugate(left) * right and left * adjugate(right) of 2x2 blocks.
+        const auto multiply = [](__m128 left, __m128 right)
+        {
+            return SIMD::MultiplyAdd4(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2)),
+                                      _mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 3, 0))));
+        };
+        const auto adjugateMultiply = [](__m128 left, __m128 right)
+        {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(0, 0, 3, 3)), right),
+                              _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 0, 3, 2))));
+        };
+        const auto multiplyAdjugate = [](__m128 left, __m128 right)
+        {
+            return _mm_sub_ps(_mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 3, 0, 3))),
+                              _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+        };
+
+        const __m128 row0 = SIMD::Load4(&MatrixArray[0]);
+        const __m128 row1 = SIMD::Load4(&MatrixArray[4]);
+        const __m128 row2 = SIMD::Load4(&MatrixArray[8]);
+        const __m128 row3 = SIMD::Load4(&MatrixArray[12]);
+
+        const __m128 a = _mm_movelh_ps(row0, row1);
+        const __m128 b = _mm_movehl_ps(row1, row0);
+        const __m128 c = _mm_movelh_ps(row2, row3);
+        const __m128 d = _mm_movehl_ps(row3, row2);
+
+        //	Determinants of A, B, C and D.
+        const __m128 blockDeterminants = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+        const __m128 determinantA = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 determinantB = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 determinantC = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 determinantD = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(3, 3, 3, 3));
+
+        const __m128 adjugateDC = adjugateMultiply(d, c);
+        const __m128 adjugateAB = adjugateMultiply(a, b);
+
+        __m128 x = _mm_sub_ps(_mm_mul_ps(determinantD, a), multiply(b, adjugateDC));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(determinantA, d), multiply(c, adjugateAB));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(determinantB, c), multiplyAdjugate(d, adjugateAB));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(determinantC, b), multiplyAdjugate(a, adjugateDC));
+
+        //	det = det(A) det(D) + det(B) det(C) - trace(adj(A) B adj(D) C)
+        __m128 trace = _mm_mul_ps(adjugateAB, _mm_shuffle_ps(adjugateDC, adjugateDC, _MM_SHUFFLE(3, 1, 2, 0)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+        const __m128 determinant = _mm_sub_ps(SIMD::MultiplyAdd4(determinantB, determinantC, _mm_mul_ps(determinantA, determinantD)), trace);
+
+        //	The signs turn the block adjugates into the cofactors of the whole matrix.
+        const __m128 inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+        x = _mm_mul_ps(x, inverseDeterminant);
+        y = _mm_mul_ps(y, inverseDeterminant);
+        z = _mm_mul_ps(z, inverseDeterminant);
+        w = _mm_mul_ps(w, inverseDeterminant);
+
+        Matrix4x4<float> matrix;
+        SIMD::Store4(&matrix.MatrixArray[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        SIMD::Store4(&matrix.MatrixArray[4], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        SIMD::Store4(&matrix.MatrixArray[8], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        SIMD::Store4(&matrix.MatrixArray[12], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+        return matrix;
+    }
+
+    template <>
+    FORCEINLINE constexpr Matrix4x4<float> Matrix4x4<float>::InverseAffine() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return InverseAffineScalar();
+        }
+
+        const __m128 row0 = SIMD::Load4(&MatrixArray[0]);
+        const __m128 row1 = SIMD::Load4(&MatrixArray[4]);
+        const __m128 row2 = SIMD::Load4(&MatrixArray[8]);
+
+        __m128 column0 = SIMD::Cross3(row1, row2);
+        __m128 column1 = SIMD::Cross3(row2, row0);
+        __m128 column2 = SIMD::Cross3(row0, row1);
+        const __m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), SIMD::Dot4(row0, column0));
+
+        __m128 last = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(column0, column1, column2, last);
+        const __m128 inverse0 = _mm_mul_ps(column0, inverseDeterminant);
+        const __m128 inverse1 = _mm_mul_ps(column1, inverseDeterminant);
+        const __m128 inverse2 = _mm_mul_ps(column2, inverseDeterminant);
+
+        const __m128 translation = SIMD::Load4(&MatrixArray[12]);
+        const __m128 moved = SIMD::MultiplyAdd4(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(2, 2, 2, 2)), inverse2,
+                                                SIMD::MultiplyAdd4(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(1, 1, 1, 1)), inverse1,
+                                                                   _mm_mul_ps(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(0, 0, 0, 0)), inverse0)));
+
+        Matrix4x4<float> matrix;
+        SIMD::Store4(&matrix.MatrixArray[0], inverse0);
+        SIMD::Store4(&matrix.MatrixArray[4], inverse1);
+        SIMD::Store4(&matrix.MatrixArray[8], inverse2);
+        SIMD::Store4(&matrix.MatrixArray[12], _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), moved));
+        return matrix;
+    }
+
+    template <>
+    FORCEINLINE constexpr Matrix4x4<float> Matrix4x4<float>::InverseRigid() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return InverseRigidScalar();
+        }
+
+        __m128 inverse0 = SIMD::Load4(&MatrixArray[0]);
+        __m128 inverse1 = SIMD::Load4(&MatrixArray[4]);
+        __m128 inverse2 = SIMD::Load4(&MatrixArray[8]);
+        __m128 last = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(inverse0, inverse1, inverse2, last);
+
+        const __m128 translation = SIMD::Load4(&MatrixArray[12]);
+        const __m128 moved = SIMD::MultiplyAdd4(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(2, 2, 2, 2)), inverse2,
+                                                SIMD::MultiplyAdd4(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(1, 1, 1, 1)), inverse1,
+                                                                   _mm_mul_ps(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(0, 0, 0, 0)), inverse0)));
+
+        Matrix4x4<float> matrix;
+        SIMD::Store4(&matrix.MatrixArray[0], inverse0);
+        SIMD::Store4(&matrix.MatrixArray[4], inverse1);
+        SIMD::Store4(&matrix.MatrixArray[8], inverse2);
+        SIMD::Store4(&matrix.MatrixArray[12], _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), moved));
+        return matrix;
     }
-}
+#endif
+}
\ No newline at end of file
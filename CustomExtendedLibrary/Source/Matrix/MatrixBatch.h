@@ -0,0 +1,646 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a batch Matrix library which transforms whole vertex arrays by one Matrix4x4 and inverts matrix arrays.
+ *
+ *  Current capabilities:
+ *  -   TransformPoints, TransformDirections and ProjectPoints (divided by W) for Vector3,
+ *      Transform and Project for Vector4.
+ *  -   Results go to a Vector array or to separate X, Y, Z streams. (SoAArray or three plain pointers)
+ *  -   Inverse, InverseAffine and InverseRigid over whole matrix arrays. (Bone matrices)
+ *  -   TransformationMatrices builds world matrices from SoA translations, quaternion rotations and scales.
+ *  -   Float is processed 4 or 8 at a time with SSE or AVX2, picked at run time like VectorBatch. AVX-512 runs the
+ *      AVX2 kernels, vertices are interleaved and the shuffles to split them only work inside 128 bit lanes.
+ *  -   Outputs of StreamingThreshold bytes or more are written with non-temporal stores, so they do not
+ *      push the source vertices and everything else out of the cache.
+ *  -   Other element types and the leftover vectors of a batch run the scalar Matrix4x4 functions.
+ *      Inverses run the Matrix4x4 functions for every matrix, which are SSE for float.
+ *  -   Pointer + count or Engine::Array, optional multithreaded split through Parallel::For.
+ *
+ *  Results can be written over the source when both are the same layout, other overlaps are not supported.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Containers/SoAArray.h"
+#include "Core/Types.h"
+#include "Math/SIMD.h"
+#include "Matrix/Matrix4x4.h"
+#include "Vectors/Quaternion.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+
+#include <cstdint>
+#include <type_traits>
+
+#if ENGINE_SIMD_SSE
+#define ENGINE_BATCH_KERNELS MatrixBatchKernelsSSE
+#define ENGINE_BATCH_LANES SIMD::Float4Lanes
+#define ENGINE_BATCH_TARGET
+#include "Matrix/MatrixBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+
+#define ENGINE_BATCH_KERNELS MatrixBatchKernelsAVX2
+#define ENGINE_BATCH_LANES SIMD::Float8Lanes
+#define ENGINE_BATCH_TARGET ENGINE_TARGET_AVX2
+#include "Matrix/MatrixBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+#else
+namespace Engine
+{
+    //	Only named by SIMD::Kernels, which SIMD::Dispatch never instantiates without SIMD.
+    struct MatrixBatchKernelsSSE;
+    struct MatrixBatchKernelsAVX2;
+}
+#endif
+
+namespace Engine
+{
+    class MatrixBatch
+    {
+    public:
+        MatrixBatch() = delete;
+        ~MatrixBatch() = delete;
+
+        //	Each thread gets at least this many elements, so smaller inputs stay on the calling thread.
+        static constexpr unsigned int MultithreadedChunkLength = 16384;
+
+        //	Same for the inverses, one matrix costs about as much as 16 vector transforms.
+        static constexpr unsigned int MultithreadedMatrixChunkLength = 1024;
+
+        //	Size of the output in bytes from which non-temporal stores are used. Around a last level cache,
+        //	smaller results are usually read again soon and are better left in the cache.
+        static constexpr unsigned int StreamingThreshold = 4 * 1024 * 1024;
+
+        //	destination[i] = matrix.TransformPoint(source[i]).
+        template <typename TValue>
+        static void TransformPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = matrix.TransformDirection(source[i]).
+        template <typename TValue>
+        static void TransformDirections(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	(x, y, z, 1) * matrix divided by its W. (Clip space to normalized device coordinates)
+        template <typename TValue>
+        static void ProjectPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = source[i] * matrix.
+        template <typename TValue>
+        static void Transform(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	source[i] * matrix with X, Y and Z divided by W, W of the result is 1.
+        template <typename TValue>
+        static void Project(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = source[i].Inverse().
+        template <typename TValue>
+        static void Inverse(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = source[i].InverseAffine().
+        template <typename TValue>
+        static void InverseAffine(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = source[i].InverseRigid().
+        template <typename TValue>
+        static void InverseRigid(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = Matrix4x4::TransformationMatrix(translation i, rotation i, scale i). The inputs are SoA streams,
+        //	3 for translations (X, Y, Z), 4 for quaternion rotations (X, Y, Z, W) and 3 for scales.
+        template <typename TValue>
+        static void TransformationMatrices(const TValue* const* translations, const TValue* const* rotations, const TValue* const* scales,
+                                           Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	SoA versions write component c of destination i to streams[c][i].
+        template <typename TValue>
+        static void TransformPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded = false);
+
+        template <typename TValue>
+        static void TransformDirections(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded = false);
+
+        template <typename TValue>
+        static void ProjectPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded = false);
+
+        //	Array versions resize destination to the length of source.
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void TransformPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                    Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void TransformDirections(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                        Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void ProjectPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                  Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Transform(const Matrix4x4<TValue>& matrix, const Array<Vector4<TValue>, TAllocator, TAlignment>& source,
+                              Array<Vector4<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Project(const Matrix4x4<TValue>& matrix, const Array<Vector4<TValue>, TAllocator, TAlignment>& source,
+                            Array<Vector4<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Inverse(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                            bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void InverseAffine(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                  bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void InverseRigid(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                 bool multithreaded = false);
+
+        //	Inputs of different length throw "Out of Range".
+        template <typename TValue, typename TTranslationAllocator, typename TRotationAllocator, typename TScaleAllocator, typename TResultAllocator,
+                  unsigned int TResultAlignment>
+        static void TransformationMatrices(const SoAArray<Vector3<TValue>, TTranslationAllocator>& translations, const SoAArray<Quaternion<TValue>, TRotationAllocator>& rotations,
+                                           const SoAArray<Vector3<TValue>, TScaleAllocator>& scales, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                           bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+        static void TransformPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                    SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+        static void TransformDirections(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                        SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+        static void ProjectPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                  SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded = false);
+
+    private:
+        //	Kernels write whole batches of the widest width, so chunk borders never split a batch.
+        //	16 vectors are also a multiple of StreamAlignment for every layout, so aligned chunks stay aligned.
+        static constexpr unsigned int ChunkGranularity = 16;
+
+        //	Non-temporal stores of the widest kernels need 32 byte aligned destinations.
+        static constexpr unsigned int StreamAlignment = 32;
+
+        //	TTranslate transforms (x, y, z, 1) instead of (x, y, z, 0), TDivide divides the result by its W.
+        template <bool TTranslate, bool TDivide, typename TValue>
+        static void TransformVector3(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded);
+
+        template <bool TTranslate, bool TDivide, typename TValue>
+        static void TransformVector3(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* const* streams, unsigned int count, bool multithreaded);
+
+        template <bool TDivide, typename TValue>
+        static void TransformVector4(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded);
+
+        template <bool TTranslate, bool TDivide, typename TValue>
+        static Vector3<TValue> TransformOne(const Matrix4x4<TValue>& matrix, const Vector3<TValue>& vector);
+
+        template <bool TDivide, typename TValue>
+        static Vector4<TValue> TransformOne(const Matrix4x4<TValue>& matrix, const Vector4<TValue>& vector);
+
+        //	Gives whether an output of outputSize bytes at destination should be written with non-temporal stores,
+        //	and lead, how many leading elements of elementSize bytes have to be written normally until destination is aligned for it.
+        static bool Streaming(const void* destination, unsigned int elementSize, uint64 outputSize, unsigned int& lead);
+
+        template <typename TElement>
+        static const float* Values(const TElement* elements);
+
+        static float* Values(Matrix4x4<float>* matrices);
+
+        template <typename TElement>
+        static float* Values(TElement* elements);
+
+        //	Kernel structs SIMD::Dispatch picks from. The AVX2 kernels also run on AVX-512 CPUs.
+        using Kernels = SIMD::Kernels<MatrixBatchKernelsSSE, MatrixBatchKernelsAVX2, MatrixBatchKernelsAVX2>;
+
+        static void CheckLengths(unsigned int leftLength, unsigned int rightLength);
+    };
+
+    template <typename TValue>
+    void MatrixBatch::TransformPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        TransformVector3<true, false>(matrix, source, destination, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::TransformDirections(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        TransformVector3<false, false>(matrix, source, destination, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::ProjectPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        TransformVector3<true, true>(matrix, source, destination, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::Transform(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        TransformVector4<false>(matrix, source, destination, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::Project(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        TransformVector4<true>(matrix, source, destination, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::Inverse(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedMatrixChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].Inverse();
+            }
+        });
+    }
+
+    template <typename TValue>
+    void MatrixBatch::InverseAffine(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedMatrixChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].InverseAffine();
+            }
+        });
+    }
+
+    template <typename TValue>
+    void MatrixBatch::InverseRigid(const Matrix4x4<TValue>* source, Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedMatrixChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int i = chunkBegin; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].InverseRigid();
+            }
+        });
+    }
+
+    template <typename TValue>
+    void MatrixBatch::TransformationMatrices(const TValue* const* translations, const TValue* const* rotations, const TValue* const* scales,
+                                             Matrix4x4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedMatrixChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    const float* const translationStreams[3] = { translations[0] + chunkBegin, translations[1] + chunkBegin, translations[2] + chunkBegin };
+                    const float* const rotationStreams[4] = { rotations[0] + chunkBegin, rotations[1] + chunkBegin, rotations[2] + chunkBegin, rotations[3] + chunkBegin };
+                    const float* const scaleStreams[3] = { scales[0] + chunkBegin, scales[1] + chunkBegin, scales[2] + chunkBegin };
+                    return decltype(kernels)::TransformationMatrices(translationStreams, rotationStreams, scaleStreams, Values(destination + chunkBegin), chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = Matrix4x4<TValue>::TransformationMatrix(Vector3<TValue>(translations[0][i], translations[1][i], translations[2][i]),
+                                                                         Quaternion<TValue>(rotations[0][i], rotations[1][i], rotations[2][i], rotations[3][i]),
+                                                                         Vector3<TValue>(scales[0][i], scales[1][i], scales[2][i]));
+            }
+        });
+    }
+
+    template <typename TValue>
+    void MatrixBatch::TransformPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded)
+    {
+        TValue* const streams[3] = { x, y, z };
+        TransformVector3<true, false>(matrix, source, streams, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::TransformDirections(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded)
+    {
+        TValue* const streams[3] = { x, y, z };
+        TransformVector3<false, false>(matrix, source, streams, count, multithreaded);
+    }
+
+    template <typename TValue>
+    void MatrixBatch::ProjectPoints(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* x, TValue* y, TValue* z, unsigned int count, bool multithreaded)
+    {
+        TValue* const streams[3] = { x, y, z };
+        TransformVector3<true, true>(matrix, source, streams, count, multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::TransformPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                      Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        TransformPoints(matrix, source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::TransformDirections(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                          Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        TransformDirections(matrix, source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::ProjectPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                    Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        ProjectPoints(matrix, source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::Transform(const Matrix4x4<TValue>& matrix, const Array<Vector4<TValue>, TAllocator, TAlignment>& source,
+                                Array<Vector4<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        Transform(matrix, source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::Project(const Matrix4x4<TValue>& matrix, const Array<Vector4<TValue>, TAllocator, TAlignment>& source,
+                              Array<Vector4<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        Project(matrix, source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::Inverse(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                              bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        Inverse(source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::InverseAffine(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                    bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        InverseAffine(source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void MatrixBatch::InverseRigid(const Array<Matrix4x4<TValue>, TAllocator, TAlignment>& source, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                   bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        InverseRigid(source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TTranslationAllocator, typename TRotationAllocator, typename TScaleAllocator, typename TResultAllocator,
+              unsigned int TResultAlignment>
+    void MatrixBatch::TransformationMatrices(const SoAArray<Vector3<TValue>, TTranslationAllocator>& translations, const SoAArray<Quaternion<TValue>, TRotationAllocator>& rotations,
+                                             const SoAArray<Vector3<TValue>, TScaleAllocator>& scales, Array<Matrix4x4<TValue>, TResultAllocator, TResultAlignment>& destination,
+                                             bool multithreaded)
+    {
+        CheckLengths(translations.Length(), rotations.Length());
+        CheckLengths(translations.Length(), scales.Length());
+        destination.Resize(translations.Length());
+
+        const TValue* const translationStreams[3] = { translations.Stream(0), translations.Stream(1), translations.Stream(2) };
+        const TValue* const rotationStreams[4] = { rotations.Stream(0), rotations.Stream(1), rotations.Stream(2), rotations.Stream(3) };
+        const TValue* const scaleStreams[3] = { scales.Stream(0), scales.Stream(1), scales.Stream(2) };
+        TransformationMatrices(translationStreams, rotationStreams, scaleStreams, destination.GetSource(), translations.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+    void MatrixBatch::TransformPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                      SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        TransformPoints(matrix, source.GetSource(), destination.Stream(0), destination.Stream(1), destination.Stream(2), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+    void MatrixBatch::TransformDirections(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                          SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        TransformDirections(matrix, source.GetSource(), destination.Stream(0), destination.Stream(1), destination.Stream(2), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator>
+    void MatrixBatch::ProjectPoints(const Matrix4x4<TValue>& matrix, const Array<Vector3<TValue>, TAllocator, TAlignment>& source,
+                                    SoAArray<Vector3<TValue>, TResultAllocator>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        ProjectPoints(matrix, source.GetSource(), destination.Stream(0), destination.Stream(1), destination.Stream(2), source.Length(), multithreaded);
+    }
+
+    template <bool TTranslate, bool TDivide, typename TValue>
+    void MatrixBatch::TransformVector3(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        unsigned int lead = 0;
+        bool stream = false;
+        if constexpr (std::is_same_v<TValue, float>)
+        {
+            stream = Streaming(destination, sizeof(Vector3<TValue>), static_cast<uint64>(count) * sizeof(Vector3<TValue>), lead);
+        }
+
+        for (unsigned int i = 0; i < lead; i++)
+        {
+            destination[i] = TransformOne<TTranslate, TDivide>(matrix, source[i]);
+        }
+
+        Parallel::For(lead, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=, &matrix](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    using Selected = decltype(kernels);
+                    const float* values = Values(source + chunkBegin);
+                    float* results = Values(destination + chunkBegin);
+                    return stream ? Selected::template TransformVector3<TTranslate, TDivide, true>(&matrix[0], values, results, chunkEnd - chunkBegin)
+                                  : Selected::template TransformVector3<TTranslate, TDivide, false>(&matrix[0], values, results, chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = TransformOne<TTranslate, TDivide>(matrix, source[i]);
+            }
+        });
+    }
+
+    template <bool TTranslate, bool TDivide, typename TValue>
+    void MatrixBatch::TransformVector3(const Matrix4x4<TValue>& matrix, const Vector3<TValue>* source, TValue* const* streams, unsigned int count, bool multithreaded)
+    {
+        //	The streams are only written non-temporally when one lead aligns all three of them, which SoAArray always does.
+        unsigned int lead = 0;
+        bool stream = false;
+        if constexpr (std::is_same_v<TValue, float>)
+        {
+            const std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(streams[0]) % StreamAlignment;
+            stream = Streaming(streams[0], sizeof(TValue), static_cast<uint64>(count) * sizeof(Vector3<TValue>), lead) &&
+                     reinterpret_cast<std::uintptr_t>(streams[1]) % StreamAlignment == offset &&
+                     reinterpret_cast<std::uintptr_t>(streams[2]) % StreamAlignment == offset;
+            lead = stream ? lead : 0;
+        }
+
+        TValue* const x = streams[0];
+        TValue* const y = streams[1];
+        TValue* const z = streams[2];
+        const auto scalar = [=, &matrix](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; i++)
+            {
+                const Vector3<TValue> result = TransformOne<TTranslate, TDivide>(matrix, source[i]);
+                x[i] = result.X;
+                y[i] = result.Y;
+                z[i] = result.Z;
+            }
+        };
+        scalar(0, lead);
+
+        Parallel::For(lead, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=, &matrix](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    using Selected = decltype(kernels);
+                    const float* values = Values(source + chunkBegin);
+                    float* const results[3] = { x + chunkBegin, y + chunkBegin, z + chunkBegin };
+                    return stream ? Selected::template TransformVector3ToStreams<TTranslate, TDivide, true>(&matrix[0], values, results, chunkEnd - chunkBegin)
+                                  : Selected::template TransformVector3ToStreams<TTranslate, TDivide, false>(&matrix[0], values, results, chunkEnd - chunkBegin);
+                });
+            }
+
+            scalar(chunkBegin + processed, chunkEnd);
+        });
+    }
+
+    template <bool TDivide, typename TValue>
+    void MatrixBatch::TransformVector4(const Matrix4x4<TValue>& matrix, const Vector4<TValue>* source, Vector4<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        unsigned int lead = 0;
+        bool stream = false;
+        if constexpr (std::is_same_v<TValue, float>)
+        {
+            stream = Streaming(destination, sizeof(Vector4<TValue>), static_cast<uint64>(count) * sizeof(Vector4<TValue>), lead);
+        }
+
+        for (unsigned int i = 0; i < lead; i++)
+        {
+            destination[i] = TransformOne<TDivide>(matrix, source[i]);
+        }
+
+        Parallel::For(lead, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=, &matrix](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    using Selected = decltype(kernels);
+                    const float* values = Values(source + chunkBegin);
+                    float* results = Values(destination + chunkBegin);
+                    return stream ? Selected::template TransformVector4<TDivide, true>(&matrix[0], values, results, chunkEnd - chunkBegin)
+                                  : Selected::template TransformVector4<TDivide, false>(&matrix[0], values, results, chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = TransformOne<TDivide>(matrix, source[i]);
+            }
+        });
+    }
+
+    template <bool TTranslate, bool TDivide, typename TValue>
+    Vector3<TValue> MatrixBatch::TransformOne(const Matrix4x4<TValue>& matrix, const Vector3<TValue>& vector)
+    {
+        if constexpr (TDivide)
+        {
+            const Vector4<TValue> result = matrix.Transform(Vector4<TValue>(vector.X, vector.Y, vector.Z, TTranslate ? TValue(1) : TValue(0)));
+            return Vector3<TValue>(result.X / result.W, result.Y / result.W, result.Z / result.W);
+        }
+        else if constexpr (TTranslate)
+        {
+            return matrix.TransformPoint(vector);
+        }
+        else
+        {
+            return matrix.TransformDirection(vector);
+        }
+    }
+
+    template <bool TDivide, typename TValue>
+    Vector4<TValue> MatrixBatch::TransformOne(const Matrix4x4<TValue>& matrix, const Vector4<TValue>& vector)
+    {
+        const Vector4<TValue> result = matrix.Transform(vector);
+        if constexpr (TDivide)
+        {
+            return Vector4<TValue>(result.X / result.W, result.Y / result.W, result.Z / result.W, TValue(1));
+        }
+        else
+        {
+            return result;
+        }
+    }
+
+    inline bool MatrixBatch::Streaming(const void* destination, unsigned int elementSize, uint64 outputSize, unsigned int& lead)
+    {
+        lead = 0;
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(destination);
+        if (outputSize < StreamingThreshold || address % sizeof(float) != 0)
+        {
+            return false;
+        }
+
+        //	elementSize is a multiple of a float, so if no lead below this aligns it, none does.
+        while ((address + lead * elementSize) % StreamAlignment != 0)
+        {
+            if (++lead == StreamAlignment / sizeof(float))
+            {
+                lead = 0;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename TElement>
+    const float* MatrixBatch::Values(const TElement* elements)
+    {
+        static_assert(sizeof(TElement) == TElement::Num() * sizeof(float), "Batch elements must be tightly packed floats");
+        return reinterpret_cast<const float*>(elements);
+    }
+
+    template <typename TElement>
+    float* MatrixBatch::Values(TElement* elements)
+    {
+        static_assert(sizeof(TElement) == TElement::Num() * sizeof(float), "Batch elements must be tightly packed floats");
+        return reinterpret_cast<float*>(elements);
+    }
+
+    inline float* MatrixBatch::Values(Matrix4x4<float>* matrices)
+    {
+        static_assert(sizeof(Matrix4x4<float>) == 16 * sizeof(float), "Batch elements must be tightly packed floats");
+        return reinterpret_cast<float*>(matrices);
+    }
+
+    inline void MatrixBatch::CheckLengths(unsigned int leftLength, unsigned int rightLength)
+    {
+        if (leftLength != rightLength)
+        {
+            throw "Out of Range";
+        }
+    }
+}
@@ -0,0 +1,213 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  These are the SIMD kernels behind MatrixBatch. There is no #pragma once on purpose, MatrixBatch.h includes
+ *  this file once per instruction set with these defined:
+ *  -   ENGINE_BATCH_KERNELS: Name of the kernel struct. (MatrixBatchKernelsSSE, MatrixBatchKernelsAVX2)
+ *  -   ENGINE_BATCH_LANES: Lane type of the instruction set. (SIMD::Float4Lanes, Float8Lanes)
+ *  -   ENGINE_BATCH_TARGET: Target attribute of the instruction set. (ENGINE_TARGET_AVX2 or nothing for SSE)
+ *
+ *  Every kernel works on flat float arrays, matrix is the 16 floats of a Matrix4x4 and one vector is 3 or 4 floats,
+ *  except TransformationMatrices which reads its inputs from SoA streams.
+ *  Vectors are loaded and stored with the interleaved shuffles of the lanes, not with gathers.
+ *  TTranslate transforms (x, y, z, 1) instead of (x, y, z, 0), TDivide divides the result by its W,
+ *  TStream writes with non-temporal stores and needs destination aligned to 32 bytes.
+ *  Kernels only process full batches of Lanes::Width elements and give how many they processed,
+ *  MatrixBatch finishes the rest.
+ *
+ *****************************************************************************************************/
+
+namespace Engine
+{
+    struct ENGINE_BATCH_KERNELS
+    {
+        using Lanes = ENGINE_BATCH_LANES;
+        using Register = Lanes::Register;
+
+        template <bool TTranslate, bool TDivide, bool TStream>
+        ENGINE_BATCH_TARGET static unsigned int TransformVector3(const float* matrix, const float* source, float* destination, unsigned int count)
+        {
+            Register rows[16];
+            LoadMatrix(matrix, rows);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register x, y, z;
+                Lanes::LoadInterleaved3(source + i * 3, x, y, z);
+
+                Transform<TTranslate, TDivide>(rows, x, y, z);
+                Lanes::template StoreInterleaved3<TStream>(destination + i * 3, x, y, z);
+            }
+
+            Fence<TStream>();
+            return batchedCount;
+        }
+
+        //	Same as TransformVector3 but every component goes to its own stream, destinations[c][i].
+        template <bool TTranslate, bool TDivide, bool TStream>
+        ENGINE_BATCH_TARGET static unsigned int TransformVector3ToStreams(const float* matrix, const float* source, float* const* destinations, unsigned int count)
+        {
+            Register rows[16];
+            LoadMatrix(matrix, rows);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register x, y, z;
+                Lanes::LoadInterleaved3(source + i * 3, x, y, z);
+
+                Transform<TTranslate, TDivide>(rows, x, y, z);
+                if constexpr (TStream)
+                {
+                    Lanes::Stream(destinations[0] + i, x);
+                    Lanes::Stream(destinations[1] + i, y);
+                    Lanes::Stream(destinations[2] + i, z);
+                }
+                else
+                {
+                    Lanes::Store(destinations[0] + i, x);
+                    Lanes::Store(destinations[1] + i, y);
+                    Lanes::Store(destinations[2] + i, z);
+                }
+            }
+
+            Fence<TStream>();
+            return batchedCount;
+        }
+
+        //	TDivide divides X, Y and Z by W and writes 1 to W.
+        template <bool TDivide, bool TStream>
+        ENGINE_BATCH_TARGET static unsigned int TransformVector4(const float* matrix, const float* source, float* destination, unsigned int count)
+        {
+            Register rows[16];
+            LoadMatrix(matrix, rows);
+            const Register one = Lanes::Set(1.0f);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register x, y, z, w;
+                Lanes::LoadInterleaved4(source + i * 4, x, y, z, w);
+
+                Register resultX = Lanes::MultiplyAdd(w, rows[12], Column<false>(rows, 0, x, y, z));
+                Register resultY = Lanes::MultiplyAdd(w, rows[13], Column<false>(rows, 1, x, y, z));
+                Register resultZ = Lanes::MultiplyAdd(w, rows[14], Column<false>(rows, 2, x, y, z));
+                Register resultW = Lanes::MultiplyAdd(w, rows[15], Column<false>(rows, 3, x, y, z));
+                if constexpr (TDivide)
+                {
+                    resultX = Lanes::Divide(resultX, resultW);
+                    resultY = Lanes::Divide(resultY, resultW);
+                    resultZ = Lanes::Divide(resultZ, resultW);
+                    resultW = one;
+                }
+                Lanes::template StoreInterleaved4<TStream>(destination + i * 4, resultX, resultY, resultZ, resultW);
+            }
+
+            Fence<TStream>();
+            return batchedCount;
+        }
+
+        //	translations, rotations and scales are SoA streams, (X, Y, Z), quaternion (X, Y, Z, W) and (X, Y, Z).
+        //	destination gets one Matrix4x4 per element, the same as Matrix4x4::TransformationMatrix with a quaternion.
+        ENGINE_BATCH_TARGET static unsigned int TransformationMatrices(const float* const* translations, const float* const* rotations, const float* const* scales,
+                                                                       float* destination, unsigned int count)
+        {
+            const Register zero = Lanes::Set(0.0f);
+            const Register one = Lanes::Set(1.0f);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const Register x = Lanes::Load(rotations[0] + i);
+                const Register y = Lanes::Load(rotations[1] + i);
+                const Register z = Lanes::Load(rotations[2] + i);
+                const Register w = Lanes::Load(rotations[3] + i);
+                const Register scaleX = Lanes::Load(scales[0] + i);
+                const Register scaleY = Lanes::Load(scales[1] + i);
+                const Register scaleZ = Lanes::Load(scales[2] + i);
+
+                //	Products with the doubled components save the 2 * of Quaternion::ToMatrix4x4.
+                const Register x2 = Lanes::Add(x, x);
+                const Register y2 = Lanes::Add(y, y);
+                const Register z2 = Lanes::Add(z, z);
+                const Register xx = Lanes::Multiply(x, x2), yy = Lanes::Multiply(y, y2), zz = Lanes::Multiply(z, z2);
+                const Register xy = Lanes::Multiply(x, y2), xz = Lanes::Multiply(x, z2), yz = Lanes::Multiply(y, z2);
+                const Register wx = Lanes::Multiply(w, x2), wy = Lanes::Multiply(w, y2), wz = Lanes::Multiply(w, z2);
+
+                float* matrices = destination + i * 16;
+                Lanes::StoreStrided4(matrices, 16,
+                                     Lanes::Multiply(scaleX, Lanes::Subtract(Lanes::Subtract(one, yy), zz)),
+                                     Lanes::Multiply(scaleX, Lanes::Add(xy, wz)),
+                                     Lanes::Multiply(scaleX, Lanes::Subtract(xz, wy)), zero);
+                Lanes::StoreStrided4(matrices + 4, 16,
+                                     Lanes::Multiply(scaleY, Lanes::Subtract(xy, wz)),
+                                     Lanes::Multiply(scaleY, Lanes::Subtract(Lanes::Subtract(one, xx), zz)),
+                                     Lanes::Multiply(scaleY, Lanes::Add(yz, wx)), zero);
+                Lanes::StoreStrided4(matrices + 8, 16,
+                                     Lanes::Multiply(scaleZ, Lanes::Add(xz, wy)),
+                                     Lanes::Multiply(scaleZ, Lanes::Subtract(yz, wx)),
+                                     Lanes::Multiply(scaleZ, Lanes::Subtract(Lanes::Subtract(one, xx), yy)), zero);
+                Lanes::StoreStrided4(matrices + 12, 16, Lanes::Load(translations[0] + i), Lanes::Load(translations[1] + i), Lanes::Load(translations[2] + i), one);
+            }
+            return batchedCount;
+        }
+
+        ENGINE_BATCH_TARGET static void LoadMatrix(const float* matrix, Register* rows)
+        {
+            for (unsigned int element = 0; element < 16; element++)
+            {
+                rows[element] = Lanes::Set(matrix[element]);
+            }
+        }
+
+        //	x * m[0][column] + y * m[1][column] + z * m[2][column], plus m[3][column] when TTranslate.
+        template <bool TTranslate>
+        ENGINE_BATCH_TARGET static Register Column(const Register* rows, unsigned int column, Register x, Register y, Register z)
+        {
+            Register sum;
+            if constexpr (TTranslate)
+            {
+                sum = Lanes::MultiplyAdd(x, rows[column], rows[12 + column]);
+            }
+            else
+            {
+                sum = Lanes::Multiply(x, rows[column]);
+            }
+            return Lanes::MultiplyAdd(z, rows[8 + column], Lanes::MultiplyAdd(y, rows[4 + column], sum));
+        }
+
+        //	Overwrites x, y and z with the transformed vectors.
+        template <bool TTranslate, bool TDivide>
+        ENGINE_BATCH_TARGET static void Transform(const Register* rows, Register& x, Register& y, Register& z)
+        {
+            const Register resultX = Column<TTranslate>(rows, 0, x, y, z);
+            const Register resultY = Column<TTranslate>(rows, 1, x, y, z);
+            const Register resultZ = Column<TTranslate>(rows, 2, x, y, z);
+            if constexpr (TDivide)
+            {
+                const Register w = Column<TTranslate>(rows, 3, x, y, z);
+                x = Lanes::Divide(resultX, w);
+                y = Lanes::Divide(resultY, w);
+                z = Lanes::Divide(resultZ, w);
+            }
+            else
+            {
+                x = resultX;
+                y = resultY;
+                z = resultZ;
+            }
+        }
+
+        //	Non-temporal stores are weakly ordered, the fence makes them visible before the thread is joined.
+        template <bool TStream>
+        ENGINE_BATCH_TARGET static void Fence()
+        {
+            if constexpr (TStream)
+            {
+                _mm_sfence();
+            }
+        }
+    };
+}
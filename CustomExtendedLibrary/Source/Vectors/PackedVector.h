@@ -0,0 +1,354 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  These are compact storage formats for float vectors. They are meant for storing and streaming, convert them
+ *  back to Vector3 / Vector4 before doing math. PackedVectorBatch.h converts whole arrays with SIMD.
+ *
+ *  Current capabilities:
+ *  -   HalfVector3 (6 bytes), HalfVector4 (8 bytes). IEEE half floats, rounded to nearest even.
+ *      Relative error is at most 2^-11 for magnitudes in [2^-14, 65504], absolute error is at most 2^-25 below
+ *      that range. Magnitudes of 65520 and above become infinity, NaN stays NaN and is quieted both ways like F16C.
+ *  -   SNorm16Vector3 (6 bytes). Each element is clamped to [-1, 1] and stored as round(value * 32767). NaN is stored as 0,
+ *      the same for every signed normalized format below.
+ *      Absolute error is 1 / 65534 plus float rounding, below 1.54e-5 per element.
+ *  -   PackedNormal (4 bytes). 10:10:10:2 signed normalized, X in the lowest bits. X, Y, Z are clamped to [-1, 1]
+ *      with an absolute error of at most 1 / 1022 (about 9.79e-4). W only keeps -1, 0 and 1, which is enough
+ *      for the handedness of a tangent frame.
+ *  -   OctahedralNormal (4 bytes). Unit vector folded onto an octahedron and stored as two snorm16.
+ *      Decoding gives a unit vector, the angle to the input is below 7e-5 radians. A zero vector decodes as (0, 0, 1).
+ *  -   Packing, the scalar conversions every type and every batch tail uses.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/CoreAPI.h"
+#include "Core/Types.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Engine
+{
+    class Packing
+    {
+    public:
+        Packing() = delete;
+        ~Packing() = delete;
+
+        //	Float to IEEE half, rounded to nearest even. Gives the same bits as F16C.
+        FORCEINLINE static uint16 FloatToHalf(float value);
+
+        //	A signaling NaN half becomes a quiet NaN float, the same as F16C.
+        FORCEINLINE static float HalfToFloat(uint16 value);
+
+        //	Clamps to [-1, 1], NaN becomes 0.
+        FORCEINLINE static float ClampSigned(float value);
+
+        //	Clamps to [-1, 1] and rounds value * 32767 to nearest even.
+        FORCEINLINE static int16 FloatToSNorm16(float value);
+
+        FORCEINLINE static float SNorm16ToFloat(int16 value);
+
+        //	Clamps to [-1, 1] and rounds value * 511 to nearest even, the result is in the low 10 bits.
+        FORCEINLINE static uint32 FloatToSNorm10(float value);
+
+        //	Reads the low 10 bits as a signed number.
+        FORCEINLINE static float SNorm10ToFloat(uint32 bits);
+
+        FORCEINLINE static void EncodeOctahedral(const Vector3<float>& vector, int16& x, int16& y);
+
+        FORCEINLINE static Vector3<float> DecodeOctahedral(int16 x, int16 y);
+    };
+
+    class HalfVector3
+    {
+    public:
+        //	If it is not initialized, it is zero vector.
+        HalfVector3();
+
+        explicit HalfVector3(const Vector3<float>& vector);
+
+        uint16 X, Y, Z;
+
+        FORCEINLINE Vector3<float> ToVector3() const;
+    };
+
+    class HalfVector4
+    {
+    public:
+        //	If it is not initialized, it is zero vector.
+        HalfVector4();
+
+        explicit HalfVector4(const Vector4<float>& vector);
+
+        uint16 X, Y, Z, W;
+
+        FORCEINLINE Vector4<float> ToVector4() const;
+    };
+
+    class SNorm16Vector3
+    {
+    public:
+        //	If it is not initialized, it is zero vector.
+        SNorm16Vector3();
+
+        explicit SNorm16Vector3(const Vector3<float>& vector);
+
+        int16 X, Y, Z;
+
+        FORCEINLINE Vector3<float> ToVector3() const;
+    };
+
+    class PackedNormal
+    {
+    public:
+        //	If it is not initialized, it is zero vector.
+        PackedNormal();
+
+        //	W is stored as 0.
+        explicit PackedNormal(const Vector3<float>& vector);
+
+        explicit PackedNormal(const Vector4<float>& vector);
+
+        uint32 Value;
+
+        FORCEINLINE Vector3<float> ToVector3() const;
+
+        FORCEINLINE Vector4<float> ToVector4() const;
+    };
+
+    class OctahedralNormal
+    {
+    public:
+        //	If it is not initialized, it decodes as (0, 0, 1).
+        OctahedralNormal();
+
+        //	The vector does not need to be normalized, only its direction is stored.
+        explicit OctahedralNormal(const Vector3<float>& vector);
+
+        int16 X, Y;
+
+        FORCEINLINE Vector3<float> ToVector3() const;
+    };
+
+    inline uint16 Packing::FloatToHalf(float value)
+    {
+        uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32 sign = (bits >> 16) & 0x8000;
+        bits &= 0x7FFFFFFF;
+
+        //	Infinity, NaN (quiet, upper payload bits kept) and everything that would round past 65504.
+        if (bits >= 0x47800000)
+        {
+            return static_cast<uint16>(sign | (bits > 0x7F800000 ? 0x7E00 | ((bits >> 13) & 0x3FF) : 0x7C00));
+        }
+
+        //	Below 2^-14 the result is a subnormal half. Adding 0.5 lines the half mantissa up with the
+        //	float mantissa, so the float addition does the round to nearest even.
+        if (bits < 0x38800000)
+        {
+            float magnitude;
+            std::memcpy(&magnitude, &bits, sizeof(magnitude));
+            magnitude += 0.5f;
+            std::memcpy(&bits, &magnitude, sizeof(bits));
+            return static_cast<uint16>(sign | (bits - 0x3F000000));
+        }
+
+        //	Rebias the exponent and round the 13 dropped bits to nearest even, a carry moves into the exponent.
+        const uint32 mantissaOdd = (bits >> 13) & 1;
+        bits += 0xC8000FFF + mantissaOdd;
+        return static_cast<uint16>(sign | (bits >> 13));
+    }
+
+    inline float Packing::HalfToFloat(uint16 value)
+    {
+        const uint32 exponent = value & 0x7C00;
+        uint32 bits = (value & 0x7FFF) << 13;
+
+        if (exponent == 0x7C00)
+        {
+            bits += 0x70000000;
+            if (value & 0x3FF)
+            {
+                bits |= 0x00400000;
+            }
+        }
+        else if (exponent == 0)
+        {
+            //	Subnormal half, let the float subtraction normalize it.
+            bits += 0x38800000;
+            float magnitude;
+            std::memcpy(&magnitude, &bits, sizeof(magnitude));
+            magnitude -= 6.103515625e-05f;
+            std::memcpy(&bits, &magnitude, sizeof(bits));
+        }
+        else
+        {
+            bits += 0x38000000;
+        }
+
+        bits |= static_cast<uint32>(value & 0x8000) << 16;
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    inline float Packing::ClampSigned(float value)
+    {
+        if (value != value)
+        {
+            return 0.0f;
+        }
+        return value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    }
+
+    inline int16 Packing::FloatToSNorm16(float value)
+    {
+        return static_cast<int16>(std::lrint(ClampSigned(value) * 32767.0f));
+    }
+
+    inline float Packing::SNorm16ToFloat(int16 value)
+    {
+        const float result = static_cast<float>(value) * (1.0f / 32767.0f);
+        return result < -1.0f ? -1.0f : result;
+    }
+
+    inline uint32 Packing::FloatToSNorm10(float value)
+    {
+        return static_cast<uint32>(std::lrint(ClampSigned(value) * 511.0f)) & 0x3FF;
+    }
+
+    inline float Packing::SNorm10ToFloat(uint32 bits)
+    {
+        const int32 value = static_cast<int32>(bits << 22) >> 22;
+        const float result = static_cast<float>(value) * (1.0f / 511.0f);
+        return result < -1.0f ? -1.0f : result;
+    }
+
+    inline void Packing::EncodeOctahedral(const Vector3<float>& vector, int16& x, int16& y)
+    {
+        //	Projects onto |x| + |y| + |z| = 1. FLT_MIN keeps the zero vector at zero instead of NaN.
+        const float sum = std::fabs(vector.X) + std::fabs(vector.Y) + std::fabs(vector.Z);
+        const float inverseSum = 1.0f / (sum > FLT_MIN ? sum : FLT_MIN);
+        float octahedralX = vector.X * inverseSum;
+        float octahedralY = vector.Y * inverseSum;
+
+        //	The lower half is folded over the diagonals onto the corners of the square.
+        if (vector.Z < 0.0f)
+        {
+            const float foldedX = (1.0f - std::fabs(octahedralY)) * (octahedralX >= 0.0f ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - std::fabs(octahedralX)) * (octahedralY >= 0.0f ? 1.0f : -1.0f);
+            octahedralX = foldedX;
+            octahedralY = foldedY;
+        }
+
+        x = FloatToSNorm16(octahedralX);
+        y = FloatToSNorm16(octahedralY);
+    }
+
+    inline Vector3<float> Packing::DecodeOctahedral(int16 x, int16 y)
+    {
+        float vectorX = SNorm16ToFloat(x);
+        float vectorY = SNorm16ToFloat(y);
+        const float vectorZ = 1.0f - std::fabs(vectorX) - std::fabs(vectorY);
+
+        //	Unfolds the lower half, t is zero on the upper half.
+        const float t = -vectorZ > 0.0f ? -vectorZ : 0.0f;
+        vectorX += vectorX >= 0.0f ? -t : t;
+        vectorY += vectorY >= 0.0f ? -t : t;
+
+        const float length = std::sqrt(vectorX * vectorX + vectorY * vectorY + vectorZ * vectorZ);
+        return Vector3<float>(vectorX / length, vectorY / length, vectorZ / length);
+    }
+
+    inline HalfVector3::HalfVector3() : X(0), Y(0), Z(0)
+    {
+    }
+
+    inline HalfVector3::HalfVector3(const Vector3<float>& vector)
+        : X(Packing::FloatToHalf(vector.X)), Y(Packing::FloatToHalf(vector.Y)), Z(Packing::FloatToHalf(vector.Z))
+    {
+    }
+
+    inline Vector3<float> HalfVector3::ToVector3() const
+    {
+        return Vector3<float>(Packing::HalfToFloat(X), Packing::HalfToFloat(Y), Packing::HalfToFloat(Z));
+    }
+
+    inline HalfVector4::HalfVector4() : X(0), Y(0), Z(0), W(0)
+    {
+    }
+
+    inline HalfVector4::HalfVector4(const Vector4<float>& vector)
+        : X(Packing::FloatToHalf(vector.X)), Y(Packing::FloatToHalf(vector.Y)), Z(Packing::FloatToHalf(vector.Z)), W(Packing::FloatToHalf(vector.W))
+    {
+    }
+
+    inline Vector4<float> HalfVector4::ToVector4() const
+    {
+        return Vector4<float>(Packing::HalfToFloat(X), Packing::HalfToFloat(Y), Packing::HalfToFloat(Z), Packing::HalfToFloat(W));
+    }
+
+    inline SNorm16Vector3::SNorm16Vector3() : X(0), Y(0), Z(0)
+    {
+    }
+
+    inline SNorm16Vector3::SNorm16Vector3(const Vector3<float>& vector)
+        : X(Packing::FloatToSNorm16(vector.X)), Y(Packing::FloatToSNorm16(vector.Y)), Z(Packing::FloatToSNorm16(vector.Z))
+    {
+    }
+
+    inline Vector3<float> SNorm16Vector3::ToVector3() const
+    {
+        return Vector3<float>(Packing::SNorm16ToFloat(X), Packing::SNorm16ToFloat(Y), Packing::SNorm16ToFloat(Z));
+    }
+
+    inline PackedNormal::PackedNormal() : Value(0)
+    {
+    }
+
+    inline PackedNormal::PackedNormal(const Vector3<float>& vector)
+        : Value(Packing::FloatToSNorm10(vector.X) | (Packing::FloatToSNorm10(vector.Y) << 10) | (Packing::FloatToSNorm10(vector.Z) << 20))
+    {
+    }
+
+    inline PackedNormal::PackedNormal(const Vector4<float>& vector) : PackedNormal(Vector3<float>(vector.X, vector.Y, vector.Z))
+    {
+        Value |= (static_cast<uint32>(std::lrint(Packing::ClampSigned(vector.W))) & 0x3) << 30;
+    }
+
+    inline Vector3<float> PackedNormal::ToVector3() const
+    {
+        return Vector3<float>(Packing::SNorm10ToFloat(Value), Packing::SNorm10ToFloat(Value >> 10), Packing::SNorm10ToFloat(Value >> 20));
+    }
+
+    inline Vector4<float> PackedNormal::ToVector4() const
+    {
+        //	The 2 bit W can also hold -2, which reads as -1 like the other elements.
+        const int32 w = static_cast<int32>(Value) >> 30;
+        return Vector4<float>(Packing::SNorm10ToFloat(Value), Packing::SNorm10ToFloat(Value >> 10), Packing::SNorm10ToFloat(Value >> 20),
+                              w < -1 ? -1.0f : static_cast<float>(w));
+    }
+
+    inline OctahedralNormal::OctahedralNormal() : X(0), Y(0)
+    {
+    }
+
+    inline OctahedralNormal::OctahedralNormal(const Vector3<float>& vector)
+    {
+        Packing::EncodeOctahedral(vector, X, Y);
+    }
+
+    inline Vector3<float> OctahedralNormal::ToVector3() const
+    {
+        return Packing::DecodeOctahedral(X, Y);
+    }
+}
@@ -0,0 +1,524 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is the batch converter between float vectors and the packed formats of PackedVector.h.
+ *
+ *  Current capabilities:
+ *  -   Pack and Unpack over pointer + count or over Engine::Array for HalfVector3, HalfVector4, SNorm16Vector3,
+ *      PackedNormal (from Vector3 or Vector4) and OctahedralNormal.
+ *  -   Half floats use F16C, 8 elements at a time, when the CPU has it and the active instruction set is AVX2 or wider.
+ *  -   The other formats use SSE2, 4 vectors (or 8 elements) at a time.
+ *  -   Every path gives the same bits as the scalar conversions in Packing, NaN included, leftovers run those.
+ *  -   Optional multithreaded split through Parallel::For for very large inputs.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Math/SIMD.h"
+#include "Vectors/PackedVector.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+
+namespace Engine
+{
+    class PackedVectorBatch
+    {
+    public:
+        PackedVectorBatch() = delete;
+        ~PackedVectorBatch() = delete;
+
+        //	Each thread gets at least this many vectors, so smaller inputs stay on the calling thread.
+        static constexpr unsigned int MultithreadedChunkLength = 16384;
+
+        //	destination[i] = TPacked(source[i]).
+        static void Pack(const Vector3<float>* source, HalfVector3* destination, unsigned int count, bool multithreaded = false);
+        static void Pack(const Vector4<float>* source, HalfVector4* destination, unsigned int count, bool multithreaded = false);
+        static void Pack(const Vector3<float>* source, SNorm16Vector3* destination, unsigned int count, bool multithreaded = false);
+        static void Pack(const Vector3<float>* source, PackedNormal* destination, unsigned int count, bool multithreaded = false);
+        static void Pack(const Vector4<float>* source, PackedNormal* destination, unsigned int count, bool multithreaded = false);
+        static void Pack(const Vector3<float>* source, OctahedralNormal* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = source[i].ToVector3() or ToVector4().
+        static void Unpack(const HalfVector3* source, Vector3<float>* destination, unsigned int count, bool multithreaded = false);
+        static void Unpack(const HalfVector4* source, Vector4<float>* destination, unsigned int count, bool multithreaded = false);
+        static void Unpack(const SNorm16Vector3* source, Vector3<float>* destination, unsigned int count, bool multithreaded = false);
+        static void Unpack(const PackedNormal* source, Vector3<float>* destination, unsigned int count, bool multithreaded = false);
+        static void Unpack(const PackedNormal* source, Vector4<float>* destination, unsigned int count, bool multithreaded = false);
+        static void Unpack(const OctahedralNormal* source, Vector3<float>* destination, unsigned int count, bool multithreaded = false);
+
+        //	Array versions resize destination to the length of source.
+        template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TPacked, typename TPackedAllocator, unsigned int TPackedAlignment>
+        static void Pack(const Array<TVector, TAllocator, TAlignment>& source, Array<TPacked, TPackedAllocator, TPackedAlignment>& destination, bool multithreaded = false);
+
+        template <typename TPacked, typename TPackedAllocator, unsigned int TPackedAlignment, typename TVector, typename TAllocator, unsigned int TAlignment>
+        static void Unpack(const Array<TPacked, TPackedAllocator, TPackedAlignment>& source, Array<TVector, TAllocator, TAlignment>& destination, bool multithreaded = false);
+
+    private:
+        //	Kernels write whole batches of 8 elements or 4 vectors, so chunk borders never split a batch.
+        static constexpr unsigned int ChunkGranularity = 8;
+
+        static bool CanUseSSE();
+        static bool CanUseF16C();
+
+        //	Kernels give how many vectors (or elements for the flat ones) they processed.
+#if ENGINE_SIMD_SSE
+        ENGINE_TARGET_F16C static unsigned int PackHalfF16C(const float* source, uint16* destination, unsigned int valueCount);
+        ENGINE_TARGET_F16C static unsigned int UnpackHalfF16C(const uint16* source, float* destination, unsigned int valueCount);
+        static unsigned int PackSNorm16SSE(const float* source, int16* destination, unsigned int valueCount);
+        static unsigned int UnpackSNorm16SSE(const int16* source, float* destination, unsigned int valueCount);
+        template <unsigned int TComponents>
+        static unsigned int PackNormalSSE(const float* source, uint32* destination, unsigned int count);
+        template <unsigned int TComponents>
+        static unsigned int UnpackNormalSSE(const uint32* source, float* destination, unsigned int count);
+        static unsigned int PackOctahedralSSE(const float* source, int16* destination, unsigned int count);
+        static unsigned int UnpackOctahedralSSE(const int16* source, float* destination, unsigned int count);
+
+        static __m128 ClampSigned(__m128 values);
+#endif
+    };
+
+    inline void PackedVectorBatch::Pack(const Vector3<float>* source, HalfVector3* destination, unsigned int count, bool multithreaded)
+    {
+        static_assert(sizeof(HalfVector3) == 3 * sizeof(uint16), "HalfVector3 must be tightly packed");
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const float* values = &source[chunkBegin].X;
+            uint16* halves = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 3;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseF16C())
+                processed = PackHalfF16C(values, halves, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                halves[i] = Packing::FloatToHalf(values[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Pack(const Vector4<float>* source, HalfVector4* destination, unsigned int count, bool multithreaded)
+    {
+        static_assert(sizeof(HalfVector4) == 4 * sizeof(uint16), "HalfVector4 must be tightly packed");
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const float* values = &source[chunkBegin].X;
+            uint16* halves = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 4;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseF16C())
+                processed = PackHalfF16C(values, halves, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                halves[i] = Packing::FloatToHalf(values[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Pack(const Vector3<float>* source, SNorm16Vector3* destination, unsigned int count, bool multithreaded)
+    {
+        static_assert(sizeof(SNorm16Vector3) == 3 * sizeof(int16), "SNorm16Vector3 must be tightly packed");
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const float* values = &source[chunkBegin].X;
+            int16* packed = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 3;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = PackSNorm16SSE(values, packed, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                packed[i] = Packing::FloatToSNorm16(values[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Pack(const Vector3<float>* source, PackedNormal* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = PackNormalSSE<3>(&source[chunkBegin].X, &destination[chunkBegin].Value, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = PackedNormal(source[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Pack(const Vector4<float>* source, PackedNormal* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = PackNormalSSE<4>(&source[chunkBegin].X, &destination[chunkBegin].Value, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = PackedNormal(source[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Pack(const Vector3<float>* source, OctahedralNormal* destination, unsigned int count, bool multithreaded)
+    {
+        static_assert(sizeof(OctahedralNormal) == 2 * sizeof(int16), "OctahedralNormal must be tightly packed");
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = PackOctahedralSSE(&source[chunkBegin].X, &destination[chunkBegin].X, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = OctahedralNormal(source[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const HalfVector3* source, Vector3<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const uint16* halves = &source[chunkBegin].X;
+            float* values = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 3;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseF16C())
+                processed = UnpackHalfF16C(halves, values, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                values[i] = Packing::HalfToFloat(halves[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const HalfVector4* source, Vector4<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const uint16* halves = &source[chunkBegin].X;
+            float* values = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 4;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseF16C())
+                processed = UnpackHalfF16C(halves, values, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                values[i] = Packing::HalfToFloat(halves[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const SNorm16Vector3* source, Vector3<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const int16* packed = &source[chunkBegin].X;
+            float* values = &destination[chunkBegin].X;
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * 3;
+
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = UnpackSNorm16SSE(packed, values, valueCount);
+#endif
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                values[i] = Packing::SNorm16ToFloat(packed[i]);
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const PackedNormal* source, Vector3<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = UnpackNormalSSE<3>(&source[chunkBegin].Value, &destination[chunkBegin].X, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].ToVector3();
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const PackedNormal* source, Vector4<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = UnpackNormalSSE<4>(&source[chunkBegin].Value, &destination[chunkBegin].X, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].ToVector4();
+            }
+        });
+    }
+
+    inline void PackedVectorBatch::Unpack(const OctahedralNormal* source, Vector3<float>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+#if ENGINE_SIMD_SSE
+            if (CanUseSSE())
+                processed = UnpackOctahedralSSE(&source[chunkBegin].X, &destination[chunkBegin].X, chunkEnd - chunkBegin);
+#endif
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = source[i].ToVector3();
+            }
+        });
+    }
+
+    template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TPacked, typename TPackedAllocator, unsigned int TPackedAlignment>
+    void PackedVectorBatch::Pack(const Array<TVector, TAllocator, TAlignment>& source, Array<TPacked, TPackedAllocator, TPackedAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        Pack(source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TPacked, typename TPackedAllocator, unsigned int TPackedAlignment, typename TVector, typename TAllocator, unsigned int TAlignment>
+    void PackedVectorBatch::Unpack(const Array<TPacked, TPackedAllocator, TPackedAlignment>& source, Array<TVector, TAllocator, TAlignment>& destination, bool multithreaded)
+    {
+        destination.Resize(source.Length());
+        Unpack(source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    inline bool PackedVectorBatch::CanUseSSE()
+    {
+        return SIMD::ActiveInstructionSet() != SIMD::InstructionSet::Scalar;
+    }
+
+    //	F16C is detected on its own, the active instruction set still limits it so LimitInstructionSet reaches every path.
+    inline bool PackedVectorBatch::CanUseF16C()
+    {
+        return SIMD::ActiveInstructionSet() >= SIMD::InstructionSet::AVX2 && SIMD::HasF16C();
+    }
+
+#if ENGINE_SIMD_SSE
+    ENGINE_TARGET_F16C inline unsigned int PackedVectorBatch::PackHalfF16C(const float* source, uint16* destination, unsigned int valueCount)
+    {
+        const unsigned int batchedCount = valueCount / 8 * 8;
+        for (unsigned int i = 0; i < batchedCount; i += 8)
+        {
+            const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), halves);
+        }
+        return batchedCount;
+    }
+
+    ENGINE_TARGET_F16C inline unsigned int PackedVectorBatch::UnpackHalfF16C(const uint16* source, float* destination, unsigned int valueCount)
+    {
+        const unsigned int batchedCount = valueCount / 8 * 8;
+        for (unsigned int i = 0; i < batchedCount; i += 8)
+        {
+            const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(halves));
+        }
+        return batchedCount;
+    }
+
+    inline unsigned int PackedVectorBatch::PackSNorm16SSE(const float* source, int16* destination, unsigned int valueCount)
+    {
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        const unsigned int batchedCount = valueCount / 8 * 8;
+        for (unsigned int i = 0; i < batchedCount; i += 8)
+        {
+            const __m128i low = _mm_cvtps_epi32(_mm_mul_ps(ClampSigned(_mm_loadu_ps(source + i)), scale));
+            const __m128i high = _mm_cvtps_epi32(_mm_mul_ps(ClampSigned(_mm_loadu_ps(source + i + 4)), scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+        }
+        return batchedCount;
+    }
+
+    inline unsigned int PackedVectorBatch::UnpackSNorm16SSE(const int16* source, float* destination, unsigned int valueCount)
+    {
+        const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+        const __m128 minimum = _mm_set1_ps(-1.0f);
+        const unsigned int batchedCount = valueCount / 8 * 8;
+        for (unsigned int i = 0; i < batchedCount; i += 8)
+        {
+            //	Unpacking a register with itself puts every int16 in the high half of an int32, the shift sign extends it.
+            const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+            const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+            _mm_storeu_ps(destination + i, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(low), scale), minimum));
+            _mm_storeu_ps(destination + i + 4, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(high), scale), minimum));
+        }
+        return batchedCount;
+    }
+
+    template <unsigned int TComponents>
+    unsigned int PackedVectorBatch::PackNormalSSE(const float* source, uint32* destination, unsigned int count)
+    {
+        using Lanes = SIMD::Float4Lanes;
+        const __m128 scale = _mm_set1_ps(511.0f);
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+        const unsigned int batchedCount = count / 4 * 4;
+        for (unsigned int i = 0; i < batchedCount; i += 4)
+        {
+            const float* batch = source + i * TComponents;
+            __m128i packed = _mm_setzero_si128();
+            for (unsigned int c = 0; c < 3; c++)
+            {
+                const __m128i element = _mm_cvtps_epi32(_mm_mul_ps(ClampSigned(Lanes::LoadStrided(batch + c, TComponents)), scale));
+                packed = _mm_or_si128(packed, _mm_sll_epi32(_mm_and_si128(element, mask), _mm_cvtsi32_si128(static_cast<int>(c * 10))));
+            }
+
+            if constexpr (TComponents == 4)
+            {
+                const __m128i w = _mm_cvtps_epi32(ClampSigned(Lanes::LoadStrided(batch + 3, 4)));
+                packed = _mm_or_si128(packed, _mm_slli_epi32(w, 30));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+        }
+        return batchedCount;
+    }
+
+    template <unsigned int TComponents>
+    unsigned int PackedVectorBatch::UnpackNormalSSE(const uint32* source, float* destination, unsigned int count)
+    {
+        using Lanes = SIMD::Float4Lanes;
+        const __m128 scale = _mm_set1_ps(1.0f / 511.0f);
+        const __m128 minimum = _mm_set1_ps(-1.0f);
+        const unsigned int batchedCount = count / 4 * 4;
+        for (unsigned int i = 0; i < batchedCount; i += 4)
+        {
+            const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            float* batch = destination + i * TComponents;
+
+            //	Shifting the field to the top and back down sign extends it.
+            for (unsigned int c = 0; c < 3; c++)
+            {
+                const __m128i element = _mm_srai_epi32(_mm_sll_epi32(packed, _mm_cvtsi32_si128(static_cast<int>(22 - c * 10))), 22);
+                Lanes::StoreStrided(batch + c, TComponents, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(element), scale), minimum));
+            }
+
+            if constexpr (TComponents == 4)
+            {
+                Lanes::StoreStrided(batch + 3, 4, _mm_max_ps(_mm_cvtepi32_ps(_mm_srai_epi32(packed, 30)), minimum));
+            }
+        }
+        return batchedCount;
+    }
+
+    inline unsigned int PackedVectorBatch::PackOctahedralSSE(const float* source, int16* destination, unsigned int count)
+    {
+        using Lanes = SIMD::Float4Lanes;
+        const __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        const unsigned int batchedCount = count / 4 * 4;
+        for (unsigned int i = 0; i < batchedCount; i += 4)
+        {
+            const float* batch = source + i * 3;
+            const __m128 x = Lanes::LoadStrided(batch, 3);
+            const __m128 y = Lanes::LoadStrided(batch + 1, 3);
+            const __m128 z = Lanes::LoadStrided(batch + 2, 3);
+
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_and_ps(x, absoluteMask), _mm_and_ps(y, absoluteMask)), _mm_and_ps(z, absoluteMask));
+            const __m128 inverseSum = _mm_div_ps(one, _mm_max_ps(sum, _mm_set1_ps(FLT_MIN)));
+            const __m128 octahedralX = _mm_mul_ps(x, inverseSum);
+            const __m128 octahedralY = _mm_mul_ps(y, inverseSum);
+
+            const __m128 positiveX = _mm_cmpge_ps(octahedralX, zero);
+            const __m128 positiveY = _mm_cmpge_ps(octahedralY, zero);
+            const __m128 signX = _mm_or_ps(_mm_and_ps(positiveX, one), _mm_andnot_ps(positiveX, minusOne));
+            const __m128 signY = _mm_or_ps(_mm_and_ps(positiveY, one), _mm_andnot_ps(positiveY, minusOne));
+            const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octahedralY, absoluteMask)), signX);
+            const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octahedralX, absoluteMask)), signY);
+
+            const __m128 lowerHalf = _mm_cmplt_ps(z, zero);
+            const __m128 resultX = _mm_or_ps(_mm_and_ps(lowerHalf, foldedX), _mm_andnot_ps(lowerHalf, octahedralX));
+            const __m128 resultY = _mm_or_ps(_mm_and_ps(lowerHalf, foldedY), _mm_andnot_ps(lowerHalf, octahedralY));
+
+            const __m128i packedX = _mm_cvtps_epi32(_mm_mul_ps(ClampSigned(resultX), scale));
+            const __m128i packedY = _mm_cvtps_epi32(_mm_mul_ps(ClampSigned(resultY), scale));
+
+            //	Interleaves to x0 y0 x1 y1 ... before narrowing to int16.
+            const __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(packedX, packedY), _mm_unpackhi_epi32(packedX, packedY));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 2), packed);
+        }
+        return batchedCount;
+    }
+
+    inline unsigned int PackedVectorBatch::UnpackOctahedralSSE(const int16* source, float* destination, unsigned int count)
+    {
+        using Lanes = SIMD::Float4Lanes;
+        const __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minimum = _mm_set1_ps(-1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+        const unsigned int batchedCount = count / 4 * 4;
+        for (unsigned int i = 0; i < batchedCount; i += 4)
+        {
+            //	Every int32 holds one x in the low half and its y in the high half.
+            const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+            const __m128i packedX = _mm_srai_epi32(_mm_slli_epi32(packed, 16), 16);
+            const __m128i packedY = _mm_srai_epi32(packed, 16);
+
+            __m128 x = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(packedX), scale), minimum);
+            __m128 y = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(packedY), scale), minimum);
+            const __m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_and_ps(x, absoluteMask)), _mm_and_ps(y, absoluteMask));
+
+            //	Negation flips the sign bit like the scalar path, so zeros keep the same sign.
+            const __m128 t = _mm_max_ps(_mm_xor_ps(z, signMask), zero);
+            const __m128 negativeT = _mm_xor_ps(t, signMask);
+            const __m128 positiveX = _mm_cmpge_ps(x, zero);
+            const __m128 positiveY = _mm_cmpge_ps(y, zero);
+            x = _mm_add_ps(x, _mm_or_ps(_mm_and_ps(positiveX, negativeT), _mm_andnot_ps(positiveX, t)));
+            y = _mm_add_ps(y, _mm_or_ps(_mm_and_ps(positiveY, negativeT), _mm_andnot_ps(positiveY, t)));
+
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            float* batch = destination + i * 3;
+            Lanes::StoreStrided(batch, 3, _mm_div_ps(x, length));
+            Lanes::StoreStrided(batch + 1, 3, _mm_div_ps(y, length));
+            Lanes::StoreStrided(batch + 2, 3, _mm_div_ps(z, length));
+        }
+        return batchedCount;
+    }
+
+    //	Same as Packing::ClampSigned, NaN lanes are zeroed first because max and min would give -1 for them.
+    inline __m128 PackedVectorBatch::ClampSigned(__m128 values)
+    {
+        values = _mm_and_ps(values, _mm_cmpord_ps(values, values));
+        return _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    }
+#endif
+}
@@ -0,0 +1,367 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a Quaternion library which is created to store and combine rotations without the cost of matrices.
+ *
+ *  Current capabilities:
+ *  -   Initialization without defining the elements. (Returns Identity, no rotation)
+ *  -   AxisAngle (degrees, like Matrix4x4::RotationX/Y/Z), FromMatrix and ToMatrix4x4.
+ *  -   Multiplication (Hamilton product), Conjugate, Inverse, Rotate for Vector3.
+ *  -   Num. (Returns the count of element which is 4 for Quaternion)
+ *  -   Length, LengthSquared, Normalize and DotProduct with the Precision policy of the vectors. (Exact or Fast)
+ *  -   Nlerp and Slerp along the shortest path. Slerp<Precision::Fast> needs no trigonometry at all,
+ *      it is a polynomial (error below 4e-5, which only shows on rotations far apart) that QuaternionBatch runs with SIMD.
+ *  -   constexpr constructors, operators, Multiply, Conjugate, DotProduct, Rotate. (Compile time tables)
+ *
+ *  The rotation of X, Y, Z is stored with sin(angle / 2), W is cos(angle / 2). Only unit quaternions are rotations.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Core/CoreAPI.h"
+#include "Core/Types.h"
+#include "Math/Math.h"
+#include "Matrix/Matrix4x4.h"
+#include "Vectors/Vector3.h"
+
+#include <cmath>
+#include <type_traits>
+
+namespace Engine
+{
+    template <typename TValue>
+    class Quaternion
+    {
+    public:
+        //	If it is not initialized, it is identity. (No rotation)
+        constexpr Quaternion();
+
+        //	Initialization constructor.
+        constexpr Quaternion(TValue XValue, TValue YValue, TValue ZValue, TValue WValue);
+
+        TValue X, Y, Z, W;
+
+        //	Gives the quaternion which does not rotate.
+        FORCEINLINE static constexpr Quaternion Identity();
+
+        //	Rotation of angle degrees around axis. The axis has to be unit length.
+        FORCEINLINE static Quaternion AxisAngle(const Vector3<TValue>& Axis, TValue Angle);
+
+        //	Rotation part of a Matrix4x4 which is built by the Rotation functions. Scaled matrices give scaled quaternions.
+        FORCEINLINE static Quaternion FromMatrix(const Matrix4x4<TValue>& Matrix);
+
+        //	Rotation matrix of a unit quaternion, same layout as Matrix4x4::RotationX/Y/Z.
+        FORCEINLINE constexpr Matrix4x4<TValue> ToMatrix4x4() const;
+
+        //	Gives the length of 4 elements. Only unit quaternions are rotations.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE TValue Length() const;
+
+        //	Gives the squared length. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE constexpr TValue LengthSquared() const;
+
+        //	Gives the unit quaternion of the same rotation.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE Quaternion Normalize() const;
+
+        //	Negates the axis. For unit quaternions it is the inverse rotation and much cheaper than Inverse.
+        FORCEINLINE constexpr Quaternion Conjugate() const;
+
+        //	Inverse of any non zero quaternion.
+        FORCEINLINE constexpr Quaternion Inverse() const;
+
+        //	Rotates the vector. It is v + 2w(q x v) + 2q x (q x v), which is cheaper than q * v * Conjugate.
+        FORCEINLINE constexpr Vector3<TValue> Rotate(const Vector3<TValue>& Vector) const;
+
+        //	4 Dimensional Dot Product. Its absolute value is cos(angle / 2) of the rotation between two unit quaternions.
+        FORCEINLINE static constexpr TValue DotProduct(const Quaternion& Quat1, const Quaternion& Quat2);
+
+        //	Linear interpolation which is normalized afterwards. It takes the shortest path, so Quat2 might be negated.
+        //	The angular speed is not constant, but it is the cheapest blend for close rotations.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static Quaternion Nlerp(const Quaternion& Quat1, const Quaternion& Quat2, TValue Alpha);
+
+        //	Spherical interpolation with constant angular speed along the shortest path.
+        //	Exact uses acos and sin. Fast is the polynomial of "A Fast and Accurate Algorithm for Computing SLERP" (Eberly)
+        //	for float, other types fall back to Exact.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static Quaternion Slerp(const Quaternion& Quat1, const Quaternion& Quat2, TValue Alpha);
+
+        //	Gives the count of elements which is always equals 4.
+        FORCEINLINE static constexpr byte Num();
+
+        //	Quaternion * Quaternion (Hamilton product). The result rotates with Other first, then with this quaternion.
+        FORCEINLINE constexpr Quaternion operator*(const Quaternion& Other) const;
+
+        //	Quaternion * TValue. Multiplies each element with the TValue parameter.
+        FORCEINLINE constexpr Quaternion operator*(TValue Other) const;
+
+        //	Quaternion + Quaternion. Each element sums with the other quaternion's related element.
+        FORCEINLINE constexpr Quaternion operator+(const Quaternion& Other) const;
+
+        //	Quaternion - Quaternion. Each element subtracts with the other quaternion's related element.
+        FORCEINLINE constexpr Quaternion operator-(const Quaternion& Other) const;
+
+        //	Negates each element. The result is the same rotation.
+        FORCEINLINE constexpr Quaternion operator-() const;
+
+        //	Quaternion * Quaternion and overwrites on related Quaternion.
+        FORCEINLINE constexpr Quaternion& operator*=(const Quaternion& Other);
+
+        //	Boolean that checks if both quaternions are equal element by element. q and -q are the same rotation but not equal.
+        FORCEINLINE constexpr bool operator==(const Quaternion& Other) const;
+    };
+
+    //	Coefficients of Slerp<Precision::Fast>, shared with the batch kernels so both give the same results.
+    struct SlerpPolynomial
+    {
+        static constexpr unsigned int Order = 8;
+        static constexpr float Correction = 1.85298109240830f;
+
+        //	1 / (i * (2i + 1)) and i / (2i + 1), the last pair is scaled by Correction to make up for the truncated terms.
+        //	Each weight is then within 2e-5 of the exact one, the worst case is two rotations 180 degrees apart.
+        static constexpr float U[Order] = {
+            1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9), 1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), Correction / (8 * 17)
+        };
+        static constexpr float V[Order] = {
+            1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9, 5.0f / 11, 6.0f / 13, 7.0f / 15, Correction * 8 / 17
+        };
+
+        //	Weight of one end for the cosine x of the angle between the ends and its interpolation parameter t.
+        //	It approximates sin(t * angle) / sin(angle) from x - 1 and t * t.
+        static float Weight(float xMinusOne, float t);
+    };
+
+    inline float SlerpPolynomial::Weight(float xMinusOne, float t)
+    {
+        const float tSquared = t * t;
+        float weight = 1.0f;
+        for (unsigned int i = Order; i-- != 0;)
+        {
+            weight = 1.0f + (U[i] * tSquared - V[i]) * xMinusOne * weight;
+        }
+        return t * weight;
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue>::Quaternion() : X(0), Y(0), Z(0), W(1)
+    {
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue>::Quaternion(TValue XValue, TValue YValue, TValue ZValue, TValue WValue) : X(XValue), Y(YValue), Z(ZValue), W(WValue)
+    {
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::Identity()
+    {
+        return Quaternion(0, 0, 0, 1);
+    }
+
+    template <typename TValue>
+    Quaternion<TValue> Quaternion<TValue>::AxisAngle(const Vector3<TValue>& Axis, TValue Angle)
+    {
+        const TValue halfAngle = Angle * static_cast<TValue>(DEG_TO_RAD) / 2;
+        const TValue sine = static_cast<TValue>(std::sin(halfAngle));
+        return Quaternion(Axis.X * sine, Axis.Y * sine, Axis.Z * sine, static_cast<TValue>(std::cos(halfAngle)));
+    }
+
+    //	Shepperd's method, the square root is taken of the largest of w, x, y, z so it never divides by a small number.
+    template <typename TValue>
+    Quaternion<TValue> Quaternion<TValue>::FromMatrix(const Matrix4x4<TValue>& Matrix)
+    {
+        const TValue trace = Matrix[0] + Matrix[5] + Matrix[10];
+        if (trace > 0)
+        {
+            const TValue scale = static_cast<TValue>(std::sqrt(trace + 1)) * 2;
+            return Quaternion((Matrix[6] - Matrix[9]) / scale, (Matrix[8] - Matrix[2]) / scale, (Matrix[1] - Matrix[4]) / scale, scale / 4);
+        }
+
+        if (Matrix[0] > Matrix[5] && Matrix[0] > Matrix[10])
+        {
+            const TValue scale = static_cast<TValue>(std::sqrt(1 + Matrix[0] - Matrix[5] - Matrix[10])) * 2;
+            return Quaternion(scale / 4, (Matrix[4] + Matrix[1]) / scale, (Matrix[8] + Matrix[2]) / scale, (Matrix[6] - Matrix[9]) / scale);
+        }
+
+        if (Matrix[5] > Matrix[10])
+        {
+            const TValue scale = static_cast<TValue>(std::sqrt(1 + Matrix[5] - Matrix[0] - Matrix[10])) * 2;
+            return Quaternion((Matrix[4] + Matrix[1]) / scale, scale / 4, (Matrix[9] + Matrix[6]) / scale, (Matrix[8] - Matrix[2]) / scale);
+        }
+
+        const TValue scale = static_cast<TValue>(std::sqrt(1 + Matrix[10] - Matrix[0] - Matrix[5])) * 2;
+        return Quaternion((Matrix[8] + Matrix[2]) / scale, (Matrix[9] + Matrix[6]) / scale, scale / 4, (Matrix[1] - Matrix[4]) / scale);
+    }
+
+    template <typename TValue>
+    constexpr Matrix4x4<TValue> Quaternion<TValue>::ToMatrix4x4() const
+    {
+        const TValue xx = X * X, yy = Y * Y, zz = Z * Z;
+        const TValue xy = X * Y, xz = X * Z, yz = Y * Z;
+        const TValue wx = W * X, wy = W * Y, wz = W * Z;
+
+        return Matrix4x4<TValue>(
+            1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+            2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+            2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+            0, 0, 0, 1
+        );
+    }
+
+    template <typename TValue>
+    template <Precision TPrecision>
+    TValue Quaternion<TValue>::Length() const
+    {
+        return Math::Sqrt<TPrecision>(LengthSquared());
+    }
+
+    template <typename TValue>
+    constexpr TValue Quaternion<TValue>::LengthSquared() const
+    {
+        return X * X + Y * Y + Z * Z + W * W;
+    }
+
+    template <typename TValue>
+    template <Precision TPrecision>
+    Quaternion<TValue> Quaternion<TValue>::Normalize() const
+    {
+        if constexpr (TPrecision == Precision::Fast && std::is_floating_point_v<TValue>)
+        {
+            return *this * Math::InverseSqrt<TPrecision>(LengthSquared());
+        }
+        else
+        {
+            const TValue length = Length();
+            return Quaternion(X / length, Y / length, Z / length, W / length);
+        }
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::Conjugate() const
+    {
+        return Quaternion(-X, -Y, -Z, W);
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::Inverse() const
+    {
+        const TValue lengthSquared = LengthSquared();
+        return Quaternion(-X / lengthSquared, -Y / lengthSquared, -Z / lengthSquared, W / lengthSquared);
+    }
+
+    template <typename TValue>
+    constexpr Vector3<TValue> Quaternion<TValue>::Rotate(const Vector3<TValue>& Vector) const
+    {
+        const Vector3<TValue> axis(X, Y, Z);
+        const Vector3<TValue> twiceCross = Vector3<TValue>::CrossProduct(axis, Vector) * 2;
+        return Vector + twiceCross * W + Vector3<TValue>::CrossProduct(axis, twiceCross);
+    }
+
+    template <typename TValue>
+    constexpr TValue Quaternion<TValue>::DotProduct(const Quaternion& Quat1, const Quaternion& Quat2)
+    {
+        return Quat1.X * Quat2.X + Quat1.Y * Quat2.Y + Quat1.Z * Quat2.Z + Quat1.W * Quat2.W;
+    }
+
+    template <typename TValue>
+    template <Precision TPrecision>
+    Quaternion<TValue> Quaternion<TValue>::Nlerp(const Quaternion& Quat1, const Quaternion& Quat2, TValue Alpha)
+    {
+        const TValue toWeight = DotProduct(Quat1, Quat2) < 0 ? -Alpha : Alpha;
+        const TValue fromWeight = 1 - Alpha;
+        const Quaternion blend(Quat1.X * fromWeight + Quat2.X * toWeight, Quat1.Y * fromWeight + Quat2.Y * toWeight,
+                               Quat1.Z * fromWeight + Quat2.Z * toWeight, Quat1.W * fromWeight + Quat2.W * toWeight);
+        return blend.template Normalize<TPrecision>();
+    }
+
+    template <typename TValue>
+    template <Precision TPrecision>
+    Quaternion<TValue> Quaternion<TValue>::Slerp(const Quaternion& Quat1, const Quaternion& Quat2, TValue Alpha)
+    {
+        const TValue cosine = DotProduct(Quat1, Quat2);
+        const TValue sign = cosine < 0 ? static_cast<TValue>(-1) : static_cast<TValue>(1);
+        const TValue absoluteCosine = cosine * sign;
+
+        TValue fromWeight;
+        TValue toWeight;
+        if constexpr (TPrecision == Precision::Fast && std::is_same_v<TValue, float>)
+        {
+            fromWeight = SlerpPolynomial::Weight(absoluteCosine - 1, 1 - Alpha);
+            toWeight = SlerpPolynomial::Weight(absoluteCosine - 1, Alpha);
+        }
+        else
+        {
+            //	sin(angle) goes to zero for close rotations, the blend is a straight line there anyway.
+            if (absoluteCosine > static_cast<TValue>(0.9995))
+            {
+                return Nlerp(Quat1, Quat2, Alpha);
+            }
+
+            const TValue angle = static_cast<TValue>(std::acos(absoluteCosine));
+            const TValue inverseSine = 1 / static_cast<TValue>(std::sin(angle));
+            fromWeight = static_cast<TValue>(std::sin((1 - Alpha) * angle)) * inverseSine;
+            toWeight = static_cast<TValue>(std::sin(Alpha * angle)) * inverseSine;
+        }
+
+        toWeight *= sign;
+        return Quaternion(Quat1.X * fromWeight + Quat2.X * toWeight, Quat1.Y * fromWeight + Quat2.Y * toWeight,
+                          Quat1.Z * fromWeight + Quat2.Z * toWeight, Quat1.W * fromWeight + Quat2.W * toWeight);
+    }
+
+    template <typename TValue>
+    constexpr byte Quaternion<TValue>::Num()
+    {
+        return 4;
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::operator*(const Quaternion& Other) const
+    {
+        return Quaternion(
+            W * Other.X + X * Other.W + Y * Other.Z - Z * Other.Y,
+            W * Other.Y - X * Other.Z + Y * Other.W + Z * Other.X,
+            W * Other.Z + X * Other.Y - Y * Other.X + Z * Other.W,
+            W * Other.W - X * Other.X - Y * Other.Y - Z * Other.Z
+        );
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::operator*(TValue Other) const
+    {
+        return Quaternion((X * Other), (Y * Other), (Z * Other), (W * Other));
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::operator+(const Quaternion& Other) const
+    {
+        return Quaternion((X + Other.X), (Y + Other.Y), (Z + Other.Z), (W + Other.W));
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::operator-(const Quaternion& Other) const
+    {
+        return Quaternion((X - Other.X), (Y - Other.Y), (Z - Other.Z), (W - Other.W));
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue> Quaternion<TValue>::operator-() const
+    {
+        return Quaternion(-X, -Y, -Z, -W);
+    }
+
+    template <typename TValue>
+    constexpr Quaternion<TValue>& Quaternion<TValue>::operator*=(const Quaternion& Other)
+    {
+        *this = *this * Other;
+        return *this;
+    }
+
+    template <typename TValue>
+    constexpr bool Quaternion<TValue>::operator==(const Quaternion& Other) const
+    {
+        return X == Other.X && Y == Other.Y && Z == Other.Z && W == Other.W;
+    }
+}
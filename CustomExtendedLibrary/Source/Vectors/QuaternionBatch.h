@@ -0,0 +1,318 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a batch Quaternion library which rotates vector arrays and blends whole arrays of rotations at once.
+ *
+ *  Current capabilities:
+ *  -   Rotate an array of Vector3 by one quaternion (through its rotation matrix) or by one quaternion each.
+ *  -   Multiply, Nlerp and Slerp over arrays of quaternions, one alpha per pair. (Animation keys)
+ *  -   Float is processed 4, 8 or 16 at a time with SSE, AVX2 or AVX-512, picked at run time like VectorBatch.
+ *      Slerp only has a SIMD path for Precision::Fast, Exact needs acos and sin and runs the scalar Slerp.
+ *  -   Other element types and the leftover elements of a batch run the scalar Quaternion functions.
+ *  -   Pointer + count or Engine::Array, optional multithreaded split through Parallel::For.
+ *
+ *  Results can be written over one of the inputs, other overlaps of inputs and results are not supported.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Math/Math.h"
+#include "Math/SIMD.h"
+#include "Vectors/Quaternion.h"
+#include "Vectors/Vector3.h"
+
+#include <type_traits>
+
+#if ENGINE_SIMD_SSE
+#define ENGINE_BATCH_KERNELS QuaternionBatchKernelsSSE
+#define ENGINE_BATCH_LANES SIMD::Float4Lanes
+#define ENGINE_BATCH_TARGET
+#include "Vectors/QuaternionBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+
+#define ENGINE_BATCH_KERNELS QuaternionBatchKernelsAVX2
+#define ENGINE_BATCH_LANES SIMD::Float8Lanes
+#define ENGINE_BATCH_TARGET ENGINE_TARGET_AVX2
+#include "Vectors/QuaternionBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+
+#define ENGINE_BATCH_KERNELS QuaternionBatchKernelsAVX512
+#define ENGINE_BATCH_LANES SIMD::Float16Lanes
+#define ENGINE_BATCH_TARGET ENGINE_TARGET_AVX512
+#include "Vectors/QuaternionBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+#else
+namespace Engine
+{
+    //	Only named by SIMD::Kernels, which SIMD::Dispatch never instantiates without SIMD.
+    struct QuaternionBatchKernelsSSE;
+    struct QuaternionBatchKernelsAVX2;
+    struct QuaternionBatchKernelsAVX512;
+}
+#endif
+
+namespace Engine
+{
+    class QuaternionBatch
+    {
+    public:
+        QuaternionBatch() = delete;
+        ~QuaternionBatch() = delete;
+
+        //	Each thread gets at least this many elements, so smaller inputs stay on the calling thread.
+        static constexpr unsigned int MultithreadedChunkLength = 16384;
+
+        //	destination[i] = rotation.Rotate(source[i]). It converts rotation to a matrix once, which is 9 multiplies per vector.
+        template <typename TValue>
+        static void Rotate(const Quaternion<TValue>& rotation, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	destination[i] = rotations[i].Rotate(source[i]).
+        template <typename TValue>
+        static void Rotate(const Quaternion<TValue>* rotations, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = left[i] * right[i].
+        template <typename TValue>
+        static void Multiply(const Quaternion<TValue>* left, const Quaternion<TValue>* right, Quaternion<TValue>* results, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = Quaternion::Nlerp<TPrecision>(from[i], to[i], alphas[i]).
+        template <Precision TPrecision = Precision::Exact, typename TValue>
+        static void Nlerp(const Quaternion<TValue>* from, const Quaternion<TValue>* to, const TValue* alphas, Quaternion<TValue>* results, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = Quaternion::Slerp<TPrecision>(from[i], to[i], alphas[i]).
+        template <Precision TPrecision = Precision::Exact, typename TValue>
+        static void Slerp(const Quaternion<TValue>* from, const Quaternion<TValue>* to, const TValue* alphas, Quaternion<TValue>* results, unsigned int count, bool multithreaded = false);
+
+        //	Rotates every vector of the Array in place.
+        template <typename TValue, typename TAllocator, unsigned int TAlignment>
+        static void Rotate(const Quaternion<TValue>& rotation, Array<Vector3<TValue>, TAllocator, TAlignment>& vectors, bool multithreaded = false);
+
+        //	Array versions resize results to the length of the inputs. Inputs of different length throw "Out of Range".
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TVectorAllocator, unsigned int TVectorAlignment,
+                  typename TResultAllocator, unsigned int TResultAlignment>
+        static void Rotate(const Array<Quaternion<TValue>, TAllocator, TAlignment>& rotations, const Array<Vector3<TValue>, TVectorAllocator, TVectorAlignment>& source,
+                           Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Multiply(const Array<Quaternion<TValue>, TAllocator, TAlignment>& left, const Array<Quaternion<TValue>, TAllocator, TAlignment>& right,
+                             Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results, bool multithreaded = false);
+
+        template <Precision TPrecision = Precision::Exact, typename TValue, typename TAllocator, unsigned int TAlignment, typename TAlphaAllocator, unsigned int TAlphaAlignment,
+                  typename TResultAllocator, unsigned int TResultAlignment>
+        static void Nlerp(const Array<Quaternion<TValue>, TAllocator, TAlignment>& from, const Array<Quaternion<TValue>, TAllocator, TAlignment>& to,
+                          const Array<TValue, TAlphaAllocator, TAlphaAlignment>& alphas, Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results,
+                          bool multithreaded = false);
+
+        template <Precision TPrecision = Precision::Exact, typename TValue, typename TAllocator, unsigned int TAlignment, typename TAlphaAllocator, unsigned int TAlphaAlignment,
+                  typename TResultAllocator, unsigned int TResultAlignment>
+        static void Slerp(const Array<Quaternion<TValue>, TAllocator, TAlignment>& from, const Array<Quaternion<TValue>, TAllocator, TAlignment>& to,
+                          const Array<TValue, TAlphaAllocator, TAlphaAlignment>& alphas, Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results,
+                          bool multithreaded = false);
+
+    private:
+        //	Kernels write whole batches of the widest width, so chunk borders never split a batch.
+        static constexpr unsigned int ChunkGranularity = 16;
+
+        template <typename TElement>
+        static const float* Values(const TElement* elements);
+
+        template <typename TElement>
+        static float* Values(TElement* elements);
+
+        //	Kernel structs SIMD::Dispatch picks from.
+        using Kernels = SIMD::Kernels<QuaternionBatchKernelsSSE, QuaternionBatchKernelsAVX2, QuaternionBatchKernelsAVX512>;
+
+        static void CheckLengths(unsigned int leftLength, unsigned int rightLength);
+    };
+
+    template <typename TValue>
+    void QuaternionBatch::Rotate(const Quaternion<TValue>& rotation, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        const Matrix4x4<TValue> matrix = rotation.ToMatrix4x4();
+
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=, &matrix](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::RotateByMatrix(&matrix[0], Values(source + chunkBegin), Values(destination + chunkBegin), chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                const Vector3<TValue> vector = source[i];
+                destination[i] = Vector3<TValue>(vector.X * matrix[0] + vector.Y * matrix[4] + vector.Z * matrix[8],
+                                                 vector.X * matrix[1] + vector.Y * matrix[5] + vector.Z * matrix[9],
+                                                 vector.X * matrix[2] + vector.Y * matrix[6] + vector.Z * matrix[10]);
+            }
+        });
+    }
+
+    template <typename TValue>
+    void QuaternionBatch::Rotate(const Quaternion<TValue>* rotations, const Vector3<TValue>* source, Vector3<TValue>* destination, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::Rotate(Values(rotations + chunkBegin), Values(source + chunkBegin), Values(destination + chunkBegin), chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                destination[i] = rotations[i].Rotate(source[i]);
+            }
+        });
+    }
+
+    template <typename TValue>
+    void QuaternionBatch::Multiply(const Quaternion<TValue>* left, const Quaternion<TValue>* right, Quaternion<TValue>* results, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::Multiply(Values(left + chunkBegin), Values(right + chunkBegin), Values(results + chunkBegin), chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                results[i] = left[i] * right[i];
+            }
+        });
+    }
+
+    template <Precision TPrecision, typename TValue>
+    void QuaternionBatch::Nlerp(const Quaternion<TValue>* from, const Quaternion<TValue>* to, const TValue* alphas, Quaternion<TValue>* results, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::Nlerp(Values(from + chunkBegin), Values(to + chunkBegin), alphas + chunkBegin, Values(results + chunkBegin),
+                                                    chunkEnd - chunkBegin, TPrecision == Precision::Fast);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                results[i] = Quaternion<TValue>::template Nlerp<TPrecision>(from[i], to[i], alphas[i]);
+            }
+        });
+    }
+
+    template <Precision TPrecision, typename TValue>
+    void QuaternionBatch::Slerp(const Quaternion<TValue>* from, const Quaternion<TValue>* to, const TValue* alphas, Quaternion<TValue>* results, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            unsigned int processed = 0;
+            if constexpr (TPrecision == Precision::Fast && std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::Slerp(Values(from + chunkBegin), Values(to + chunkBegin), alphas + chunkBegin, Values(results + chunkBegin), chunkEnd - chunkBegin);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                results[i] = Quaternion<TValue>::template Slerp<TPrecision>(from[i], to[i], alphas[i]);
+            }
+        });
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment>
+    void QuaternionBatch::Rotate(const Quaternion<TValue>& rotation, Array<Vector3<TValue>, TAllocator, TAlignment>& vectors, bool multithreaded)
+    {
+        Rotate(rotation, vectors.GetSource(), vectors.GetSource(), vectors.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TVectorAllocator, unsigned int TVectorAlignment,
+              typename TResultAllocator, unsigned int TResultAlignment>
+    void QuaternionBatch::Rotate(const Array<Quaternion<TValue>, TAllocator, TAlignment>& rotations, const Array<Vector3<TValue>, TVectorAllocator, TVectorAlignment>& source,
+                                 Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& destination, bool multithreaded)
+    {
+        CheckLengths(rotations.Length(), source.Length());
+        destination.Resize(source.Length());
+        Rotate(rotations.GetSource(), source.GetSource(), destination.GetSource(), source.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void QuaternionBatch::Multiply(const Array<Quaternion<TValue>, TAllocator, TAlignment>& left, const Array<Quaternion<TValue>, TAllocator, TAlignment>& right,
+                                   Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results, bool multithreaded)
+    {
+        CheckLengths(left.Length(), right.Length());
+        results.Resize(left.Length());
+        Multiply(left.GetSource(), right.GetSource(), results.GetSource(), left.Length(), multithreaded);
+    }
+
+    template <Precision TPrecision, typename TValue, typename TAllocator, unsigned int TAlignment, typename TAlphaAllocator, unsigned int TAlphaAlignment,
+              typename TResultAllocator, unsigned int TResultAlignment>
+    void QuaternionBatch::Nlerp(const Array<Quaternion<TValue>, TAllocator, TAlignment>& from, const Array<Quaternion<TValue>, TAllocator, TAlignment>& to,
+                                const Array<TValue, TAlphaAllocator, TAlphaAlignment>& alphas, Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results,
+                                bool multithreaded)
+    {
+        CheckLengths(from.Length(), to.Length());
+        CheckLengths(from.Length(), alphas.Length());
+        results.Resize(from.Length());
+        Nlerp<TPrecision>(from.GetSource(), to.GetSource(), alphas.GetSource(), results.GetSource(), from.Length(), multithreaded);
+    }
+
+    template <Precision TPrecision, typename TValue, typename TAllocator, unsigned int TAlignment, typename TAlphaAllocator, unsigned int TAlphaAlignment,
+              typename TResultAllocator, unsigned int TResultAlignment>
+    void QuaternionBatch::Slerp(const Array<Quaternion<TValue>, TAllocator, TAlignment>& from, const Array<Quaternion<TValue>, TAllocator, TAlignment>& to,
+                                const Array<TValue, TAlphaAllocator, TAlphaAlignment>& alphas, Array<Quaternion<TValue>, TResultAllocator, TResultAlignment>& results,
+                                bool multithreaded)
+    {
+        CheckLengths(from.Length(), to.Length());
+        CheckLengths(from.Length(), alphas.Length());
+        results.Resize(from.Length());
+        Slerp<TPrecision>(from.GetSource(), to.GetSource(), alphas.GetSource(), results.GetSource(), from.Length(), multithreaded);
+    }
+
+    template <typename TElement>
+    const float* QuaternionBatch::Values(const TElement* elements)
+    {
+        static_assert(sizeof(TElement) == TElement::Num() * sizeof(float), "Batch elements must be tightly packed floats");
+        return reinterpret_cast<const float*>(elements);
+    }
+
+    template <typename TElement>
+    float* QuaternionBatch::Values(TElement* elements)
+    {
+        static_assert(sizeof(TElement) == TElement::Num() * sizeof(float), "Batch elements must be tightly packed floats");
+        return reinterpret_cast<float*>(elements);
+    }
+
+    inline void QuaternionBatch::CheckLengths(unsigned int leftLength, unsigned int rightLength)
+    {
+        if (leftLength != rightLength)
+        {
+            throw "Out of Range";
+        }
+    }
+}
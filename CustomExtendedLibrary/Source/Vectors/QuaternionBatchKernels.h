@@ -0,0 +1,215 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  These are the SIMD kernels behind QuaternionBatch. There is no #pragma once on purpose, QuaternionBatch.h includes
+ *  this file once per instruction set with these defined:
+ *  -   ENGINE_BATCH_KERNELS: Name of the kernel struct. (QuaternionBatchKernelsSSE, QuaternionBatchKernelsAVX2 ...)
+ *  -   ENGINE_BATCH_LANES: Lane type of the instruction set. (SIMD::Float4Lanes, Float8Lanes, Float16Lanes)
+ *  -   ENGINE_BATCH_TARGET: Target attribute of the instruction set. (ENGINE_TARGET_AVX2 ... or nothing for SSE)
+ *
+ *  Every kernel works on flat float arrays, one quaternion is 4 consecutive floats (X, Y, Z, W) and one vector is 3.
+ *  Both are loaded and stored with the interleaved shuffles of the lanes (a 4x4 transpose for quaternions), not with gathers.
+ *  Kernels only process full batches of Lanes::Width elements and give how many they processed,
+ *  QuaternionBatch finishes the rest.
+ *
+ *****************************************************************************************************/
+
+namespace Engine
+{
+    struct ENGINE_BATCH_KERNELS
+    {
+        using Lanes = ENGINE_BATCH_LANES;
+        using Register = Lanes::Register;
+
+        //	matrix is a rotation Matrix4x4, only the upper 3x3 is read.
+        ENGINE_BATCH_TARGET static unsigned int RotateByMatrix(const float* matrix, const float* source, float* destination, unsigned int count)
+        {
+            Register rows[9];
+            for (unsigned int row = 0; row < 3; row++)
+            {
+                for (unsigned int column = 0; column < 3; column++)
+                {
+                    rows[row * 3 + column] = Lanes::Set(matrix[row * 4 + column]);
+                }
+            }
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const unsigned int offset = i * 3;
+                Register x, y, z;
+                Lanes::LoadInterleaved3(source + offset, x, y, z);
+
+                Register results[3];
+                for (unsigned int column = 0; column < 3; column++)
+                {
+                    results[column] = Lanes::MultiplyAdd(z, rows[6 + column], Lanes::MultiplyAdd(y, rows[3 + column], Lanes::Multiply(x, rows[column])));
+                }
+                Lanes::StoreInterleaved3(destination + offset, results[0], results[1], results[2]);
+            }
+            return batchedCount;
+        }
+
+        ENGINE_BATCH_TARGET static unsigned int Rotate(const float* rotations, const float* source, float* destination, unsigned int count)
+        {
+            const Register two = Lanes::Set(2.0f);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register qx, qy, qz, qw;
+                Lanes::LoadInterleaved4(rotations + i * 4, qx, qy, qz, qw);
+
+                const unsigned int offset = i * 3;
+                Register x, y, z;
+                Lanes::LoadInterleaved3(source + offset, x, y, z);
+
+                //	t = 2 (q x v), v' = v + w t + q x t
+                const Register tx = Lanes::Multiply(two, Lanes::Subtract(Lanes::Multiply(qy, z), Lanes::Multiply(qz, y)));
+                const Register ty = Lanes::Multiply(two, Lanes::Subtract(Lanes::Multiply(qz, x), Lanes::Multiply(qx, z)));
+                const Register tz = Lanes::Multiply(two, Lanes::Subtract(Lanes::Multiply(qx, y), Lanes::Multiply(qy, x)));
+
+                Lanes::StoreInterleaved3(destination + offset,
+                                         Lanes::Add(Lanes::MultiplyAdd(qw, tx, x), Lanes::Subtract(Lanes::Multiply(qy, tz), Lanes::Multiply(qz, ty))),
+                                         Lanes::Add(Lanes::MultiplyAdd(qw, ty, y), Lanes::Subtract(Lanes::Multiply(qz, tx), Lanes::Multiply(qx, tz))),
+                                         Lanes::Add(Lanes::MultiplyAdd(qw, tz, z), Lanes::Subtract(Lanes::Multiply(qx, ty), Lanes::Multiply(qy, tx))));
+            }
+            return batchedCount;
+        }
+
+        ENGINE_BATCH_TARGET static unsigned int Multiply(const float* left, const float* right, float* results, unsigned int count)
+        {
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const unsigned int offset = i * 4;
+                Register a[4];
+                Register b[4];
+                LoadQuaternions(left + offset, a);
+                LoadQuaternions(right + offset, b);
+
+                const Register x = Lanes::Add(Lanes::MultiplyAdd(a[3], b[0], Lanes::Multiply(a[0], b[3])), Lanes::Subtract(Lanes::Multiply(a[1], b[2]), Lanes::Multiply(a[2], b[1])));
+                const Register y = Lanes::Add(Lanes::MultiplyAdd(a[3], b[1], Lanes::Multiply(a[1], b[3])), Lanes::Subtract(Lanes::Multiply(a[2], b[0]), Lanes::Multiply(a[0], b[2])));
+                const Register z = Lanes::Add(Lanes::MultiplyAdd(a[3], b[2], Lanes::Multiply(a[2], b[3])), Lanes::Subtract(Lanes::Multiply(a[0], b[1]), Lanes::Multiply(a[1], b[0])));
+                const Register w = Lanes::Subtract(Lanes::Multiply(a[3], b[3]), Lanes::MultiplyAdd(a[2], b[2], Lanes::MultiplyAdd(a[1], b[1], Lanes::Multiply(a[0], b[0]))));
+
+                Lanes::StoreInterleaved4(results + offset, x, y, z, w);
+            }
+            return batchedCount;
+        }
+
+        ENGINE_BATCH_TARGET static unsigned int Nlerp(const float* from, const float* to, const float* alphas, float* results, unsigned int count, bool fast)
+        {
+            const Register one = Lanes::Set(1.0f);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const unsigned int offset = i * 4;
+                Register a[4];
+                Register b[4];
+                LoadQuaternions(from + offset, a);
+                LoadQuaternions(to + offset, b);
+
+                Register cosine = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < 4; c++)
+                {
+                    cosine = Lanes::MultiplyAdd(a[c], b[c], cosine);
+                }
+
+                //	The shortest path negates the weight of the other end instead of the quaternion.
+                const Register alpha = Lanes::Load(alphas + i);
+                const Register fromWeight = Lanes::Subtract(one, alpha);
+                const Register toWeight = Lanes::FlipSign(alpha, cosine);
+
+                Register blend[4];
+                Register lengthSquared = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < 4; c++)
+                {
+                    blend[c] = Lanes::MultiplyAdd(b[c], toWeight, Lanes::Multiply(a[c], fromWeight));
+                    lengthSquared = Lanes::MultiplyAdd(blend[c], blend[c], lengthSquared);
+                }
+
+                if (fast)
+                {
+                    const Register inverseLength = Lanes::InverseSqrtFast(lengthSquared);
+                    for (unsigned int c = 0; c < 4; c++)
+                    {
+                        blend[c] = Lanes::Multiply(blend[c], inverseLength);
+                    }
+                }
+                else
+                {
+                    const Register length = Lanes::Sqrt(lengthSquared);
+                    for (unsigned int c = 0; c < 4; c++)
+                    {
+                        blend[c] = Lanes::Divide(blend[c], length);
+                    }
+                }
+                StoreQuaternions(results + offset, blend);
+            }
+            return batchedCount;
+        }
+
+        //	Slerp<Precision::Fast>, the weights are SlerpPolynomial::Weight for every lane.
+        ENGINE_BATCH_TARGET static unsigned int Slerp(const float* from, const float* to, const float* alphas, float* results, unsigned int count)
+        {
+            const Register one = Lanes::Set(1.0f);
+
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const unsigned int offset = i * 4;
+                Register a[4];
+                Register b[4];
+                LoadQuaternions(from + offset, a);
+                LoadQuaternions(to + offset, b);
+
+                Register cosine = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < 4; c++)
+                {
+                    cosine = Lanes::MultiplyAdd(a[c], b[c], cosine);
+                }
+
+                const Register cosineMinusOne = Lanes::Subtract(Lanes::FlipSign(cosine, cosine), one);
+                const Register alpha = Lanes::Load(alphas + i);
+                const Register fromWeight = Weight(cosineMinusOne, Lanes::Subtract(one, alpha));
+                const Register toWeight = Lanes::FlipSign(Weight(cosineMinusOne, alpha), cosine);
+
+                Register blend[4];
+                for (unsigned int c = 0; c < 4; c++)
+                {
+                    blend[c] = Lanes::MultiplyAdd(b[c], toWeight, Lanes::Multiply(a[c], fromWeight));
+                }
+                StoreQuaternions(results + offset, blend);
+            }
+            return batchedCount;
+        }
+
+        //	Lanes::Width quaternions into one register per component, X, Y, Z and W.
+        ENGINE_BATCH_TARGET static void LoadQuaternions(const float* values, Register* components)
+        {
+            Lanes::LoadInterleaved4(values, components[0], components[1], components[2], components[3]);
+        }
+
+        ENGINE_BATCH_TARGET static void StoreQuaternions(float* values, const Register* components)
+        {
+            Lanes::StoreInterleaved4(values, components[0], components[1], components[2], components[3]);
+        }
+
+        ENGINE_BATCH_TARGET static Register Weight(Register cosineMinusOne, Register t)
+        {
+            const Register one = Lanes::Set(1.0f);
+            const Register tSquared = Lanes::Multiply(t, t);
+
+            Register weight = one;
+            for (unsigned int i = SlerpPolynomial::Order; i-- != 0;)
+            {
+                const Register term = Lanes::Multiply(Lanes::Subtract(Lanes::Multiply(Lanes::Set(SlerpPolynomial::U[i]), tSquared), Lanes::Set(SlerpPolynomial::V[i])), cosineMinusOne);
+                weight = Lanes::MultiplyAdd(term, weight, one);
+            }
+            return Lanes::Multiply(t, weight);
+        }
+    };
+}
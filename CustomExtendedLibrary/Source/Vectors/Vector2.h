@@ -8,7 +8,9 @@
  *  -   All the operator functions including bool check which is defined as ==.
  *  -   Initialization without defining the elements. (Returns Zero Vector)
  *  -   Length, Normalize, Distance, DotProduct, CrossProduct.
+ *  -   LengthSquared, DistanceSquared and a Precision policy for Length, Normalize, Distance. (Exact or Fast)
  *  -   Num. (Returns the count of element which is 2 for Vector2)
+ *  -   constexpr constructors, operators, LengthSquared, DistanceSquared, DotProduct, CrossProduct. (Compile time tables)
  *  
  *****************************************************************************************************/
 
@@ -16,6 +18,9 @@
 
 #include "Core/CoreAPI.h"
 #include "Core/Types.h"
+#include "Math/Math.h"
+
+#include <type_traits>
 
 namespace Engine
 {
@@ -24,69 +29,78 @@ namespace Engine
     {
     public:
         //	If it is not initialized, it is zero vector.
-        Vector2();
+        constexpr Vector2();
         //	Initialization constructor.
-        Vector2(TValue XValue, TValue YValue);
+        constexpr Vector2(TValue XValue, TValue YValue);
 
         TValue X;
         TValue Y;
 
-        //	Gives the Distance from origin.
+        //	Gives the Distance from origin. Precision::Fast trades a few ULPs for speed on float.
+        template <Precision TPrecision = Precision::Exact>
         FORCEINLINE TValue Length() const;
 
+        //	Gives the squared distance from origin. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE constexpr TValue LengthSquared() const;
+
         //	Rates the current vector's each element in between 0 and 1.
-        FORCEINLINE Vector2 Normalize();
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE Vector2 Normalize() const;
 
         //	Gives the Distance of 2 vector points.
-        FORCEINLINE static TValue Distance(Vector2& Vec1, Vector2& Vec2);
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static TValue Distance(const Vector2& Vec1, const Vector2& Vec2);
+
+        //	Gives the squared distance of 2 vector points. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE static constexpr TValue DistanceSquared(const Vector2& Vec1, const Vector2& Vec2);
 
         //	Scalar multiplication method called Dot Product. Returns TValue.
-        FORCEINLINE static TValue DotProduct(Vector2& Vec1, Vector2& Vec2);
+        FORCEINLINE static constexpr TValue DotProduct(const Vector2& Vec1, const Vector2& Vec2);
 
         //	2 Dimensional CrossProduct returns the Z value.
-        FORCEINLINE static TValue CrossProduct(Vector2& Vec1, Vector2& Vec2);
+        FORCEINLINE static constexpr TValue CrossProduct(const Vector2& Vec1, const Vector2& Vec2);
 
         //	Gives the Length of the Vector2 which is always equals 2.
         FORCEINLINE static constexpr byte Num();
 
         //	Vector2 + Vector2. Each element sums with the other vector's related element.
-        FORCEINLINE Vector2 operator+(Vector2 Other) const;
+        FORCEINLINE constexpr Vector2 operator+(Vector2 Other) const;
 
         //	Vector2 + TValue. Add each element the TValue parameter.
-        FORCEINLINE Vector2 operator+(TValue Other) const;
+        FORCEINLINE constexpr Vector2 operator+(TValue Other) const;
 
         //	Vector2 + Vector2. Each element subtracts with the other vector's related element.
-        FORCEINLINE Vector2 operator-(Vector2 Other) const;
+        FORCEINLINE constexpr Vector2 operator-(Vector2 Other) const;
 
         //	Vector2 + TValue. Subtract the TValue parameter from each element.
-        FORCEINLINE Vector2 operator-(TValue Other) const;
+        FORCEINLINE constexpr Vector2 operator-(TValue Other) const;
 
         //	Vector2 * TValue. Multiplies each element with the TValue parameter.
-        FORCEINLINE Vector2 operator*(TValue Other) const;
+        FORCEINLINE constexpr Vector2 operator*(TValue Other) const;
 
         //	Vector2 * TValue. Divides each element with the TValue parameter.
-        FORCEINLINE Vector2 operator/(TValue Other) const;
+        FORCEINLINE constexpr Vector2 operator/(TValue Other) const;
 
         //	Vector2 + Vector2. Each element sums with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator+=(Vector2 Other);
+        FORCEINLINE constexpr Vector2& operator+=(Vector2 Other);
 
         //	Vector + TValue. Each element sums with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator+=(TValue Other);
+        FORCEINLINE constexpr Vector2& operator+=(TValue Other);
 
         //	Vector2 - Vector2. Each element sums with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator-=(Vector2 Other);
+        FORCEINLINE constexpr Vector2& operator-=(Vector2 Other);
 
         //	Vector - TValue. Each element subtract with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator-=(TValue Other);
+        FORCEINLINE constexpr Vector2& operator-=(TValue Other);
 
         //	Vector + TValue. Each element multiplies with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator*=(TValue Other);
+        FORCEINLINE constexpr Vector2& operator*=(TValue Other);
 
         //	Vector / TValue. Each element multiplies with the other vector's related element and overwrites on related Vector2.
-        FORCEINLINE Vector2 operator/=(TValue Other);
+        FORCEINLINE constexpr Vector2& operator/=(TValue Other);
 
         //	Boolean that checks if both 2 dimensional Vector
-        bool operator ==(Vector2 Other);
+        FORCEINLINE constexpr bool operator==(const Vector2& Other) const;
     };
 
     template <typename TValue>
@@ -96,135 +110,158 @@ namespace Engine
     }
 
     template <typename TValue>
-    Vector2<TValue>::Vector2()
+    constexpr Vector2<TValue>::Vector2() : X(0), Y(0)
     {
-        X = 0;
-        Y = 0;
     }
 
     template <typename TValue>
-    Vector2<TValue>::Vector2(TValue XValue, TValue YValue)
+    constexpr Vector2<TValue>::Vector2(TValue XValue, TValue YValue) : X(XValue), Y(YValue)
     {
-        X = XValue;
-        Y = YValue;
     }
 
     template <typename TValue>
+    template <Precision TPrecision>
     TValue Vector2<TValue>::Length() const
     {
-        return sqrt(pow(X, 2) + pow(Y, 2));
+        return Math::Sqrt<TPrecision>(LengthSquared());
+    }
+
+    template <typename TValue>
+    constexpr TValue Vector2<TValue>::LengthSquared() const
+    {
+        return X * X + Y * Y;
+    }
+
+    //	One square root for the whole vector instead of one per element.
+    template <typename TValue>
+    template <Precision TPrecision>
+    Vector2<TValue> Vector2<TValue>::Normalize() const
+    {
+        if constexpr (TPrecision == Precision::Fast && std::is_floating_point_v<TValue>)
+        {
+            const TValue inverseLength = Math::InverseSqrt<TPrecision>(LengthSquared());
+            return *this * inverseLength;
+        }
+        else
+        {
+            const TValue length = Length();
+            return Vector2(X / length, Y / length);
+        }
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::Normalize()
+    template <Precision TPrecision>
+    TValue Vector2<TValue>::Distance(const Vector2& Vec1, const Vector2& Vec2)
     {
-        return Vector2(X / Length(), Y / Length());
+        return Math::Sqrt<TPrecision>(DistanceSquared(Vec1, Vec2));
     }
 
     template <typename TValue>
-    TValue Vector2<TValue>::Distance(Vector2& Vec1, Vector2& Vec2)
+    constexpr TValue Vector2<TValue>::DistanceSquared(const Vector2& Vec1, const Vector2& Vec2)
     {
-        return sqrt(pow((Vec2.X - Vec1.X), 2) + pow((Vec2.Y - Vec1.Y), 2));
+        const TValue xDifference = Vec2.X - Vec1.X;
+        const TValue yDifference = Vec2.Y - Vec1.Y;
+        return xDifference * xDifference + yDifference * yDifference;
     }
 
     template <typename TValue>
-    TValue Vector2<TValue>::DotProduct(Vector2& Vec1, Vector2& Vec2)
+    constexpr TValue Vector2<TValue>::DotProduct(const Vector2& Vec1, const Vector2& Vec2)
     {
         return Vec1.X * Vec2.X + Vec1.Y * Vec2.Y;
     }
 
     template <typename TValue>
-    TValue Vector2<TValue>::CrossProduct(Vector2& Vec1, Vector2& Vec2)
+    constexpr TValue Vector2<TValue>::CrossProduct(const Vector2& Vec1, const Vector2& Vec2)
     {
         return Vec1.X * Vec2.Y - Vec1.Y * Vec2.X;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator+(Vector2 Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator+(Vector2 Other) const
     {
         return Vector2((X + Other.X), (Y + Other.Y));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator+(TValue Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator+(TValue Other) const
     {
         return Vector2((X + Other), (Y + Other));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator-(Vector2 Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator-(Vector2 Other) const
     {
         return Vector2((X - Other.X), (Y - Other.Y));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator-(TValue Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator-(TValue Other) const
     {
         return Vector2((X - Other), (Y - Other));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator*(TValue Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator*(TValue Other) const
     {
         return Vector2((X * Other), (Y * Other));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator/(TValue Other) const
+    constexpr Vector2<TValue> Vector2<TValue>::operator/(TValue Other) const
     {
         return Vector2((X / Other), (Y / Other));
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator+=(Vector2 Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator+=(Vector2 Other)
     {
         X += Other.X;
         Y += Other.Y;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator+=(TValue Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator+=(TValue Other)
     {
         X += Other;
         Y += Other;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator-=(Vector2 Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator-=(Vector2 Other)
     {
         X -= Other.X;
         Y -= Other.Y;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator-=(TValue Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator-=(TValue Other)
     {
         X -= Other;
         Y -= Other;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator*=(TValue Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator*=(TValue Other)
     {
         X *= Other;
         Y *= Other;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    Vector2<TValue> Vector2<TValue>::operator/=(TValue Other)
+    constexpr Vector2<TValue>& Vector2<TValue>::operator/=(TValue Other)
     {
         X /= Other;
         Y /= Other;
-        return Vector2(X, Y);
+        return *this;
     }
 
     template <typename TValue>
-    bool Vector2<TValue>::operator==(Vector2 Other)
+    constexpr bool Vector2<TValue>::operator==(const Vector2& Other) const
     {
         return Other.X == X && Other.Y == Y ? true : false;
     }
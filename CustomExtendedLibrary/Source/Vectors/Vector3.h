@@ -8,7 +8,9 @@
  *  -   All the operator functions including bool check which is defined as ==.
  *  -   Initialization without defining the elements. (Returns Zero Vector)
  *  -   Length, Normalize, Distance, DotProduct, CrossProduct.
+ *  -   LengthSquared, DistanceSquared and a Precision policy for Length, Normalize, Distance. (Exact or Fast)
  *  -   Num. (Returns the count of element which is 3 for Vector3)
+ *  -   constexpr constructors, operators, LengthSquared, DistanceSquared, DotProduct, CrossProduct. (Compile time tables)
  *  
  *****************************************************************************************************/
 
@@ -16,6 +18,9 @@
 
 #include "Core/CoreAPI.h"
 #include "Core/Types.h"
+#include "Math/Math.h"
+
+#include <type_traits>
 
 namespace Engine
 {
@@ -24,69 +29,78 @@ namespace Engine
     {
     public:
         //	If it is not initialized, it is zero vector.
-        Vector3();
+        constexpr Vector3();
 
         //	Initialization constructor.
-        Vector3(TValue XValue, TValue YValue, TValue ZValue);
+        constexpr Vector3(TValue XValue, TValue YValue, TValue ZValue);
 
         TValue X, Y, Z;
 
-        //	Gives the distance from origin.
-        FORCEINLINE TValue Length();
+        //	Gives the distance from origin. Precision::Fast trades a few ULPs for speed on float.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE TValue Length() const;
+
+        //	Gives the squared distance from origin. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE constexpr TValue LengthSquared() const;
 
         //	Rates the current vector's each element in between 0 and 1.
-        FORCEINLINE Vector3 Normalize();
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE Vector3 Normalize() const;
 
         //	Gives the distance of 2 vector points.
-        FORCEINLINE static TValue Distance(Vector3& Vec1, Vector3& Vec2);
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static TValue Distance(const Vector3& Vec1, const Vector3& Vec2);
+
+        //	Gives the squared distance of 2 vector points. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE static constexpr TValue DistanceSquared(const Vector3& Vec1, const Vector3& Vec2);
 
         //	Scalar multiplication method called Dot Product. Returns TValue.
-        FORCEINLINE static TValue DotProduct(Vector3& Vec1, Vector3& Vec2);
+        FORCEINLINE static constexpr TValue DotProduct(const Vector3& Vec1, const Vector3& Vec2);
 
         //	3 Dimensional CrossProduct returns normal vector of given two vectors.
-        FORCEINLINE static Vector3 CrossProduct(Vector3& Vec1, Vector3& Vec2);
+        FORCEINLINE static constexpr Vector3 CrossProduct(const Vector3& Vec1, const Vector3& Vec2);
 
         //	Gives the size of the Vector3 which is always equals 3.
         FORCEINLINE static constexpr byte Num();
 
         //	Vector3 + Vector3. Each element sums with the other vector's related element.
-        FORCEINLINE Vector3 operator+(Vector3& Other) const;
+        FORCEINLINE constexpr Vector3 operator+(const Vector3& Other) const;
 
         //	Vector3 + TValue. Add each element the TValue parameter.
-        FORCEINLINE Vector3 operator+(TValue& Other) const;
+        FORCEINLINE constexpr Vector3 operator+(TValue Other) const;
 
         //	Vector3 - Vector3. Each element subtracts with the other vector's related element.
-        FORCEINLINE Vector3 operator-(Vector3& Other) const;
+        FORCEINLINE constexpr Vector3 operator-(const Vector3& Other) const;
 
         //	Vector3 - TValue. Subtract the TValue parameter from each element.
-        FORCEINLINE Vector3 operator-(TValue& Other) const;
+        FORCEINLINE constexpr Vector3 operator-(TValue Other) const;
 
         //	Vector3 * TValue. Multiplies each element with the TValue parameter.
-        FORCEINLINE Vector3 operator*(TValue& Other) const;
+        FORCEINLINE constexpr Vector3 operator*(TValue Other) const;
 
         //	Vector3 * TValue. Divides each element with the TValue parameter.
-        FORCEINLINE Vector3 operator/(TValue& Other) const;
+        FORCEINLINE constexpr Vector3 operator/(TValue Other) const;
 
         //	Vector3 + Vector3. Each element sums with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator+=(Vector3 Other);
+        FORCEINLINE constexpr Vector3& operator+=(Vector3 Other);
 
         //	Vector3 + TValue. Each element sums with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator+=(TValue Other);
+        FORCEINLINE constexpr Vector3& operator+=(TValue Other);
 
         //	Vector3 - Vector3. Each element sums with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator-=(Vector3 Other);
+        FORCEINLINE constexpr Vector3& operator-=(Vector3 Other);
 
         //	Vector3 - TValue. Each element subtract with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator-=(TValue Other);
+        FORCEINLINE constexpr Vector3& operator-=(TValue Other);
 
         //	Vector3 * TValue. Each element multiplies with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator*=(TValue Other);
+        FORCEINLINE constexpr Vector3& operator*=(TValue Other);
 
         //	Vector3 / TValue. Each element multiplies with the other vector's related element and overwrites on related Vector3.
-        FORCEINLINE Vector3 operator/=(TValue Other);
+        FORCEINLINE constexpr Vector3& operator/=(TValue Other);
 
         //	Boolean that checks if both 3 dimensional Vectors are equal.
-        FORCEINLINE bool operator==(Vector3 Other);
+        FORCEINLINE constexpr bool operator==(const Vector3& Other) const;
     };
 
     template <typename TValue>
@@ -96,143 +110,167 @@ namespace Engine
     }
 
     template <typename TValue>
-    Vector3<TValue>::Vector3()
+    constexpr Vector3<TValue>::Vector3() : X(0), Y(0), Z(0)
+    {
+    }
+
+    template <typename TValue>
+    constexpr Vector3<TValue>::Vector3(TValue XValue, TValue YValue, TValue ZValue) : X(XValue), Y(YValue), Z(ZValue)
+    {
+    }
+
+    template <typename TValue>
+    template <Precision TPrecision>
+    TValue Vector3<TValue>::Length() const
     {
-        X = Y = Z = 0;
+        return Math::Sqrt<TPrecision>(LengthSquared());
     }
 
     template <typename TValue>
-    Vector3<TValue>::Vector3(TValue XValue, TValue YValue, TValue ZValue)
+    constexpr TValue Vector3<TValue>::LengthSquared() const
     {
-        X = XValue;
-        Y = YValue;
-        Z = ZValue;
+        return X * X + Y * Y + Z * Z;
     }
 
+    //	One square root for the whole vector instead of one per element.
     template <typename TValue>
-    TValue Vector3<TValue>::Length()
+    template <Precision TPrecision>
+    Vector3<TValue> Vector3<TValue>::Normalize() const
     {
-        return sqrt(pow(X, 2) + pow(Y, 2) + pow(Z, 2));
+        if constexpr (TPrecision == Precision::Fast && std::is_floating_point_v<TValue>)
+        {
+            const TValue inverseLength = Math::InverseSqrt<TPrecision>(LengthSquared());
+            return *this * inverseLength;
+        }
+        else
+        {
+            const TValue length = Length();
+            return Vector3(X / length, Y / length, Z / length);
+        }
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::Normalize()
+    template <Precision TPrecision>
+    TValue Vector3<TValue>::Distance(const Vector3& Vec1, const Vector3& Vec2)
     {
-        return Vector3(X / Length(), Y / Length(), Z / Length());
+        return Math::Sqrt<TPrecision>(DistanceSquared(Vec1, Vec2));
     }
 
     template <typename TValue>
-    TValue Vector3<TValue>::Distance(Vector3& Vec1, Vector3& Vec2)
+    constexpr TValue Vector3<TValue>::DistanceSquared(const Vector3& Vec1, const Vector3& Vec2)
     {
-        return sqrt(pow((Vec2.X - Vec1.X), 2) + pow((Vec2.Y - Vec1.Y), 2) + pow((Vec2.Z - Vec1.Z), 2));
+        const TValue xDifference = Vec2.X - Vec1.X;
+        const TValue yDifference = Vec2.Y - Vec1.Y;
+        const TValue zDifference = Vec2.Z - Vec1.Z;
+        return xDifference * xDifference + yDifference * yDifference + zDifference * zDifference;
     }
 
     template <typename TValue>
-    TValue Vector3<TValue>::DotProduct(Vector3& Vec1, Vector3& Vec2)
+    constexpr TValue Vector3<TValue>::DotProduct(const Vector3& Vec1, const Vector3& Vec2)
     {
         return Vec1.X * Vec2.X + Vec1.Y * Vec2.Y + Vec1.Z * Vec2.Z;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::CrossProduct(Vector3& Vec1, Vector3& Vec2)
+    constexpr Vector3<TValue> Vector3<TValue>::CrossProduct(const Vector3& Vec1, const Vector3& Vec2)
     {
-        return Vector3((Vec1.Y * Vec2.Z - Vec1.Z * Vec2.Y), (Vec1.X * Vec2.Z - Vec1.Z * Vec2.X),
+        return Vector3((Vec1.Y * Vec2.Z - Vec1.Z * Vec2.Y), (Vec1.Z * Vec2.X - Vec1.X * Vec2.Z),
                        (Vec1.X * Vec2.Y - Vec1.Y * Vec2.X));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator+(Vector3& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator+(const Vector3& Other) const
     {
         return Vector3((X + Other.X), (Y + Other.Y), (Z + Other.Z));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator+(TValue& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator+(TValue Other) const
     {
         return Vector3((X + Other), (Y + Other), (Z + Other));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator-(Vector3& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator-(const Vector3& Other) const
     {
         return Vector3((X - Other.X), (Y - Other.Y), (Z - Other.Z));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator-(TValue& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator-(TValue Other) const
     {
         return Vector3((X - Other), (Y - Other), (Z - Other));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator*(TValue& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator*(TValue Other) const
     {
         return Vector3((X * Other), (Y * Other), (Z * Other));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator/(TValue& Other) const
+    constexpr Vector3<TValue> Vector3<TValue>::operator/(TValue Other) const
     {
         return Vector3((X / Other), (Y / Other), (Z / Other));
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator+=(Vector3 Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator+=(Vector3 Other)
     {
         X += Other.X;
         Y += Other.Y;
         Z += Other.Z;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator+=(TValue Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator+=(TValue Other)
     {
         X += Other;
         Y += Other;
         Z += Other;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator-=(Vector3 Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator-=(Vector3 Other)
     {
         X -= Other.X;
         Y -= Other.Y;
         Z -= Other.Z;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator-=(TValue Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator-=(TValue Other)
     {
         X -= Other;
         Y -= Other;
         Z -= Other;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator*=(TValue Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator*=(TValue Other)
     {
         X *= Other;
         Y *= Other;
         Z *= Other;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    Vector3<TValue> Vector3<TValue>::operator/=(TValue Other)
+    constexpr Vector3<TValue>& Vector3<TValue>::operator/=(TValue Other)
     {
         X /= Other;
         Y /= Other;
         Z /= Other;
-        return Vector3(X, Y, Z);
+        return *this;
     }
 
     template <typename TValue>
-    bool Vector3<TValue>::operator==(Vector3 Other)
+    constexpr bool Vector3<TValue>::operator==(const Vector3& Other) const
     {
-        return Other.X == X && Other.Y == Y && Other.Z ? true : false;
+        return Other.X == X && Other.Y == Y && Other.Z == Z ? true : false;
     }
 }
@@ -8,7 +8,10 @@
  *  -   All the operator functions including bool check which is defined as ==.
  *  -   Initialization without defining the elements. (Returns Zero Vector)
  *  -   Length, Normalize, Distance, DotProduct, CrossProduct.
+ *  -   LengthSquared, DistanceSquared and a Precision policy for Length, Normalize, Distance. (Exact or Fast)
  *  -   Num. (Returns the count of element which is 4 for Vector4)
+ *  -   constexpr constructors, operators, LengthSquared, DistanceSquared, DotProduct. (Compile time tables)
+ *  -   SSE path for Vector4<float> when Math/SIMD.h detects it, scalar fallback otherwise.
  *  
  *****************************************************************************************************/
 
@@ -16,6 +19,9 @@
 
 #include "Core/CoreAPI.h"
 #include "Core/Types.h"
+#include "Math/Math.h"
+
+#include <type_traits>
 
 namespace Engine
 {
@@ -24,211 +30,479 @@ namespace Engine
     {
     public:
         //	If it is not initialized, it is zero vector.
-        Vector4();
+        constexpr Vector4();
 
         //	Initialization constructor.
-        Vector4(TValue XValue, TValue YValue, TValue ZValue, TValue WValue);
+        constexpr Vector4(TValue XValue, TValue YValue, TValue ZValue, TValue WValue);
 
         TValue X, Y, Z, W;
-        //	Gives the distance from origin.
-        FORCEINLINE TValue Length();
+        //	Gives the distance from origin. Precision::Fast trades a few ULPs for speed on float.
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE TValue Length() const;
+
+        //	Gives the squared distance from origin. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE constexpr TValue LengthSquared() const;
 
         //	Rates the current vector's each element in between 0 and 1.
-        FORCEINLINE Vector4 Normalize();
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE Vector4 Normalize() const;
 
         //	Gives the distance of 2 vector points.
-        FORCEINLINE static TValue Distance(Vector4& Vec1, Vector4& Vec2);
+        template <Precision TPrecision = Precision::Exact>
+        FORCEINLINE static TValue Distance(const Vector4& Vec1, const Vector4& Vec2);
+
+        //	Gives the squared distance of 2 vector points. It needs no square root, so prefer it for comparisons.
+        FORCEINLINE static constexpr TValue DistanceSquared(const Vector4& Vec1, const Vector4& Vec2);
 
         //	Scalar multiplication method called Dot Product. Returns TValue.
-        FORCEINLINE static TValue DotProduct(Vector4& Vec1, Vector4& Vec2);
+        FORCEINLINE static constexpr TValue DotProduct(const Vector4& Vec1, const Vector4& Vec2);
 
         //	Gives the size of the Vector4 which is always equals 4.
         FORCEINLINE static constexpr byte Num();
 
         //	Vector4 + Vector4. Each element sums with the other vector's related element.
-        FORCEINLINE Vector4 operator+(Vector4& Other) const;
+        FORCEINLINE constexpr Vector4 operator+(const Vector4& Other) const;
 
         //	Vector4 + TValue. Add each element the TValue parameter.
-        FORCEINLINE Vector4 operator+(TValue& Other) const;
+        FORCEINLINE constexpr Vector4 operator+(TValue Other) const;
 
         //	Vector4 - Vector4. Each element subtracts with the other vector's related element.
-        FORCEINLINE Vector4 operator-(Vector4& Other) const;
+        FORCEINLINE constexpr Vector4 operator-(const Vector4& Other) const;
 
         //	Vector4 - TValue. Subtract the TValue parameter from each element.
-        FORCEINLINE Vector4 operator-(TValue& Other) const;
+        FORCEINLINE constexpr Vector4 operator-(TValue Other) const;
 
         //	Vector4 * TValue. Multiplies each element with the TValue parameter.
-        FORCEINLINE Vector4 operator*(TValue& Other) const;
+        FORCEINLINE constexpr Vector4 operator*(TValue Other) const;
 
         //	Vector4 * TValue. Divides each element with the TValue parameter.
-        FORCEINLINE Vector4 operator/(TValue& Other) const;
+        FORCEINLINE constexpr Vector4 operator/(TValue Other) const;
 
         //	Vector4 + Vector4. Each element sums with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator+=(Vector4 Other);
+        FORCEINLINE constexpr Vector4& operator+=(Vector4 Other);
 
         //	Vector4 + TValue. Each element sums with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator+=(TValue Other);
+        FORCEINLINE constexpr Vector4& operator+=(TValue Other);
 
         //	Vector4 - Vector4. Each element sums with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator-=(Vector4 Other);
+        FORCEINLINE constexpr Vector4& operator-=(Vector4 Other);
 
         //	Vector4 - TValue. Each element subtract with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator-=(TValue Other);
+        FORCEINLINE constexpr Vector4& operator-=(TValue Other);
 
         //	Vector4 * TValue. Each element multiplies with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator*=(TValue Other);
+        FORCEINLINE constexpr Vector4& operator*=(TValue Other);
 
         //	Vector4 / TValue. Each element multiplies with the other vector's related element and overwrites on related Vector4.
-        FORCEINLINE Vector4 operator/=(TValue Other);
+        FORCEINLINE constexpr Vector4& operator/=(TValue Other);
 
         //	Boolean that checks if both 4 dimensional Vectors are equal.
-        FORCEINLINE bool operator==(Vector4 Other);
+        FORCEINLINE constexpr bool operator==(const Vector4& Other) const;
     };
 
     template <typename TValue>
     constexpr byte Vector4<TValue>::Num()
     {
-        return 3;
+        return 4;
     }
 
     template <typename TValue>
-    Vector4<TValue>::Vector4()
+    constexpr Vector4<TValue>::Vector4() : X(0), Y(0), Z(0), W(0)
     {
-        X = Y = Z = 0;
     }
 
     template <typename TValue>
-    Vector4<TValue>::Vector4(TValue XValue, TValue YValue, TValue ZValue, TValue WValue)
+    constexpr Vector4<TValue>::Vector4(TValue XValue, TValue YValue, TValue ZValue, TValue WValue) : X(XValue), Y(YValue), Z(ZValue), W(WValue)
     {
-        X = XValue;
-        Y = YValue;
-        Z = ZValue;
-        W = WValue;
     }
 
     template <typename TValue>
-    TValue Vector4<TValue>::Length()
+    template <Precision TPrecision>
+    TValue Vector4<TValue>::Length() const
     {
-        return sqrt(pow(X, 2) + pow(Y, 2) + pow(Z, 2) + pow(W, 2));
+        return Math::Sqrt<TPrecision>(LengthSquared());
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::Normalize()
+    constexpr TValue Vector4<TValue>::LengthSquared() const
     {
-        return Vector4(X / Length(), Y / Length(), Z / Length(), W / Length());
+        return X * X + Y * Y + Z * Z + W * W;
     }
 
+    //	One square root for the whole vector instead of one per element.
     template <typename TValue>
-    TValue Vector4<TValue>::Distance(Vector4& Vec1, Vector4& Vec2)
+    template <Precision TPrecision>
+    Vector4<TValue> Vector4<TValue>::Normalize() const
     {
-        return sqrt(pow((Vec2.X - Vec1.X), 2) + pow((Vec2.Y - Vec1.Y), 2) + pow((Vec2.Z - Vec1.Z), 2) + pow((Vec2.W - Vec1.W), 2));
+        if constexpr (TPrecision == Precision::Fast && std::is_floating_point_v<TValue>)
+        {
+            const TValue inverseLength = Math::InverseSqrt<TPrecision>(LengthSquared());
+            return *this * inverseLength;
+        }
+        else
+        {
+            const TValue length = Length();
+            return Vector4(X / length, Y / length, Z / length, W / length);
+        }
     }
 
     template <typename TValue>
-    TValue Vector4<TValue>::DotProduct(Vector4& Vec1, Vector4& Vec2)
+    template <Precision TPrecision>
+    TValue Vector4<TValue>::Distance(const Vector4& Vec1, const Vector4& Vec2)
     {
-        return Vec1.X * Vec2.X + Vec1.Y * Vec2.Y + Vec1.Z * Vec2.Z;
+        return Math::Sqrt<TPrecision>(DistanceSquared(Vec1, Vec2));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator+(Vector4& Other) const
+    constexpr TValue Vector4<TValue>::DistanceSquared(const Vector4& Vec1, const Vector4& Vec2)
+    {
+        const TValue xDifference = Vec2.X - Vec1.X;
+        const TValue yDifference = Vec2.Y - Vec1.Y;
+        const TValue zDifference = Vec2.Z - Vec1.Z;
+        const TValue wDifference = Vec2.W - Vec1.W;
+        return xDifference * xDifference + yDifference * yDifference + zDifference * zDifference + wDifference * wDifference;
+    }
+
+    template <typename TValue>
+    constexpr TValue Vector4<TValue>::DotProduct(const Vector4& Vec1, const Vector4& Vec2)
+    {
+        return Vec1.X * Vec2.X + Vec1.Y * Vec2.Y + Vec1.Z * Vec2.Z + Vec1.W * Vec2.W;
+    }
+
+    template <typename TValue>
+    constexpr Vector4<TValue> Vector4<TValue>::operator+(const Vector4& Other) const
     {
         return Vector4((X + Other.X), (Y + Other.Y), (Z + Other.Z), (W + Other.W));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator+(TValue& Other) const
+    constexpr Vector4<TValue> Vector4<TValue>::operator+(TValue Other) const
     {
         return Vector4((X + Other), (Y + Other), (Z + Other), (W + Other));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator-(Vector4& Other) const
+    constexpr Vector4<TValue> Vector4<TValue>::operator-(const Vector4& Other) const
     {
         return Vector4((X - Other.X), (Y - Other.Y), (Z - Other.Z), (W - Other.W));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator-(TValue& Other) const
+    constexpr Vector4<TValue> Vector4<TValue>::operator-(TValue Other) const
     {
         return Vector4((X - Other), (Y - Other), (Z - Other), (W - Other));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator*(TValue& Other) const
+    constexpr Vector4<TValue> Vector4<TValue>::operator*(TValue Other) const
     {
         return Vector4((X * Other), (Y * Other), (Z * Other), (W * Other));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator/(TValue& Other) const
+    constexpr Vector4<TValue> Vector4<TValue>::operator/(TValue Other) const
     {
         return Vector4((X / Other), (Y / Other), (Z / Other), (W / Other));
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator+=(Vector4 Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator+=(Vector4 Other)
     {
         X += Other.X;
         Y += Other.Y;
         Z += Other.Z;
         W += Other.W;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator+=(TValue Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator+=(TValue Other)
     {
         X += Other;
         Y += Other;
         Z += Other;
         W += Other;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator-=(Vector4 Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator-=(Vector4 Other)
     {
         X -= Other.X;
         Y -= Other.Y;
         Z -= Other.Z;
         W -= Other.W;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator-=(TValue Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator-=(TValue Other)
     {
         X -= Other;
         Y -= Other;
         Z -= Other;
         W -= Other;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator*=(TValue Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator*=(TValue Other)
     {
         X *= Other;
         Y *= Other;
         Z *= Other;
         W *= Other;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    Vector4<TValue> Vector4<TValue>::operator/=(TValue Other)
+    constexpr Vector4<TValue>& Vector4<TValue>::operator/=(TValue Other)
     {
         X /= Other;
         Y /= Other;
         Z /= Other;
         W /= Other;
-        return Vector4(X, Y, Z, W);
+        return *this;
     }
 
     template <typename TValue>
-    bool Vector4<TValue>::operator==(Vector4 Other)
+    constexpr bool Vector4<TValue>::operator==(const Vector4& Other) const
     {
         return Other.X == X && Other.Y == Y && Other.Z == Z && Other.W == W ? true : false;
     }
+
+#if ENGINE_SIMD_SSE
+    //	Vector4<float> specializations. The four elements are contiguous, so each operation is one SSE register.
+
+    template <>
+    FORCEINLINE constexpr float Vector4<float>::LengthSquared() const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return X * X + Y * Y + Z * Z + W * W;
+        }
+
+        const __m128 vector = SIMD::Load4(&X);
+        return SIMD::Dot4Scalar(vector, vector);
+    }
+
+    template <>
+    template <>
+    FORCEINLINE Vector4<float> Vector4<float>::Normalize<Precision::Exact>() const
+    {
+        Vector4<float> result;
+        SIMD::Store4(&result.X, SIMD::Normalize4(SIMD::Load4(&X)));
+        return result;
+    }
+
+    template <>
+    template <>
+    FORCEINLINE Vector4<float> Vector4<float>::Normalize<Precision::Fast>() const
+    {
+        Vector4<float> result;
+        SIMD::Store4(&result.X, SIMD::NormalizeFast4(SIMD::Load4(&X)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr float Vector4<float>::DistanceSquared(const Vector4& Vec1, const Vector4& Vec2)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            const float xDifference = Vec2.X - Vec1.X;
+            const float yDifference = Vec2.Y - Vec1.Y;
+            const float zDifference = Vec2.Z - Vec1.Z;
+            const float wDifference = Vec2.W - Vec1.W;
+            return xDifference * xDifference + yDifference * yDifference + zDifference * zDifference + wDifference * wDifference;
+        }
+
+        const __m128 difference = _mm_sub_ps(SIMD::Load4(&Vec2.X), SIMD::Load4(&Vec1.X));
+        return SIMD::Dot4Scalar(difference, difference);
+    }
+
+    template <>
+    FORCEINLINE constexpr float Vector4<float>::DotProduct(const Vector4& Vec1, const Vector4& Vec2)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vec1.X * Vec2.X + Vec1.Y * Vec2.Y + Vec1.Z * Vec2.Z + Vec1.W * Vec2.W;
+        }
+
+        return SIMD::Dot4Scalar(SIMD::Load4(&Vec1.X), SIMD::Load4(&Vec2.X));
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator+(const Vector4& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X + Other.X, Y + Other.Y, Z + Other.Z, W + Other.W);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_add_ps(SIMD::Load4(&X), SIMD::Load4(&Other.X)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator+(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X + Other, Y + Other, Z + Other, W + Other);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_add_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator-(const Vector4& Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X - Other.X, Y - Other.Y, Z - Other.Z, W - Other.W);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_sub_ps(SIMD::Load4(&X), SIMD::Load4(&Other.X)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator-(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X - Other, Y - Other, Z - Other, W - Other);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_sub_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator*(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X * Other, Y * Other, Z * Other, W * Other);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_mul_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float> Vector4<float>::operator/(float Other) const
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            return Vector4(X / Other, Y / Other, Z / Other, W / Other);
+        }
+
+        Vector4<float> result;
+        SIMD::Store4(&result.X, _mm_div_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return result;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator+=(Vector4 Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X += Other.X;
+            Y += Other.Y;
+            Z += Other.Z;
+            W += Other.W;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_add_ps(SIMD::Load4(&X), SIMD::Load4(&Other.X)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator+=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X += Other;
+            Y += Other;
+            Z += Other;
+            W += Other;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_add_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator-=(Vector4 Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X -= Other.X;
+            Y -= Other.Y;
+            Z -= Other.Z;
+            W -= Other.W;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_sub_ps(SIMD::Load4(&X), SIMD::Load4(&Other.X)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator-=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X -= Other;
+            Y -= Other;
+            Z -= Other;
+            W -= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_sub_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator*=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X *= Other;
+            Y *= Other;
+            Z *= Other;
+            W *= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_mul_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return *this;
+    }
+
+    template <>
+    FORCEINLINE constexpr Vector4<float>& Vector4<float>::operator/=(float Other)
+    {
+        if (ENGINE_CONSTANT_EVALUATED())
+        {
+            X /= Other;
+            Y /= Other;
+            Z /= Other;
+            W /= Other;
+            return *this;
+        }
+
+        SIMD::Store4(&X, _mm_div_ps(SIMD::Load4(&X), _mm_set1_ps(Other)));
+        return *this;
+    }
+#endif
 }
@@ -0,0 +1,368 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is a batch Vector library which runs one operation over whole arrays of Vector2, Vector3 or Vector4.
+ *
+ *  Current capabilities:
+ *  -   Normalize, DotProduct, CrossProduct, Distance, Lerp over pointer + count or over Engine::Array.
+ *  -   Float vectors are processed 4, 8 or 16 at a time with SSE, AVX2 or AVX-512. The instruction set is
+ *      picked at run time (SIMD::ActiveInstructionSet), so one build runs the widest path every CPU has.
+ *  -   Other element types and the leftover vectors of a batch run the scalar loop with the same results.
+ *  -   Optional multithreaded split through Parallel::For for very large inputs.
+ *
+ *  Results can be written over one of the inputs, other overlaps of inputs and results are not supported.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Parallel.h"
+#include "Math/Math.h"
+#include "Math/SIMD.h"
+#include "Vectors/Vector3.h"
+
+#include <type_traits>
+
+#if ENGINE_SIMD_SSE
+#define ENGINE_BATCH_KERNELS VectorBatchKernelsSSE
+#define ENGINE_BATCH_LANES SIMD::Float4Lanes
+#define ENGINE_BATCH_TARGET
+#include "Vectors/VectorBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+
+#define ENGINE_BATCH_KERNELS VectorBatchKernelsAVX2
+#define ENGINE_BATCH_LANES SIMD::Float8Lanes
+#define ENGINE_BATCH_TARGET ENGINE_TARGET_AVX2
+#include "Vectors/VectorBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+
+#define ENGINE_BATCH_KERNELS VectorBatchKernelsAVX512
+#define ENGINE_BATCH_LANES SIMD::Float16Lanes
+#define ENGINE_BATCH_TARGET ENGINE_TARGET_AVX512
+#include "Vectors/VectorBatchKernels.h"
+#undef ENGINE_BATCH_KERNELS
+#undef ENGINE_BATCH_LANES
+#undef ENGINE_BATCH_TARGET
+#else
+namespace Engine
+{
+    //	Only named by SIMD::Kernels, which SIMD::Dispatch never instantiates without SIMD.
+    struct VectorBatchKernelsSSE;
+    struct VectorBatchKernelsAVX2;
+    struct VectorBatchKernelsAVX512;
+}
+#endif
+
+namespace Engine
+{
+    class VectorBatch
+    {
+    public:
+        VectorBatch() = delete;
+        ~VectorBatch() = delete;
+
+        //	Each thread gets at least this many vectors, so smaller inputs stay on the calling thread.
+        static constexpr unsigned int MultithreadedChunkLength = 16384;
+
+        //	Element type of Vector2, Vector3 and Vector4.
+        template <typename TVector>
+        using ValueType = decltype(TVector::X);
+
+        //	destination[i] = source[i].Normalize<TPrecision>().
+        template <Precision TPrecision = Precision::Exact, typename TVector>
+        static void Normalize(const TVector* source, TVector* destination, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = TVector::DotProduct(left[i], right[i]).
+        template <typename TVector>
+        static void DotProduct(const TVector* left, const TVector* right, ValueType<TVector>* results, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = Vector3::CrossProduct(left[i], right[i]).
+        template <typename TValue>
+        static void CrossProduct(const Vector3<TValue>* left, const Vector3<TValue>* right, Vector3<TValue>* results, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = TVector::Distance<TPrecision>(left[i], right[i]).
+        template <Precision TPrecision = Precision::Exact, typename TVector>
+        static void Distance(const TVector* left, const TVector* right, ValueType<TVector>* results, unsigned int count, bool multithreaded = false);
+
+        //	results[i] = from[i] + (to[i] - from[i]) * alpha.
+        template <typename TVector>
+        static void Lerp(const TVector* from, const TVector* to, ValueType<TVector> alpha, TVector* results, unsigned int count, bool multithreaded = false);
+
+        //	Normalizes every vector of the Array in place.
+        template <Precision TPrecision = Precision::Exact, typename TVector, typename TAllocator, unsigned int TAlignment>
+        static void Normalize(Array<TVector, TAllocator, TAlignment>& vectors, bool multithreaded = false);
+
+        //	Array versions resize results to the length of the inputs. Inputs of different length throw "Out of Range".
+        template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void DotProduct(const Array<TVector, TAllocator, TAlignment>& left, const Array<TVector, TAllocator, TAlignment>& right,
+                               Array<ValueType<TVector>, TResultAllocator, TResultAlignment>& results, bool multithreaded = false);
+
+        template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void CrossProduct(const Array<Vector3<TValue>, TAllocator, TAlignment>& left, const Array<Vector3<TValue>, TAllocator, TAlignment>& right,
+                                 Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& results, bool multithreaded = false);
+
+        template <Precision TPrecision = Precision::Exact, typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Distance(const Array<TVector, TAllocator, TAlignment>& left, const Array<TVector, TAllocator, TAlignment>& right,
+                             Array<ValueType<TVector>, TResultAllocator, TResultAlignment>& results, bool multithreaded = false);
+
+        template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+        static void Lerp(const Array<TVector, TAllocator, TAlignment>& from, const Array<TVector, TAllocator, TAlignment>& to, ValueType<TVector> alpha,
+                         Array<TVector, TResultAllocator, TResultAlignment>& results, bool multithreaded = false);
+
+    private:
+        //	Kernels write whole batches of the widest width, so chunk borders never split a batch.
+        static constexpr unsigned int ChunkGranularity = 16;
+
+        template <typename TVector>
+        static const ValueType<TVector>* Values(const TVector* vectors);
+
+        template <typename TVector>
+        static ValueType<TVector>* Values(TVector* vectors);
+
+        //	Kernel structs SIMD::Dispatch picks from.
+        using Kernels = SIMD::Kernels<VectorBatchKernelsSSE, VectorBatchKernelsAVX2, VectorBatchKernelsAVX512>;
+
+        static void CheckLengths(unsigned int leftLength, unsigned int rightLength);
+    };
+
+    template <Precision TPrecision, typename TVector>
+    void VectorBatch::Normalize(const TVector* source, TVector* destination, unsigned int count, bool multithreaded)
+    {
+        using TValue = ValueType<TVector>;
+        constexpr unsigned int Components = TVector::Num();
+
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const TValue* sourceValues = Values(source + chunkBegin);
+            TValue* destinationValues = Values(destination + chunkBegin);
+            const unsigned int chunkLength = chunkEnd - chunkBegin;
+
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::template Normalize<Components>(sourceValues, destinationValues, chunkLength, TPrecision == Precision::Fast);
+                });
+            }
+
+            for (unsigned int i = processed; i < chunkLength; i++)
+            {
+                const TValue* vector = sourceValues + i * Components;
+                TValue lengthSquared = 0;
+                for (unsigned int c = 0; c < Components; c++)
+                {
+                    lengthSquared += vector[c] * vector[c];
+                }
+
+                if constexpr (TPrecision == Precision::Fast && std::is_floating_point_v<TValue>)
+                {
+                    const TValue inverseLength = Math::InverseSqrt<TPrecision>(lengthSquared);
+                    for (unsigned int c = 0; c < Components; c++)
+                    {
+                        destinationValues[i * Components + c] = vector[c] * inverseLength;
+                    }
+                }
+                else
+                {
+                    const TValue length = Math::Sqrt(lengthSquared);
+                    for (unsigned int c = 0; c < Components; c++)
+                    {
+                        destinationValues[i * Components + c] = vector[c] / length;
+                    }
+                }
+            }
+        });
+    }
+
+    template <typename TVector>
+    void VectorBatch::DotProduct(const TVector* left, const TVector* right, ValueType<TVector>* results, unsigned int count, bool multithreaded)
+    {
+        using TValue = ValueType<TVector>;
+        constexpr unsigned int Components = TVector::Num();
+
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const TValue* leftValues = Values(left + chunkBegin);
+            const TValue* rightValues = Values(right + chunkBegin);
+            TValue* chunkResults = results + chunkBegin;
+            const unsigned int chunkLength = chunkEnd - chunkBegin;
+
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::template DotProduct<Components>(leftValues, rightValues, chunkResults, chunkLength);
+                });
+            }
+
+            for (unsigned int i = processed; i < chunkLength; i++)
+            {
+                TValue sum = 0;
+                for (unsigned int c = 0; c < Components; c++)
+                {
+                    sum += leftValues[i * Components + c] * rightValues[i * Components + c];
+                }
+                chunkResults[i] = sum;
+            }
+        });
+    }
+
+    template <typename TValue>
+    void VectorBatch::CrossProduct(const Vector3<TValue>* left, const Vector3<TValue>* right, Vector3<TValue>* results, unsigned int count, bool multithreaded)
+    {
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const unsigned int chunkLength = chunkEnd - chunkBegin;
+
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::CrossProduct(Values(left + chunkBegin), Values(right + chunkBegin), Values(results + chunkBegin), chunkLength);
+                });
+            }
+
+            for (unsigned int i = chunkBegin + processed; i < chunkEnd; i++)
+            {
+                results[i] = Vector3<TValue>::CrossProduct(left[i], right[i]);
+            }
+        });
+    }
+
+    template <Precision TPrecision, typename TVector>
+    void VectorBatch::Distance(const TVector* left, const TVector* right, ValueType<TVector>* results, unsigned int count, bool multithreaded)
+    {
+        using TValue = ValueType<TVector>;
+        constexpr unsigned int Components = TVector::Num();
+
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const TValue* leftValues = Values(left + chunkBegin);
+            const TValue* rightValues = Values(right + chunkBegin);
+            TValue* chunkResults = results + chunkBegin;
+            const unsigned int chunkLength = chunkEnd - chunkBegin;
+
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::template Distance<Components>(leftValues, rightValues, chunkResults, chunkLength, TPrecision == Precision::Fast);
+                });
+            }
+
+            for (unsigned int i = processed; i < chunkLength; i++)
+            {
+                TValue distanceSquared = 0;
+                for (unsigned int c = 0; c < Components; c++)
+                {
+                    const TValue difference = rightValues[i * Components + c] - leftValues[i * Components + c];
+                    distanceSquared += difference * difference;
+                }
+                chunkResults[i] = Math::Sqrt<TPrecision>(distanceSquared);
+            }
+        });
+    }
+
+    template <typename TVector>
+    void VectorBatch::Lerp(const TVector* from, const TVector* to, ValueType<TVector> alpha, TVector* results, unsigned int count, bool multithreaded)
+    {
+        using TValue = ValueType<TVector>;
+        constexpr unsigned int Components = TVector::Num();
+
+        Parallel::For(0, count, MultithreadedChunkLength, ChunkGranularity, multithreaded, [=](unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            const TValue* fromValues = Values(from + chunkBegin);
+            const TValue* toValues = Values(to + chunkBegin);
+            TValue* resultValues = Values(results + chunkBegin);
+            const unsigned int valueCount = (chunkEnd - chunkBegin) * Components;
+
+            unsigned int processed = 0;
+            if constexpr (std::is_same_v<TValue, float>)
+            {
+                processed = SIMD::Dispatch<Kernels>([&](auto kernels)
+                {
+                    return decltype(kernels)::Lerp(fromValues, toValues, alpha, resultValues, valueCount);
+                });
+            }
+
+            for (unsigned int i = processed; i < valueCount; i++)
+            {
+                resultValues[i] = fromValues[i] + (toValues[i] - fromValues[i]) * alpha;
+            }
+        });
+    }
+
+    template <Precision TPrecision, typename TVector, typename TAllocator, unsigned int TAlignment>
+    void VectorBatch::Normalize(Array<TVector, TAllocator, TAlignment>& vectors, bool multithreaded)
+    {
+        Normalize<TPrecision>(vectors.GetSource(), vectors.GetSource(), vectors.Length(), multithreaded);
+    }
+
+    template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void VectorBatch::DotProduct(const Array<TVector, TAllocator, TAlignment>& left, const Array<TVector, TAllocator, TAlignment>& right,
+                                 Array<ValueType<TVector>, TResultAllocator, TResultAlignment>& results, bool multithreaded)
+    {
+        CheckLengths(left.Length(), right.Length());
+        results.Resize(left.Length());
+        DotProduct(left.GetSource(), right.GetSource(), results.GetSource(), left.Length(), multithreaded);
+    }
+
+    template <typename TValue, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void VectorBatch::CrossProduct(const Array<Vector3<TValue>, TAllocator, TAlignment>& left, const Array<Vector3<TValue>, TAllocator, TAlignment>& right,
+                                   Array<Vector3<TValue>, TResultAllocator, TResultAlignment>& results, bool multithreaded)
+    {
+        CheckLengths(left.Length(), right.Length());
+        results.Resize(left.Length());
+        CrossProduct(left.GetSource(), right.GetSource(), results.GetSource(), left.Length(), multithreaded);
+    }
+
+    template <Precision TPrecision, typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void VectorBatch::Distance(const Array<TVector, TAllocator, TAlignment>& left, const Array<TVector, TAllocator, TAlignment>& right,
+                               Array<ValueType<TVector>, TResultAllocator, TResultAlignment>& results, bool multithreaded)
+    {
+        CheckLengths(left.Length(), right.Length());
+        results.Resize(left.Length());
+        Distance<TPrecision>(left.GetSource(), right.GetSource(), results.GetSource(), left.Length(), multithreaded);
+    }
+
+    template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TResultAllocator, unsigned int TResultAlignment>
+    void VectorBatch::Lerp(const Array<TVector, TAllocator, TAlignment>& from, const Array<TVector, TAllocator, TAlignment>& to, ValueType<TVector> alpha,
+                           Array<TVector, TResultAllocator, TResultAlignment>& results, bool multithreaded)
+    {
+        CheckLengths(from.Length(), to.Length());
+        results.Resize(from.Length());
+        Lerp(from.GetSource(), to.GetSource(), alpha, results.GetSource(), from.Length(), multithreaded);
+    }
+
+    template <typename TVector>
+    const VectorBatch::ValueType<TVector>* VectorBatch::Values(const TVector* vectors)
+    {
+        static_assert(sizeof(TVector) == TVector::Num() * sizeof(ValueType<TVector>), "Batch vectors must be tightly packed elements");
+        return reinterpret_cast<const ValueType<TVector>*>(vectors);
+    }
+
+    template <typename TVector>
+    VectorBatch::ValueType<TVector>* VectorBatch::Values(TVector* vectors)
+    {
+        static_assert(sizeof(TVector) == TVector::Num() * sizeof(ValueType<TVector>), "Batch vectors must be tightly packed elements");
+        return reinterpret_cast<ValueType<TVector>*>(vectors);
+    }
+
+    inline void VectorBatch::CheckLengths(unsigned int leftLength, unsigned int rightLength)
+    {
+        if (leftLength != rightLength)
+        {
+            throw "Out of Range";
+        }
+    }
+}
@@ -0,0 +1,186 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  These are the SIMD kernels behind VectorBatch. There is no #pragma once on purpose, VectorBatch.h includes
+ *  this file once per instruction set with these defined:
+ *  -   ENGINE_BATCH_KERNELS: Name of the kernel struct. (VectorBatchKernelsSSE, VectorBatchKernelsAVX2 ...)
+ *  -   ENGINE_BATCH_LANES: Lane type of the instruction set. (SIMD::Float4Lanes, Float8Lanes, Float16Lanes)
+ *  -   ENGINE_BATCH_TARGET: Target attribute of the instruction set. (ENGINE_TARGET_AVX2 ... or nothing for SSE)
+ *
+ *  Every kernel works on flat float arrays, one vector is TComponents consecutive floats. Vectors are loaded
+ *  and stored with the interleaved shuffles of the lanes, not with gathers. Kernels only process full batches
+ *  of Lanes::Width vectors and give how many they processed, VectorBatch finishes the rest.
+ *
+ *****************************************************************************************************/
+
+namespace Engine
+{
+    struct ENGINE_BATCH_KERNELS
+    {
+        using Lanes = ENGINE_BATCH_LANES;
+        using Register = Lanes::Register;
+
+        template <unsigned int TComponents>
+        ENGINE_BATCH_TARGET static unsigned int Normalize(const float* source, float* destination, unsigned int count, bool fast)
+        {
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const float* sourceBatch = source + i * TComponents;
+                float* destinationBatch = destination + i * TComponents;
+
+                //	Everything is loaded before the first store, so source and destination can be the same.
+                Register components[TComponents];
+                LoadVectors<TComponents>(sourceBatch, components);
+
+                Register lengthSquared = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < TComponents; c++)
+                {
+                    lengthSquared = Lanes::MultiplyAdd(components[c], components[c], lengthSquared);
+                }
+
+                if (fast)
+                {
+                    const Register inverseLength = Lanes::InverseSqrtFast(lengthSquared);
+                    for (unsigned int c = 0; c < TComponents; c++)
+                    {
+                        components[c] = Lanes::Multiply(components[c], inverseLength);
+                    }
+                }
+                else
+                {
+                    const Register length = Lanes::Sqrt(lengthSquared);
+                    for (unsigned int c = 0; c < TComponents; c++)
+                    {
+                        components[c] = Lanes::Divide(components[c], length);
+                    }
+                }
+                StoreVectors<TComponents>(destinationBatch, components);
+            }
+            return batchedCount;
+        }
+
+        template <unsigned int TComponents>
+        ENGINE_BATCH_TARGET static unsigned int DotProduct(const float* left, const float* right, float* results, unsigned int count)
+        {
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register leftComponents[TComponents];
+                Register rightComponents[TComponents];
+                LoadVectors<TComponents>(left + i * TComponents, leftComponents);
+                LoadVectors<TComponents>(right + i * TComponents, rightComponents);
+
+                Register sum = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < TComponents; c++)
+                {
+                    sum = Lanes::MultiplyAdd(leftComponents[c], rightComponents[c], sum);
+                }
+                Lanes::Store(results + i, sum);
+            }
+            return batchedCount;
+        }
+
+        template <unsigned int TComponents>
+        ENGINE_BATCH_TARGET static unsigned int Distance(const float* left, const float* right, float* results, unsigned int count, bool fast)
+        {
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                Register leftComponents[TComponents];
+                Register rightComponents[TComponents];
+                LoadVectors<TComponents>(left + i * TComponents, leftComponents);
+                LoadVectors<TComponents>(right + i * TComponents, rightComponents);
+
+                Register distanceSquared = Lanes::Set(0.0f);
+                for (unsigned int c = 0; c < TComponents; c++)
+                {
+                    const Register difference = Lanes::Subtract(rightComponents[c], leftComponents[c]);
+                    distanceSquared = Lanes::MultiplyAdd(difference, difference, distanceSquared);
+                }
+
+                //	Fast is distanceSquared * 1 / sqrt(distanceSquared), which is NaN for zero, so zero lanes are fixed with a max.
+                if (fast)
+                {
+                    const Register distance = Lanes::Multiply(distanceSquared, Lanes::InverseSqrtFast(distanceSquared));
+                    Lanes::Store(results + i, Lanes::Max(distance, Lanes::Set(0.0f)));
+                }
+                else
+                {
+                    Lanes::Store(results + i, Lanes::Sqrt(distanceSquared));
+                }
+            }
+            return batchedCount;
+        }
+
+        ENGINE_BATCH_TARGET static unsigned int CrossProduct(const float* left, const float* right, float* results, unsigned int count)
+        {
+            const unsigned int batchedCount = count / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const unsigned int offset = i * 3;
+                Register leftX, leftY, leftZ, rightX, rightY, rightZ;
+                Lanes::LoadInterleaved3(left + offset, leftX, leftY, leftZ);
+                Lanes::LoadInterleaved3(right + offset, rightX, rightY, rightZ);
+
+                Lanes::StoreInterleaved3(results + offset,
+                                         Lanes::Subtract(Lanes::Multiply(leftY, rightZ), Lanes::Multiply(leftZ, rightY)),
+                                         Lanes::Subtract(Lanes::Multiply(leftZ, rightX), Lanes::Multiply(leftX, rightZ)),
+                                         Lanes::Subtract(Lanes::Multiply(leftX, rightY), Lanes::Multiply(leftY, rightX)));
+            }
+            return batchedCount;
+        }
+
+        //	Lerp does the same thing to every float, so it runs over the flat array without any gather.
+        ENGINE_BATCH_TARGET static unsigned int Lerp(const float* from, const float* to, float alpha, float* results, unsigned int valueCount)
+        {
+            const Register alphas = Lanes::Set(alpha);
+            const unsigned int batchedCount = valueCount / Lanes::Width * Lanes::Width;
+            for (unsigned int i = 0; i < batchedCount; i += Lanes::Width)
+            {
+                const Register fromValues = Lanes::Load(from + i);
+                const Register difference = Lanes::Subtract(Lanes::Load(to + i), fromValues);
+                Lanes::Store(results + i, Lanes::MultiplyAdd(difference, alphas, fromValues));
+            }
+            return batchedCount;
+        }
+
+        //	Lanes::Width vectors of TComponents floats into one register per component.
+        template <unsigned int TComponents>
+        ENGINE_BATCH_TARGET static void LoadVectors(const float* values, Register* components)
+        {
+            static_assert(TComponents >= 2 && TComponents <= 4, "Batch vectors have 2, 3 or 4 components");
+            if constexpr (TComponents == 2)
+            {
+                Lanes::LoadInterleaved2(values, components[0], components[1]);
+            }
+            else if constexpr (TComponents == 3)
+            {
+                Lanes::LoadInterleaved3(values, components[0], components[1], components[2]);
+            }
+            else
+            {
+                Lanes::LoadInterleaved4(values, components[0], components[1], components[2], components[3]);
+            }
+        }
+
+        template <unsigned int TComponents>
+        ENGINE_BATCH_TARGET static void StoreVectors(float* values, const Register* components)
+        {
+            static_assert(TComponents >= 2 && TComponents <= 4, "Batch vectors have 2, 3 or 4 components");
+            if constexpr (TComponents == 2)
+            {
+                Lanes::StoreInterleaved2(values, components[0], components[1]);
+            }
+            else if constexpr (TComponents == 3)
+            {
+                Lanes::StoreInterleaved3(values, components[0], components[1], components[2]);
+            }
+            else
+            {
+                Lanes::StoreInterleaved4(values, components[0], components[1], components[2], components[3]);
+            }
+        }
+    };
+}
@@ -0,0 +1,340 @@
+﻿// Copyright Metehan Tuncbilek, All Rights Reserved.
+
+/*****************************************************************************************************
+ *
+ *  This is an opt-in expression template layer for Vector2, Vector3, Vector4 and ColorRGBA.
+ *
+ *  Current capabilities:
+ *  -   Lazy(vector) or Lazy(array) starts an expression. +, -, * and / between expressions and with scalars
+ *      only build a small tree, nothing is computed until the expression is assigned. Every vector or array
+ *      operand has to go through Lazy, plain Vector operators stay eager.
+ *  -   Assigning to a vector evaluates the whole expression in one pass without any temporary vector.
+ *      (Vector3<float> result = Lazy(a) + Lazy(b) * s - Lazy(c);)
+ *  -   Assign(array, expression) runs one fused loop over the arrays. Single vectors and scalars in an array
+ *      expression apply to every element. (Assign(positions, Lazy(positions) + Lazy(velocities) * deltaTime);)
+ *  -   Vector * Vector and Vector / Vector are per element, which is what color modulation needs.
+ *
+ *  Expressions keep references to their vectors and arrays, so evaluate them in the statement they are built.
+ *  The destination can be one of the operands, element i only ever reads element i.
+ *
+ *****************************************************************************************************/
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Vectors/Vector2.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+#include "Colors/ColorRGBA.h"
+
+#include <type_traits>
+
+namespace Engine
+{
+    //	Gives the expression layer access to every component of a vector by index.
+    template <typename TVector>
+    struct ExpressionComponents;
+
+    template <typename TValue>
+    struct ExpressionComponents<Vector2<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 2;
+        static constexpr TValue Vector2<TValue>::* Members[Count] = { &Vector2<TValue>::X, &Vector2<TValue>::Y };
+    };
+
+    template <typename TValue>
+    struct ExpressionComponents<Vector3<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 3;
+        static constexpr TValue Vector3<TValue>::* Members[Count] = { &Vector3<TValue>::X, &Vector3<TValue>::Y, &Vector3<TValue>::Z };
+    };
+
+    template <typename TValue>
+    struct ExpressionComponents<Vector4<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 4;
+        static constexpr TValue Vector4<TValue>::* Members[Count] = { &Vector4<TValue>::X, &Vector4<TValue>::Y, &Vector4<TValue>::Z, &Vector4<TValue>::W };
+    };
+
+    template <typename TValue>
+    struct ExpressionComponents<ColorRGBA<TValue>>
+    {
+        using ValueType = TValue;
+        static constexpr unsigned int Count = 4;
+        static constexpr TValue ColorRGBA<TValue>::* Members[Count] = { &ColorRGBA<TValue>::Red, &ColorRGBA<TValue>::Green, &ColorRGBA<TValue>::Blue, &ColorRGBA<TValue>::Alpha };
+    };
+
+    //	Base of every expression node. Length is the element count, or BroadcastLength when every element is the same.
+    template <typename TExpression>
+    struct VectorExpression
+    {
+        static constexpr unsigned int BroadcastLength = 0;
+
+        const TExpression& Self() const { return static_cast<const TExpression&>(*this); }
+    };
+
+    template <typename TVector>
+    class VectorTerminal : public VectorExpression<VectorTerminal<TVector>>
+    {
+    public:
+        using VectorType = TVector;
+        using ValueType = typename ExpressionComponents<TVector>::ValueType;
+
+        explicit VectorTerminal(const TVector& vector) : Vector(vector) {}
+
+        unsigned int Length() const { return this->BroadcastLength; }
+        ValueType Value(unsigned int, unsigned int component) const { return Vector.*ExpressionComponents<TVector>::Members[component]; }
+
+        operator TVector() const;
+
+    private:
+        const TVector& Vector;
+    };
+
+    template <typename TVector>
+    class ArrayTerminal : public VectorExpression<ArrayTerminal<TVector>>
+    {
+    public:
+        using VectorType = TVector;
+        using ValueType = typename ExpressionComponents<TVector>::ValueType;
+
+        ArrayTerminal(const TVector* elements, unsigned int length) : Elements(elements), ElementCount(length) {}
+
+        unsigned int Length() const { return ElementCount; }
+        ValueType Value(unsigned int index, unsigned int component) const { return Elements[index].*ExpressionComponents<TVector>::Members[component]; }
+
+    private:
+        const TVector* Elements;
+        unsigned int ElementCount;
+    };
+
+    template <typename TVector>
+    class ScalarTerminal : public VectorExpression<ScalarTerminal<TVector>>
+    {
+    public:
+        using VectorType = TVector;
+        using ValueType = typename ExpressionComponents<TVector>::ValueType;
+
+        explicit ScalarTerminal(ValueType value) : Scalar(value) {}
+
+        unsigned int Length() const { return this->BroadcastLength; }
+        ValueType Value(unsigned int, unsigned int) const { return Scalar; }
+
+    private:
+        ValueType Scalar;
+    };
+
+    struct ExpressionAdd
+    {
+        template <typename TValue>
+        static TValue Apply(TValue left, TValue right) { return left + right; }
+    };
+
+    struct ExpressionSubtract
+    {
+        template <typename TValue>
+        static TValue Apply(TValue left, TValue right) { return left - right; }
+    };
+
+    struct ExpressionMultiply
+    {
+        template <typename TValue>
+        static TValue Apply(TValue left, TValue right) { return left * right; }
+    };
+
+    struct ExpressionDivide
+    {
+        template <typename TValue>
+        static TValue Apply(TValue left, TValue right) { return left / right; }
+    };
+
+    template <typename TLeft, typename TRight, typename TOperation>
+    class BinaryExpression : public VectorExpression<BinaryExpression<TLeft, TRight, TOperation>>
+    {
+    public:
+        using VectorType = typename TLeft::VectorType;
+        using ValueType = typename TLeft::ValueType;
+
+        static_assert(std::is_same_v<VectorType, typename TRight::VectorType>, "Both sides of a vector expression must be the same vector type");
+
+        //	Array operands of different length throw "Out of Range".
+        BinaryExpression(const TLeft& left, const TRight& right);
+
+        unsigned int Length() const { return ElementCount; }
+        ValueType Value(unsigned int index, unsigned int component) const { return TOperation::Apply(Left.Value(index, component), Right.Value(index, component)); }
+
+        //	Evaluates the expression into a vector, every component once. Array expressions throw "Out of Range".
+        operator VectorType() const;
+
+    private:
+        TLeft Left;
+        TRight Right;
+        unsigned int ElementCount;
+    };
+
+    //	Starts an expression from a vector.
+    template <typename TVector, typename = typename ExpressionComponents<TVector>::ValueType>
+    VectorTerminal<TVector> Lazy(const TVector& vector);
+
+    //	Starts an expression from every element of an Array.
+    template <typename TVector, typename TAllocator, unsigned int TAlignment>
+    ArrayTerminal<TVector> Lazy(const Array<TVector, TAllocator, TAlignment>& array);
+
+    //	Writes expression[i] into destination[i] in one loop, destination is resized to the length of the expression.
+    //	Array operands of different length throw "Out of Range".
+    template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TExpression>
+    void Assign(Array<TVector, TAllocator, TAlignment>& destination, const VectorExpression<TExpression>& expression);
+
+    template <typename TExpression>
+    typename TExpression::VectorType EvaluateElement(const TExpression& expression, unsigned int index);
+
+    template <typename TVector>
+    VectorTerminal<TVector>::operator TVector() const
+    {
+        return Vector;
+    }
+
+    template <typename TLeft, typename TRight, typename TOperation>
+    BinaryExpression<TLeft, TRight, TOperation>::BinaryExpression(const TLeft& left, const TRight& right) : Left(left), Right(right)
+    {
+        const unsigned int leftLength = Left.Length();
+        const unsigned int rightLength = Right.Length();
+        if (leftLength != this->BroadcastLength && rightLength != this->BroadcastLength && leftLength != rightLength)
+        {
+            throw "Out of Range";
+        }
+        ElementCount = leftLength != this->BroadcastLength ? leftLength : rightLength;
+    }
+
+    template <typename TLeft, typename TRight, typename TOperation>
+    BinaryExpression<TLeft, TRight, TOperation>::operator VectorType() const
+    {
+        if (ElementCount != this->BroadcastLength)
+        {
+            throw "Out of Range";
+        }
+        return EvaluateElement(*this, 0);
+    }
+
+    template <typename TExpression>
+    typename TExpression::VectorType EvaluateElement(const TExpression& expression, unsigned int index)
+    {
+        using TVector = typename TExpression::VectorType;
+        using Components = ExpressionComponents<TVector>;
+
+        TVector result;
+        for (unsigned int c = 0; c < Components::Count; c++)
+        {
+            result.*Components::Members[c] = expression.Value(index, c);
+        }
+        return result;
+    }
+
+    template <typename TVector, typename>
+    VectorTerminal<TVector> Lazy(const TVector& vector)
+    {
+        return VectorTerminal<TVector>(vector);
+    }
+
+    template <typename TVector, typename TAllocator, unsigned int TAlignment>
+    ArrayTerminal<TVector> Lazy(const Array<TVector, TAllocator, TAlignment>& array)
+    {
+        return ArrayTerminal<TVector>(array.GetSource(), array.Length());
+    }
+
+    template <typename TVector, typename TAllocator, unsigned int TAlignment, typename TExpression>
+    void Assign(Array<TVector, TAllocator, TAlignment>& destination, const VectorExpression<TExpression>& expression)
+    {
+        static_assert(std::is_same_v<TVector, typename TExpression::VectorType>, "Destination must be the vector type of the expression");
+
+        const TExpression& source = expression.Self();
+        const unsigned int length = source.Length();
+        //	An expression without any array sets every element the destination already has.
+        if (length != VectorExpression<TExpression>::BroadcastLength)
+        {
+            destination.Resize(length);
+        }
+
+        TVector* elements = destination.GetSource();
+        const unsigned int destinationLength = destination.Length();
+        for (unsigned int i = 0; i < destinationLength; i++)
+        {
+            elements[i] = EvaluateElement(source, i);
+        }
+    }
+
+    template <typename TLeft, typename TRight>
+    BinaryExpression<TLeft, TRight, ExpressionAdd> operator+(const VectorExpression<TLeft>& left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<TLeft, TRight, ExpressionAdd>(left.Self(), right.Self());
+    }
+
+    template <typename TLeft>
+    BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionAdd> operator+(const VectorExpression<TLeft>& left, typename TLeft::ValueType right)
+    {
+        return BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionAdd>(left.Self(), ScalarTerminal<typename TLeft::VectorType>(right));
+    }
+
+    template <typename TRight>
+    BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionAdd> operator+(typename TRight::ValueType left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionAdd>(ScalarTerminal<typename TRight::VectorType>(left), right.Self());
+    }
+
+    template <typename TLeft, typename TRight>
+    BinaryExpression<TLeft, TRight, ExpressionSubtract> operator-(const VectorExpression<TLeft>& left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<TLeft, TRight, ExpressionSubtract>(left.Self(), right.Self());
+    }
+
+    template <typename TLeft>
+    BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionSubtract> operator-(const VectorExpression<TLeft>& left, typename TLeft::ValueType right)
+    {
+        return BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionSubtract>(left.Self(), ScalarTerminal<typename TLeft::VectorType>(right));
+    }
+
+    template <typename TRight>
+    BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionSubtract> operator-(typename TRight::ValueType left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionSubtract>(ScalarTerminal<typename TRight::VectorType>(left), right.Self());
+    }
+
+    template <typename TLeft, typename TRight>
+    BinaryExpression<TLeft, TRight, ExpressionMultiply> operator*(const VectorExpression<TLeft>& left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<TLeft, TRight, ExpressionMultiply>(left.Self(), right.Self());
+    }
+
+    template <typename TLeft>
+    BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionMultiply> operator*(const VectorExpression<TLeft>& left, typename TLeft::ValueType right)
+    {
+        return BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionMultiply>(left.Self(), ScalarTerminal<typename TLeft::VectorType>(right));
+    }
+
+    template <typename TRight>
+    BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionMultiply> operator*(typename TRight::ValueType left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionMultiply>(ScalarTerminal<typename TRight::VectorType>(left), right.Self());
+    }
+
+    template <typename TLeft, typename TRight>
+    BinaryExpression<TLeft, TRight, ExpressionDivide> operator/(const VectorExpression<TLeft>& left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<TLeft, TRight, ExpressionDivide>(left.Self(), right.Self());
+    }
+
+    template <typename TLeft>
+    BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionDivide> operator/(const VectorExpression<TLeft>& left, typename TLeft::ValueType right)
+    {
+        return BinaryExpression<TLeft, ScalarTerminal<typename TLeft::VectorType>, ExpressionDivide>(left.Self(), ScalarTerminal<typename TLeft::VectorType>(right));
+    }
+
+    template <typename TRight>
+    BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionDivide> operator/(typename TRight::ValueType left, const VectorExpression<TRight>& right)
+    {
+        return BinaryExpression<ScalarTerminal<typename TRight::VectorType>, TRight, ExpressionDivide>(ScalarTerminal<typename TRight::VectorType>(left), right.Self());
+    }
+}